@@ -64,6 +64,7 @@ int main(int argc, char* argv[])
     gepard::Gepard pngGepard(&pngSurface);
 
     pathShape(pngGepard);
+    pngGepard.finish();
 
     pngSurface.save(pngFile);
 
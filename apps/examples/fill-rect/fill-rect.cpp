@@ -63,6 +63,7 @@ int main()
         gepard::Gepard pngGepard(&pngSurface);
 
         pathShape(pngGepard);
+        pngGepard.finish();
 
         pngSurface.save("fill-rect.png");
     }
@@ -73,6 +74,7 @@ int main()
         gepard::Gepard gepard(&surface);
 
         pathShape(gepard);
+        gepard.flush();
 
         while (true) {
             std::this_thread::sleep_for(std::chrono::nanoseconds(1));   // Only for CPU sparing.
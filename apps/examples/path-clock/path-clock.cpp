@@ -62,6 +62,7 @@ public:
             std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
             struct std::tm* np = std::localtime(&now);
             showNow(np->tm_hour, np->tm_min, np->tm_sec);
+            _ctx->flush();
 
             std::this_thread::sleep_for(std::chrono::milliseconds(1000 / _frequency));
             if (_surface->hasToQuit()) {
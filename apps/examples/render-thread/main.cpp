@@ -105,7 +105,7 @@ int main()
         // Call drawing function.
         if (drawing) {
             // Call draw().
-            rectsFromDrawCall += gepard.draw() / 2;
+            rectsFromDrawCall += gepard.draw();
 
             { // lock
                 std::lock_guard<std::mutex> guard(g_mutex);
@@ -104,6 +104,7 @@ void MonkeyMark::drawRects()
 
         step();
      }
+    gepard->flush();
 }
 
 // SnakeMark
@@ -189,6 +190,7 @@ void SnakeMark::drawRects(int x, int y)
 
         step();
      }
+    gepard->flush();
 }
 
 int SnakeMark::newVelocity(const int x)
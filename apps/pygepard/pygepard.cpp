@@ -299,6 +299,12 @@ static PyObject* Gepard__setFillColor(PyObject *self, PyObject* args)
     Py_RETURN_NONE;
 }
 
+static PyObject* Gepard__flush(PyObject *self, PyObject* args)
+{
+    ((pygepard_GepardObject *)self)->gpd->flush();
+    Py_RETURN_NONE;
+}
+
 static PyMethodDef pClassMethods[] = {
     {"save", (PyCFunction) Gepard__save, METH_NOARGS, "save"},
     {"restore", (PyCFunction) Gepard__restore, METH_NOARGS, "restore"},
@@ -325,6 +331,7 @@ static PyMethodDef pClassMethods[] = {
     {"clip", (PyCFunction) Gepard__clip, METH_NOARGS, "clip"},
     {"isPointInPath", (PyCFunction) Gepard__isPointInPath, METH_VARARGS, "isPointInPath"},
     {"setFillColor", (PyCFunction) Gepard__setFillColor, METH_VARARGS, "setFillColor"},
+    {"flush", (PyCFunction) Gepard__flush, METH_NOARGS, "flush"},
     {NULL, NULL, 0, NULL}
 };
 
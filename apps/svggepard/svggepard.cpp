@@ -188,6 +188,7 @@ int main(int argc, char* argv[])
         std::cout << "  -h, --help      show this help." << std::endl;
         std::cout << "  -p, --png FILE  use png output and set file name." << std::endl;
         std::cout << "  -C, --no-clear  disable canvas clear." << std::endl;
+        std::cout << "  -t, --threads N number of rendering threads (0: one per core)." << std::endl;
         return 0;
     }
 
@@ -199,6 +200,7 @@ int main(int argc, char* argv[])
         GET_VALUE("-p, --png", "build/tiger.png")
     };
     const bool a_disableClear = CHECK_FLAG("-C, --no-clear");
+    const unsigned a_threads = std::stoi(GET_VALUE("-t, --threads", "1"));
     const std::string a_svgFile = GET_VALUE("", "./apps/svggepard/tiger.svg");
 
     // Open and parse SVG file.
@@ -213,7 +215,7 @@ int main(int argc, char* argv[])
     const uint height = pImage->height;
     gepard::Surface* surface = a_png.isOn ? (gepard::Surface*)new gepard::PNGSurface(width, height)
                                           : (gepard::Surface*)new gepard::XSurface(width, height);
-    gepard::Gepard gepard(surface);
+    gepard::Gepard gepard(surface, a_threads);
 
     // Clear the canvas.
     if (!a_disableClear) {
@@ -225,6 +227,7 @@ int main(int argc, char* argv[])
     parseNSVGimage(gepard, pImage);
 
     nsvgDelete(pImage);
+    gepard.finish();
 
     // Put the results.
     if (a_png.isOn) {
@@ -1,14 +1,34 @@
 SET(GEPARD_DEP_LIBS "")
 SET(GEPARD_DEP_INCLUDES "")
 
+# Every backend whose dependencies are found is built into the library, the
+# backend is chosen at runtime. The BACKEND option makes the dependencies of
+# the selected one required.
+SET(GEPARD_BACKENDS "")
+
 if (BACKEND STREQUAL "GLES2")
   find_package(GLESv2 REQUIRED)
   find_package(EGL REQUIRED)
+else ()
+  find_package(GLESv2)
+  find_package(EGL)
+endif ()
 
+if (GLESv2_LIBRARY AND GLESv2_INCLUDE_DIR AND EGL_LIBRARY AND EGL_INCLUDE_DIR)
+  list(APPEND GEPARD_BACKENDS GLES2)
   list(APPEND GEPARD_DEP_LIBS ${GLESv2_LIBRARY} ${EGL_LIBRARY})
   list(APPEND GEPARD_DEP_INCLUDES ${GLESv2_INCLUDE_DIR} ${EGL_INCLUDE_DIR})
-elseif (BACKEND STREQUAL "VULKAN")
-  find_package(Vulkan)
+endif ()
+
+# The shaders are compiled to SPIR-V and embedded into the library in a build step.
+find_program(GLSLANG_VALIDATOR glslangValidator)
+find_package(Vulkan)
+
+if (BACKEND STREQUAL "VULKAN")
+  if (NOT GLSLANG_VALIDATOR)
+    message(FATAL_ERROR "glslangValidator is required to compile the Vulkan shaders")
+  endif()
+
   if (NOT VULKAN_FOUND)
     message(STATUS "Vulkan headers will be downloaded in a build step")
     add_custom_command (OUTPUT ${PROJECT_BINARY_DIR}/thirdparty/include/vulkan/vulkan.h
@@ -28,6 +48,13 @@ elseif (BACKEND STREQUAL "VULKAN")
     set(VULKAN_INCLUDE_DIR ${PROJECT_BINARY_DIR}/thirdparty/include)
   endif()
 
+  list(APPEND GEPARD_BACKENDS VULKAN)
+elseif (VULKAN_FOUND AND GLSLANG_VALIDATOR)
+  list(APPEND GEPARD_BACKENDS VULKAN)
+endif ()
+
+list(FIND GEPARD_BACKENDS VULKAN _vulkan_index)
+if (_vulkan_index GREATER -1)
   # TODO(kkristof) remove this once XSync has been removed from GepardVulkan::createSwapChain
   find_package(X11)
   list(APPEND GEPARD_DEP_LIBS ${X11_LIBRARIES})
@@ -35,3 +62,13 @@ elseif (BACKEND STREQUAL "VULKAN")
   list(APPEND GEPARD_DEP_INCLUDES ${VULKAN_INCLUDE_DIR})
   list(APPEND GEPARD_DEP_LIBS ${CMAKE_DL_LIBS})
 endif ()
+
+# The software backend is always built as the last fallback. Its rasterizer
+# uses worker threads.
+set(THREADS_PREFER_PTHREAD_FLAG TRUE)
+find_package(Threads REQUIRED)
+
+list(APPEND GEPARD_BACKENDS SOFTWARE)
+list(APPEND GEPARD_DEP_LIBS ${CMAKE_THREAD_LIBS_INIT})
+
+message(STATUS "Backends: ${GEPARD_BACKENDS}")
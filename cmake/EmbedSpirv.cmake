@@ -0,0 +1,57 @@
+# Embeds a SPIR-V binary into a C++ header as a constexpr uint32_t array.
+#
+# Usage: cmake -DINPUT=<name.spv> -DOUTPUT=<name.h> -P EmbedSpirv.cmake
+#
+# The array is named after the camel cased file name without the .spv
+# extension, e.g. fill-rect.vert.spv becomes fillRectVert.
+
+get_filename_component(FILE_NAME ${INPUT} NAME)
+string(REGEX REPLACE "\\.spv$" "" FILE_NAME "${FILE_NAME}")
+string(REGEX MATCHALL "[A-Za-z0-9]+" NAME_PARTS "${FILE_NAME}")
+
+set(ARRAY_NAME "")
+foreach(PART ${NAME_PARTS})
+  if (ARRAY_NAME STREQUAL "")
+    set(ARRAY_NAME ${PART})
+  else()
+    string(LENGTH ${PART} PART_LENGTH)
+    math(EXPR REST_LENGTH "${PART_LENGTH} - 1")
+    string(SUBSTRING ${PART} 0 1 FIRST)
+    string(SUBSTRING ${PART} 1 ${REST_LENGTH} REST)
+    string(TOUPPER ${FIRST} FIRST)
+    set(ARRAY_NAME "${ARRAY_NAME}${FIRST}${REST}")
+  endif()
+endforeach()
+
+file(READ ${INPUT} CONTENT HEX)
+string(LENGTH "${CONTENT}" CONTENT_LENGTH)
+math(EXPR REMAINDER "${CONTENT_LENGTH} % 8")
+if (CONTENT_LENGTH EQUAL 0 OR NOT REMAINDER EQUAL 0)
+  message(FATAL_ERROR "${INPUT} is not a SPIR-V binary")
+endif()
+
+# SPIR-V is a stream of little endian 32 bit words.
+string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1, " WORDS "${CONTENT}")
+set(LINE_PATTERN "")
+foreach(INDEX RANGE 1 8)
+  set(LINE_PATTERN "${LINE_PATTERN}0x[0-9a-f]+, ")
+endforeach()
+string(REGEX REPLACE "(${LINE_PATTERN})" "\\1\n    " WORDS "${WORDS}")
+string(REPLACE " \n" "\n" WORDS "${WORDS}")
+string(REGEX REPLACE "[ \n]+$" "" WORDS "${WORDS}")
+
+file(WRITE ${OUTPUT}
+"// Generated from ${FILE_NAME} by cmake/EmbedSpirv.cmake, do not edit.
+
+#include <stdint.h>
+
+namespace gepard {
+namespace vulkan {
+
+constexpr uint32_t ${ARRAY_NAME}[] = {
+    ${WORDS}
+};
+
+} // namespace vulkan
+} // namespace gepard
+")
@@ -1,5 +1,7 @@
 include(OptionMacros)
 
-ADD_CHOICE (BACKEND "Backend to use" "GLES2 SOFTWARE VULKAN" GLES2)
+ADD_CHOICE (BACKEND "Backend to prefer at runtime, the others are fallbacks" "AUTO GLES2 SOFTWARE VULKAN" AUTO)
+ADD_CHOICE (GEOMETRY "Number type of the tessellator geometry" "DOUBLE FLOAT FIXED" DOUBLE)
 ADD_OPTION (LOG_LEVEL "Print log messages during execution" 0)
 ADD_OPTION (DISABLE_LOG_COLORS "Do not color log messages" OFF)
+ADD_OPTION (ENABLE_VULKAN_VALIDATION "Enable the Khronos validation layer in the Vulkan backend" OFF)
@@ -30,10 +30,14 @@
 
 namespace gepard {
 
-GepardContext::GepardContext(Surface *surface_)
+const size_t GepardContext::kMaximumNumberOfCommands = 1024;
+
+GepardContext::GepardContext(Surface *surface_, const unsigned threadCount_)
     : surface(surface_)
+    , threadCount(threadCount_)
 {
     states.push_back(GepardState());
+    commands.reserve(kMaximumNumberOfCommands);
 }
 
 } // namespace gepard
@@ -26,14 +26,46 @@
 #ifndef GEPARD_CONTEXT_H
 #define GEPARD_CONTEXT_H
 
+#include "gepard-float.h"
 #include "gepard-path.h"
 #include "gepard-state.h"
+#include "gepard-trapezoid-tessellator.h"
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace gepard {
 
 class  Surface;
 
+/*!
+ * \brief The DrawCommand struct
+ *
+ * A recorded drawing operation with a snapshot of everything it needs:
+ * the drawing state and, for paths, the path data at the time of the call.
+ *
+ * \internal
+ */
+struct DrawCommand {
+    enum Type {
+        FillRect,
+        FillPath,
+        StrokePath,
+    };
+
+    DrawCommand(const Type type_, const GepardState& state_)
+        : type(type_)
+        , state(state_)
+    {
+    }
+
+    Type type;
+    GepardState state;
+    std::shared_ptr<PathData> pathData; //!< The path of FillPath and StrokePath.
+    TrapezoidTessellator::FillRule fillRule = TrapezoidTessellator::NonZero;
+    Float x = 0, y = 0, w = 0, h = 0; //!< The rect of FillRect.
+};
+
 /*!
  * \brief The GepardContext struct
  *
@@ -42,13 +74,19 @@ class  Surface;
  * \internal
  */
 struct GepardContext {
-    GepardContext(Surface* surface_);
+    static const size_t kMaximumNumberOfCommands;
+
+    GepardContext(Surface* surface_, const unsigned threadCount_ = 1);
 
     GepardState& currentState() { return states.back(); }
 
     Surface* surface;
+    const unsigned threadCount; //!< Requested number of the rendering threads, 0 means one per CPU core.
     std::vector<GepardState> states;
     Path path;
+    std::vector<DrawCommand> commands; //!< Recorded, not yet executed drawing operations.
+    EdgeTable edgeTable; //!< Reused by the tessellators of the fills.
+    uint64_t frameCount = 0; //!< Number of the flushes, see Surface::frameReady().
 };
 
 } // namespace gepard
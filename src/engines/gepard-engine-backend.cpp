@@ -0,0 +1,176 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gepard-engine-backend.h"
+
+#include "gepard-defs.h"
+#include <cstdlib>
+#include <cstring>
+
+#ifdef GD_USE_GLES2
+#include "gepard-gles2.h"
+#endif // GD_USE_GLES2
+#ifdef GD_USE_SOFTWARE
+#include "gepard-software.h"
+#endif // GD_USE_SOFTWARE
+#ifdef GD_USE_VULKAN
+#include "gepard-vulkan.h"
+#endif // GD_USE_VULKAN
+
+namespace gepard {
+
+/*!
+ * \brief The order of the backends which is tried by Gepard::AutoBackend.
+ *
+ * \internal
+ */
+static const Gepard::Backend s_fallbackOrder[] = {
+    Gepard::GLES2Backend,
+    Gepard::VulkanBackend,
+    Gepard::SoftwareBackend,
+};
+
+static GepardEngineBackend* createBackend(const Gepard::Backend backend, GepardContext& context)
+{
+    switch (backend) {
+#ifdef GD_USE_GLES2
+    case Gepard::GLES2Backend:
+        return new gles2::GepardGLES2(context);
+#endif // GD_USE_GLES2
+#ifdef GD_USE_VULKAN
+    case Gepard::VulkanBackend:
+        return new vulkan::GepardVulkan(context);
+#endif // GD_USE_VULKAN
+#ifdef GD_USE_SOFTWARE
+    case Gepard::SoftwareBackend:
+        return new software::GepardSoftware(context);
+#endif // GD_USE_SOFTWARE
+    default:
+        GD_CRASH("The backend is not built into the library!");
+    }
+}
+
+/*!
+ * \brief GepardEngineBackend::create
+ * \param context  the drawing context of the new backend
+ * \param backend  the requested backend
+ * \return the new backend, which is owned by the caller
+ *
+ * An explicitly requested _backend_ is a fatal error if it is not available.
+ * Gepard::AutoBackend tries the GD_BACKEND environment variable ("gles2",
+ * "vulkan" or "software") first, which only logs an error if it is unknown
+ * or not available.  Then the backend selected by the build (-DBACKEND) is
+ * tried, and then the GLES2, the Vulkan and the software backends, in this
+ * order.
+ */
+GepardEngineBackend* GepardEngineBackend::create(GepardContext& context, const Gepard::Backend backend)
+{
+    if (backend != Gepard::AutoBackend) {
+        if (!isAvailable(backend, context.surface)) {
+            GD_CRASH("The requested backend is not available!");
+        }
+        return createBackend(backend, context);
+    }
+
+    const char* overrideName = std::getenv("GD_BACKEND");
+    const Gepard::Backend override = backendFromName(overrideName);
+    if (override != Gepard::AutoBackend) {
+        if (isAvailable(override, context.surface)) {
+            return createBackend(override, context);
+        }
+        GD_LOG_ERR("The " << overrideName << " backend of GD_BACKEND is not available, falling back.");
+    }
+
+#ifdef GD_PREFERRED_BACKEND
+    const Gepard::Backend preferred = backendFromName(GD_PREFERRED_BACKEND);
+    if (isAvailable(preferred, context.surface)) {
+        return createBackend(preferred, context);
+    }
+    GD_LOG1("The " << GD_PREFERRED_BACKEND << " backend is not available, falling back.");
+#endif // GD_PREFERRED_BACKEND
+
+    for (const Gepard::Backend fallback : s_fallbackOrder) {
+        if (isAvailable(fallback, context.surface)) {
+            return createBackend(fallback, context);
+        }
+    }
+
+    GD_CRASH("Couldn't find any available backend!");
+}
+
+/*!
+ * \brief GepardEngineBackend::isAvailable
+ * \param backend  the checked backend
+ * \param surface  the target surface
+ * \return true if the _backend_ is built into the library and it can draw
+ * onto the _surface_ on this machine
+ */
+const bool GepardEngineBackend::isAvailable(const Gepard::Backend backend, Surface* surface)
+{
+    switch (backend) {
+#ifdef GD_USE_GLES2
+    case Gepard::GLES2Backend:
+        return gles2::GepardGLES2::isAvailable(surface);
+#endif // GD_USE_GLES2
+#ifdef GD_USE_VULKAN
+    case Gepard::VulkanBackend:
+        return vulkan::GepardVulkan::isAvailable(surface);
+#endif // GD_USE_VULKAN
+#ifdef GD_USE_SOFTWARE
+    case Gepard::SoftwareBackend:
+        return true;
+#endif // GD_USE_SOFTWARE
+    default:
+        return false;
+    }
+}
+
+/*!
+ * \brief GepardEngineBackend::backendFromName
+ * \param name  "gles2", "vulkan" or "software"
+ * \return the named backend, or Gepard::AutoBackend if the _name_ is empty
+ * or unknown
+ */
+const Gepard::Backend GepardEngineBackend::backendFromName(const char* name)
+{
+    if (!name || !*name) {
+        return Gepard::AutoBackend;
+    }
+
+    if (!std::strcmp(name, "gles2")) {
+        return Gepard::GLES2Backend;
+    }
+    if (!std::strcmp(name, "vulkan")) {
+        return Gepard::VulkanBackend;
+    }
+    if (!std::strcmp(name, "software")) {
+        return Gepard::SoftwareBackend;
+    }
+
+    GD_LOG_ERR("Unknown backend: " << name);
+    return Gepard::AutoBackend;
+}
+
+} // namespace gepard
@@ -0,0 +1,71 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GEPARD_ENGINE_BACKEND_H
+#define GEPARD_ENGINE_BACKEND_H
+
+#include "gepard-defs.h"
+
+#include "gepard-color.h"
+#include "gepard-context.h"
+#include "gepard-float.h"
+#include "gepard-path.h"
+#include "gepard-state.h"
+#include "gepard-trapezoid-tessellator.h"
+#include "gepard.h"
+
+namespace gepard {
+
+class Surface;
+
+/*!
+ * \brief The GepardEngineBackend class
+ *
+ * The interface of the rendering backends.  Every backend whose
+ * dependencies are found at build time is compiled into the library, and
+ * one of them is chosen when the Gepard object is constructed, see create().
+ *
+ * \internal
+ */
+class GepardEngineBackend {
+public:
+    static GepardEngineBackend* create(GepardContext&, const Gepard::Backend = Gepard::AutoBackend);
+    static const bool isAvailable(const Gepard::Backend, Surface*);
+    static const Gepard::Backend backendFromName(const char* name);
+
+    virtual ~GepardEngineBackend() {}
+
+    virtual const Gepard::Backend type() const = 0;
+
+    virtual void fillRect(const Float x, const Float y, const Float w, const Float h, const Color& fillColor) = 0;
+    virtual void fillPath(PathData*, const GepardState&, const TrapezoidTessellator::FillRule) = 0;
+    virtual void strokePath(PathData*, const GepardState&) = 0;
+    virtual void flush() = 0;
+    virtual void finish() = 0;
+};
+
+} // namespace gepard
+
+#endif // GEPARD_ENGINE_BACKEND_H
@@ -34,102 +34,10 @@
 
 namespace gepard {
 
-/* PathElement */
-
-PathElement::PathElement()
-    : next(nullptr)
-    , type(PathElementTypes::Undefined)
-{
-}
-
-PathElement::PathElement(const PathElementType type)
-    : next(nullptr)
-    , type(type)
-{
-}
-
-PathElement::PathElement(const PathElementType type, const FloatPoint& to)
-    : next(nullptr)
-    , type(type)
-    , to(to)
-{}
-
-const bool PathElement::isMoveTo() const
-{
-    return this->type == PathElementTypes::MoveTo;
-}
-
-const bool PathElement::isCloseSubpath() const
-{
-    return this->type == PathElementTypes::CloseSubpath;
-}
-
-std::ostream& PathElement::output(std::ostream& os) const
-{
-    return os << this->to;
-}
-
-std::ostream& operator<<(std::ostream& os, const PathElement& ps)
-{
-    return ps.output(os);
-}
-
-MoveToElement::MoveToElement(const FloatPoint& to)
-    : PathElement(PathElementTypes::MoveTo, to)
-{
-}
-
-std::ostream& MoveToElement::output(std::ostream& os) const
-{
-    return PathElement::output(os << "M");
-}
-
-LineToElement::LineToElement(const FloatPoint& to)
-    : PathElement(PathElementTypes::LineTo, to)
-{
-}
+/* PathArc */
 
-std::ostream& LineToElement::output(std::ostream& os) const
-{
-    return PathElement::output(os << "L");
-}
-
-CloseSubpathElement::CloseSubpathElement(const FloatPoint& to)
-    : PathElement(PathElementTypes::CloseSubpath, to)
-{
-}
-
-std::ostream& CloseSubpathElement::output(std::ostream& os) const
-{
-    return PathElement::output(os << "Z");
-}
-
-QuadraticCurveToElement::QuadraticCurveToElement(const FloatPoint& control, const FloatPoint& to)
-    : PathElement(PathElementTypes::QuadraticCurve, to)
-    , control(control)
-{
-}
-
-std::ostream& QuadraticCurveToElement::output(std::ostream& os) const
-{
-    return PathElement::output(os << "Q" << this->control << " ");
-}
-
-BezierCurveToElement::BezierCurveToElement(const FloatPoint& control1, const FloatPoint& control2, const FloatPoint& to)
-    : PathElement(PathElementTypes::BezierCurve, to)
-    , control1(control1)
-    , control2(control2)
-{
-}
-
-std::ostream& BezierCurveToElement::output(std::ostream& os) const
-{
-    return PathElement::output(os << "C" << this->control1 << " " << this->control2 << " ");
-}
-
-ArcElement::ArcElement(const FloatPoint& center, const FloatPoint& radius, const Float startAngle, const Float endAngle, const bool counterClockwise)
-    : PathElement(PathElementTypes::Arc, FloatPoint(center.x + std::cos(endAngle) * radius.x, center.y + std::sin(endAngle) * radius.y))
-    , center(center)
+PathArc::PathArc(const FloatPoint& center, const FloatPoint& radius, const Float startAngle, const Float endAngle, const bool counterClockwise)
+    : center(center)
     , radius(radius)
     , startAngle(startAngle)
     , endAngle(endAngle)
@@ -138,86 +46,107 @@ ArcElement::ArcElement(const FloatPoint& center, const FloatPoint& radius, const
     GD_ASSERT(radius.x >= 0 && radius.y >= 0);
 }
 
-std::ostream& ArcElement::output(std::ostream& os) const
+/* PathElement */
+
+std::ostream& operator<<(std::ostream& os, const PathElement& element)
 {
-    // TODO(szledan): generate SVG representation
-    os << "A";
-    return PathElement::output(os);
+    switch (element.type) {
+    case PathElementTypes::MoveTo:
+        os << "M";
+        break;
+    case PathElementTypes::LineTo:
+        os << "L";
+        break;
+    case PathElementTypes::QuadraticCurve:
+        os << "Q" << element.control() << " ";
+        break;
+    case PathElementTypes::BezierCurve:
+        os << "C" << element.control1() << " " << element.control2() << " ";
+        break;
+    case PathElementTypes::Arc:
+        // TODO(szledan): generate SVG representation
+        os << "A";
+        break;
+    case PathElementTypes::CloseSubpath:
+        os << "Z";
+        break;
+    default:
+        break;
+    }
+    return os << element.to();
 }
 
 /* PathData */
 
 PathData::PathData()
-    : _firstElement(nullptr)
-    , _lastElement(nullptr)
-    , _lastMoveToElement(nullptr)
+    : _lastMoveToIndex(0)
 {}
 
 void PathData::addMoveToElement(FloatPoint to)
 {
-    if (_lastElement && _lastElement->isMoveTo()) {
-        _lastElement->to = to;
-        return;
+    // The new MoveTo replaces the previous one, which may have had another transform.
+    if (!isEmpty() && lastType() == PathElementTypes::MoveTo) {
+        _verbs.pop_back();
+        _points.pop_back();
     }
 
-    PathElement* currentElement = static_cast<PathElement*>(new (_region.alloc(sizeof(MoveToElement))) MoveToElement(to));
-    GD_LOG4("Add path element: " << (*currentElement));
-
-    if (!_firstElement) {
-        _firstElement = currentElement;
-        _lastElement = _firstElement;
-    } else {
-        _lastElement->next = currentElement;
-        _lastElement = _lastElement->next;
-    }
-
-    _lastMoveToElement = _lastElement;
+    tagTransform();
+    _lastMoveToIndex = _points.size();
+    _verbs.push_back(PathElementTypes::MoveTo);
+    _points.push_back(to);
+    GD_LOG4("Add path element: " << lastElement());
 }
 
 void PathData::addLineToElement(FloatPoint to)
 {
-    if (!_lastElement) {
+    if (isEmpty()) {
         addMoveToElement(to);
         return;
     }
 
-    if (_lastElement->to == to)
+    if (lastPoint() == to)
         return;
 
-    _lastElement->next = static_cast<PathElement*>(new (_region.alloc(sizeof(LineToElement))) LineToElement(to));
-    _lastElement = _lastElement->next;
-    GD_LOG4("Add path element: " << (*_lastElement));
+    tagTransform();
+    _verbs.push_back(PathElementTypes::LineTo);
+    _points.push_back(to);
+    GD_LOG4("Add path element: " << lastElement());
 }
 
 void PathData::addQuadaraticCurveToElement(FloatPoint control, FloatPoint to)
 {
-    if (!_lastElement) {
+    if (isEmpty()) {
         addMoveToElement(to);
         return;
     }
 
-    _lastElement->next = static_cast<PathElement*>(new (_region.alloc(sizeof(QuadraticCurveToElement))) QuadraticCurveToElement(control, to));
-    _lastElement = _lastElement->next;
-    GD_LOG4("Add path element: " << (*_lastElement));
+    tagTransform();
+    _verbs.push_back(PathElementTypes::QuadraticCurve);
+    _points.push_back(control);
+    _points.push_back(to);
+    GD_LOG4("Add path element: " << lastElement());
 }
 
 void PathData::addBezierCurveToElement(FloatPoint control1, FloatPoint control2, FloatPoint to)
 {
-    if (!_lastElement) {
+    if (isEmpty()) {
         addMoveToElement(to);
         return;
     }
 
-    _lastElement->next = static_cast<PathElement*>(new (_region.alloc(sizeof(BezierCurveToElement))) BezierCurveToElement(control1, control2, to));
-    _lastElement = _lastElement->next;
-    GD_LOG4("Add path element: " << (*_lastElement));
+    tagTransform();
+    _verbs.push_back(PathElementTypes::BezierCurve);
+    _points.push_back(control1);
+    _points.push_back(control2);
+    _points.push_back(to);
+    GD_LOG4("Add path element: " << lastElement());
 }
 
 void PathData::addArcElement(FloatPoint center, FloatPoint radius, Float startAngle, Float endAngle, bool antiClockwise)
 {
     FloatPoint start = FloatPoint(center.x + std::cos(startAngle) * radius.x, center.y + std::sin(startAngle) * radius.y);
 
-    if (!_lastElement) {
+    if (isEmpty()) {
         addMoveToElement(center);
         return;
     }
@@ -227,7 +156,7 @@ void PathData::addArcElement(FloatPoint center, FloatPoint radius, Float startAn
         return;
     }
 
-    if (_lastElement->to != start) {
+    if (lastPoint() != start) {
         addLineToElement(start);
     }
 
@@ -266,23 +195,25 @@ void PathData::addArcElement(FloatPoint center, FloatPoint radius, Float startAn
         }
     }
 
-    _lastElement->next = static_cast<PathElement*>(new (_region.alloc(sizeof(ArcElement))) ArcElement(center, radius, startAngle, endAngle, antiClockwise));
-    _lastElement = _lastElement->next;
-    GD_LOG4("Add path element: " << (*_lastElement));
+    tagTransform();
+    _verbs.push_back(PathElementTypes::Arc);
+    _points.push_back(FloatPoint(center.x + std::cos(endAngle) * radius.x, center.y + std::sin(endAngle) * radius.y));
+    _arcs.push_back(PathArc(center, radius, startAngle, endAngle, antiClockwise));
+    GD_LOG4("Add path element: " << lastElement());
 }
 
 void PathData::addArcToElement(const FloatPoint& control, const FloatPoint& end, const Float& radius)
 {
-    if (!_lastElement) {
+    if (isEmpty()) {
         addMoveToElement(control);
         return;
     }
 
-    if (_lastElement->to == control || control == end || !radius) {
+    if (lastPoint() == control || control == end || !radius) {
         addLineToElement(control);
     }
 
-    const FloatPoint start(_lastElement->to);
+    const FloatPoint start(lastPoint());
 
     const FloatPoint delta1(start - control);
     const FloatPoint delta2(end - control);
@@ -344,79 +275,81 @@ void PathData::addArcToElement(const FloatPoint& control, const FloatPoint& end,
 
 void PathData::addCloseSubpathElement()
 {
-    if (!_lastElement || _lastElement->isCloseSubpath())
+    if (isEmpty() || lastType() == PathElementTypes::CloseSubpath)
         return;
 
-    if (_lastElement->isMoveTo()) {
-        addLineToElement(_lastElement->to);
+    if (lastType() == PathElementTypes::MoveTo) {
+        addLineToElement(lastPoint());
     }
 
-    _lastElement->next = static_cast<PathElement*>(new (_region.alloc(sizeof(CloseSubpathElement))) CloseSubpathElement(_lastMoveToElement->to));
-    _lastElement = _lastElement->next;
-    GD_LOG4("Add path element: " << (*_lastElement));
+    const FloatPoint subpathStart = userPoint(_lastMoveToIndex);
+    tagTransform();
+    _verbs.push_back(PathElementTypes::CloseSubpath);
+    _points.push_back(subpathStart);
+    GD_LOG4("Add path element: " << lastElement());
 }
 
-void PathData::applyTransform(const Transform& transform)
+/*!
+ * \brief PathData::userPoint
+ * \param pointIndex  index of a stored point
+ * \return  the point in the user space of the current transform
+ *
+ * \internal
+ */
+const FloatPoint PathData::userPoint(const size_t pointIndex) const
 {
-    PathElement* element = _firstElement;
-
-    while (element) {
-        switch (element->type) {
-        case PathElementTypes::MoveTo:
-        case PathElementTypes::CloseSubpath:
-        case PathElementTypes::LineTo:
-            element->to = transform.apply(element->to);
-            break;
-        case PathElementTypes::QuadraticCurve:
-            QuadraticCurveToElement* quadToElement;
-            quadToElement = reinterpret_cast<QuadraticCurveToElement*>(element);
-            quadToElement->to = transform.apply(quadToElement->to);
-            quadToElement->control = transform.apply(quadToElement->control);
-            break;
-        case PathElementTypes::BezierCurve:
-            BezierCurveToElement* curveToElement;
-            curveToElement = reinterpret_cast<BezierCurveToElement*>(element);
-            curveToElement->to = transform.apply(curveToElement->to);
-            curveToElement->control1 = transform.apply(curveToElement->control1);
-            curveToElement->control2 = transform.apply(curveToElement->control2);
-            break;
-        case PathElementTypes::Arc:
-            ArcElement* arcToElement;
-            arcToElement = reinterpret_cast<ArcElement*>(element);
-            arcToElement->to = transform.apply(arcToElement->to);
-            arcToElement->multiply(transform);
-            break;
-        default:
-            break;
-        }
-
-        element = element->next;
+    GD_ASSERT(pointIndex < _points.size() && !_tags.empty());
+    size_t tagIndex = _tags.size() - 1;
+    while (_tags[tagIndex].pointIndex > pointIndex) {
+        GD_ASSERT(tagIndex);
+        tagIndex--;
     }
+
+    const Transform& transform = _tags[tagIndex].transform;
+    if (transform == _transform)
+        return _points[pointIndex];
+
+    return _transform.inverse().apply(transform.apply(_points[pointIndex]));
 }
 
-const bool PathData::isEmpty() const
+/*!
+ * \brief PathData::tagTransform
+ *
+ * Record the current transform for the points which are added next.  A new
+ * tag is only needed when the transform was changed since the last element.
+ *
+ * \internal
+ */
+void PathData::tagTransform()
 {
-    //! \todo(szledan): Need more investigation of condition.
-    return !_firstElement && _firstElement == _lastElement;
+    if (!_tags.empty()) {
+        PathTransformTag& lastTag = _tags.back();
+        if (lastTag.transform == _transform)
+            return;
+
+        // The last tag has no points, e.g. its MoveTo was replaced.
+        if (lastTag.pointIndex == _points.size()) {
+            lastTag.transform = _transform;
+            return;
+        }
+    }
+
+    _tags.push_back({ _points.size(), _transform });
 }
 
-const PathElement* PathData::operator[](std::size_t idx) const
+const PathElement PathData::lastElement() const
 {
-    PathElement* element = _firstElement;
-
-    std::size_t i = 0;
-    while (element) {
-        if (i == idx)
-            break;
-        i++;
-        element = element->next;
-    }
+    GD_ASSERT(!isEmpty());
+    const PathElementType type = lastType();
+    return { type, _points.data() + _points.size() - PathElement::pointCount(type), type == PathElementTypes::Arc ? &_arcs.back() : nullptr, &_tags.back().transform };
+}
 
-    if (!element) {
-        element = _lastElement;
+std::ostream& operator<<(std::ostream& os, const PathData& pathData)
+{
+    for (const PathElement& element : pathData) {
+        os << element << " ";
     }
-
-    return element;
+    return os;
 }
 
 /* Path */
@@ -426,19 +359,26 @@ Path::Path()
 {
 }
 
-Path::~Path()
+/*!
+ * \brief Path::pathData
+ * \return  the modifiable path data
+ *
+ * The path data is shared with the recorded draw commands (see snapshot()),
+ * so it is copied before the first modification after a snapshot.
+ *
+ * \internal
+ */
+PathData* Path::pathData()
 {
-    if (_pathData) {
-        delete _pathData;
+    if (_pathData.use_count() > 1) {
+        _pathData = std::make_shared<PathData>(*_pathData);
     }
+    return _pathData.get();
 }
 
 void Path::clear()
 {
-    if (_pathData) {
-        delete _pathData;
-    }
-    _pathData = new PathData();
+    _pathData = std::make_shared<PathData>();
 }
 
 } // namespace gepard
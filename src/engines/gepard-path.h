@@ -26,11 +26,14 @@
 #ifndef GEPARD_PATH_H
 #define GEPARD_PATH_H
 
+#include "gepard-defs.h"
 #include "gepard-float-point.h"
 #include "gepard-float.h"
-#include "gepard-region.h"
 #include "gepard-transform.h"
+#include <memory>
 #include <ostream>
+#include <stdint.h>
+#include <vector>
 
 namespace gepard {
 
@@ -44,73 +47,143 @@ typedef enum PathElementTypes {
     CloseSubpath,
 } PathElementType;
 
-struct PathElement {
-    explicit PathElement();
-    explicit PathElement(const PathElementType type);
-    explicit PathElement(const PathElementType type, const FloatPoint& to);
-
-    const bool isMoveTo() const;
-    const bool isCloseSubpath() const;
-    virtual std::ostream& output(std::ostream& os) const;
-
-    PathElement* next;
-    PathElementType type;
-    FloatPoint to;
-};
-
-inline std::ostream& operator<<(std::ostream& os, const PathElement& ps);
-
-struct MoveToElement : public PathElement {
-    explicit MoveToElement(const FloatPoint& to);
+/*!
+ * \brief The parameters of an arc element, see PathData::addArcElement().
+ *
+ * \internal
+ */
+struct PathArc {
+    explicit PathArc(const FloatPoint& center, const FloatPoint& radius, const Float startAngle, const Float endAngle, const bool counterClockwise = false);
 
-    std::ostream& output(std::ostream& os) const;
+    FloatPoint center;
+    FloatPoint radius;
+    Float startAngle;
+    Float endAngle;
+    bool counterClockwise;
 };
 
-struct LineToElement : public PathElement {
-    explicit LineToElement(const FloatPoint& to);
-
-    std::ostream& output(std::ostream& os) const;
+/*!
+ * \brief The transform of the points from _pointIndex_ until the next tag.
+ *
+ * \internal
+ */
+struct PathTransformTag {
+    size_t pointIndex;
+    Transform transform;
 };
 
-struct CloseSubpathElement : public PathElement {
-    explicit CloseSubpathElement(const FloatPoint& to);
-
-    std::ostream& output(std::ostream& os) const;
-};
+/*!
+ * \brief A path element, which refers to the storage of its PathData.
+ *
+ * The points of an element are its control points followed by its end
+ * point, see pointCount().  The points are in the user space of the
+ * _transform_, which maps them to the device space.  The element is valid
+ * until its path data is modified.
+ *
+ * \internal
+ */
+struct PathElement {
+    static const int pointCount(const PathElementType type);
 
-struct QuadraticCurveToElement : public PathElement {
-    explicit QuadraticCurveToElement(const FloatPoint& control, const FloatPoint& to);
+    const bool isMoveTo() const { return type == PathElementTypes::MoveTo; }
+    const bool isCloseSubpath() const { return type == PathElementTypes::CloseSubpath; }
 
-    std::ostream& output(std::ostream& os) const;
+    const FloatPoint& to() const { return points[pointCount(type) - 1]; }
+    const FloatPoint& control() const { GD_ASSERT(type == PathElementTypes::QuadraticCurve); return points[0]; }
+    const FloatPoint& control1() const { GD_ASSERT(type == PathElementTypes::BezierCurve); return points[0]; }
+    const FloatPoint& control2() const { GD_ASSERT(type == PathElementTypes::BezierCurve); return points[1]; }
 
-    FloatPoint control;
+    PathElementType type;
+    const FloatPoint* points;
+    const PathArc* arc; //!< The parameters of an Arc, otherwise nullptr.
+    const Transform* transform;
 };
 
-struct BezierCurveToElement : public PathElement {
-    explicit BezierCurveToElement(const FloatPoint& control1, const FloatPoint& control2, const FloatPoint& to);
-
-    std::ostream& output(std::ostream& os) const;
-
-    FloatPoint control1;
-    FloatPoint control2;
-};
+inline const int PathElement::pointCount(const PathElementType type)
+{
+    // Undefined, MoveTo, LineTo, QuadraticCurve, BezierCurve, Arc, CloseSubpath
+    static const int s_pointCounts[] = { 0, 1, 1, 2, 3, 1, 1 };
+    return s_pointCounts[type];
+}
 
-struct ArcElement : public PathElement {
-    explicit ArcElement(const FloatPoint& center, const FloatPoint& radius, const Float startAngle, const Float endAngle, const bool counterClockwise = false);
+std::ostream& operator<<(std::ostream& os, const PathElement& element);
 
-    std::ostream& output(std::ostream& os) const;
-    void multiply(const Transform& newTransform) { transform *= newTransform; }
+/*!
+ * \brief Forward iterator over the elements of a PathData.
+ *
+ * \internal
+ */
+class PathIterator {
+public:
+    PathIterator(const uint8_t* verb, const FloatPoint* points, const PathArc* arc, const PathTransformTag* tag, const PathTransformTag* lastTag)
+        : _verb(verb)
+        , _points(points)
+        , _arc(arc)
+        , _pointIndex(0)
+        , _tag(tag)
+        , _lastTag(lastTag)
+    {
+        skipPassedTags();
+    }
+
+    const PathElement operator*() const
+    {
+        const PathElementType type = static_cast<PathElementType>(*_verb);
+        return { type, _points, type == PathElementTypes::Arc ? _arc : nullptr, &_tag->transform };
+    }
+
+    PathIterator& operator++()
+    {
+        const PathElementType type = static_cast<PathElementType>(*_verb);
+        _points += PathElement::pointCount(type);
+        _pointIndex += PathElement::pointCount(type);
+        if (type == PathElementTypes::Arc) {
+            _arc++;
+        }
+        _verb++;
+        skipPassedTags();
+        return *this;
+    }
+
+    const bool operator==(const PathIterator& other) const { return _verb == other._verb; }
+    const bool operator!=(const PathIterator& other) const { return _verb != other._verb; }
 
-    FloatPoint center;
-    FloatPoint radius;
-    Float startAngle;
-    Float endAngle;
-    bool counterClockwise;
-    Transform transform;
+private:
+    void skipPassedTags()
+    {
+        while (_tag != _lastTag && (_tag + 1)->pointIndex <= _pointIndex) {
+            _tag++;
+        }
+    }
+
+    const uint8_t* _verb;
+    const FloatPoint* _points;
+    const PathArc* _arc;
+    size_t _pointIndex;
+    const PathTransformTag* _tag;
+    const PathTransformTag* _lastTag;
 };
 
+/*!
+ * \brief The PathData struct
+ *
+ * The elements are stored in flat arrays: a verb (the PathElementType) for
+ * each element, the points of all elements in one contiguous array, and the
+ * parameters of the arcs in a third one.  The elements are read by a
+ * PathIterator.
+ *
+ * The points are stored in the user space of the transform which was set
+ * by setTransform() when they were added.  The transform is recorded only
+ * once for a run of points (see PathTransformTag), so changing the
+ * transform is O(1) and every point is transformed once when the path is
+ * tessellated.
+ *
+ * \internal
+ */
 struct PathData {
     explicit PathData();
+    PathData(const PathData&) = default;
+    PathData& operator=(const PathData&) = delete;
 
     void addMoveToElement(FloatPoint);
     void addLineToElement(FloatPoint);
@@ -120,34 +193,47 @@ struct PathData {
     void addArcToElement(const FloatPoint&, const FloatPoint&, const Float&);
     void addCloseSubpathElement();
 
-    void applyTransform(const Transform&);
+    void setTransform(const Transform& transform) { _transform = transform; }
+    const Transform& transform() const { return _transform; }
 
-    PathElement* firstElement() const { return _firstElement; }
-    PathElement* lastElement() const { return _lastElement; }
+    PathIterator begin() const
+    {
+        return PathIterator(_verbs.data(), _points.data(), _arcs.data(), _tags.data(), _tags.empty() ? nullptr : &_tags.back());
+    }
+    PathIterator end() const { return PathIterator(_verbs.data() + _verbs.size(), nullptr, nullptr, nullptr, nullptr); }
 
-    const bool isEmpty() const;
-
-    const PathElement* operator[](std::size_t idx) const;
+    const PathElement lastElement() const;
+    const size_t elementCount() const { return _verbs.size(); }
+    const bool isEmpty() const { return _verbs.empty(); }
 
 private:
-    Region<> _region;
-    PathElement* _firstElement;
-    PathElement* _lastElement;
-    PathElement* _lastMoveToElement;
+    const PathElementType lastType() const { return static_cast<PathElementType>(_verbs.back()); }
+    const FloatPoint userPoint(const size_t pointIndex) const;
+    const FloatPoint lastPoint() const { return userPoint(_points.size() - 1); }
+    void tagTransform();
+
+    std::vector<uint8_t> _verbs; //!< The PathElementType of each element.
+    std::vector<FloatPoint> _points;
+    std::vector<PathArc> _arcs;
+    std::vector<PathTransformTag> _tags; //!< Ordered by their pointIndex.
+    Transform _transform; //!< The transform of the next element.
+    size_t _lastMoveToIndex; //!< Index of the point of the last MoveTo in the _points.
 };
 
+std::ostream& operator<<(std::ostream& os, const PathData& pathData);
+
 /* Path */
 
 class Path {
 public:
     explicit Path();
-    ~Path();
 
-    PathData* pathData() { return _pathData; }
+    PathData* pathData();
+    std::shared_ptr<PathData> snapshot() const { return _pathData; }
     void clear();
 
 private:
-    PathData* _pathData;
+    std::shared_ptr<PathData> _pathData;
 };
 
 } // namespace gepard
@@ -31,6 +31,7 @@
 #include "gepard-line-types.h"
 #include "gepard-path.h"
 #include "gepard-trapezoid-tessellator.h"
+#include <algorithm>
 #include <cmath>
 
 namespace gepard {
@@ -95,32 +96,58 @@ StrokePathBuilder::StrokePathBuilder(const Float width, const Float miterLimit,
     _currentLine->next = _lastLine;
 }
 
-void StrokePathBuilder::convertStrokeToFill(const PathData* path)
+/*!
+ * \brief StrokePathBuilder::convertStrokeToFill
+ * \param path  the path to stroke
+ * \param transform  the transform of the stroke, the line width is given in its user space
+ *
+ * The elements of the _path_ which were added with another transform are
+ * mapped to the user space of the stroke first.
+ *
+ * \internal
+ */
+void StrokePathBuilder::convertStrokeToFill(const PathData* path, const Transform& transform)
 {
-    PathElement* element = path->firstElement();
+    _path.setTransform(transform);
+
+    const Transform inverse = transform.inverse();
+    const Transform* elementTransform = nullptr;
+    Transform toUserSpace;
+    bool isUserSpace = true;
+    auto userPoint = [&](const FloatPoint& point) { return isUserSpace ? point : toUserSpace.apply(point); };
 
     FloatPoint from;
-    while (element) {
-        FloatPoint to = element->to;
+    for (const PathElement element : *path) {
+        if (element.transform != elementTransform) {
+            elementTransform = element.transform;
+            isUserSpace = *elementTransform == transform;
+            toUserSpace = inverse * *elementTransform;
+        }
+        const FloatPoint to = userPoint(element.to());
 
-        switch (element->type) {
+        switch (element.type) {
         case MoveTo:
             addMoveToShape();
             break;
         case CloseSubpath:
-            addCloseSubpathShape(from, reinterpret_cast<CloseSubpathElement*>(element));
+            addCloseSubpathShape(from, to);
             break;
         case LineTo:
-            addLineShape(from, reinterpret_cast<LineToElement*>(element));
+            addLineShape(from, to);
             break;
         case QuadraticCurve:
-            addBezierCurveShape(from, reinterpret_cast<QuadraticCurveToElement*>(element));
+            addQuadraticCurveShape(from, userPoint(element.control()), to);
             break;
         case BezierCurve:
-            addBezierCurveShape(from, reinterpret_cast<BezierCurveToElement*>(element));
+            addBezierCurveShape(from, userPoint(element.control1()), userPoint(element.control2()), to);
             break;
         case Arc:
-            addArcShape(from, reinterpret_cast<ArcElement*>(element));
+            if (isUserSpace) {
+                addArcShape(from, *element.arc, to);
+            } else {
+                // The radii and the angles of the arc are in its own space.
+                addArcCurvesShape(from, *element.arc, toUserSpace, to);
+            }
             break;
         case Undefined:
         default:
@@ -129,7 +156,6 @@ void StrokePathBuilder::convertStrokeToFill(const PathData* path)
         }
 
         from = to;
-        element = element->next;
     }
 
     addCapShapeIfNeeded();
@@ -144,14 +170,14 @@ inline void StrokePathBuilder::addMoveToShape()
     _hasShapeFirstLine = false;
 }
 
-inline void StrokePathBuilder::addLineShape(const FloatPoint& start, const LineToElement* element)
+inline void StrokePathBuilder::addLineShape(const FloatPoint& start, const FloatPoint& end)
 {
-    if (start == element->to)
+    if (start == end)
         return;
 
-    _currentLine->set(start, element->to, _halfWidth);
+    _currentLine->set(start, end, _halfWidth);
     if (!_hasShapeFirstLine) {
-        _shapeFirstLine->set(start, element->to, _halfWidth);
+        _shapeFirstLine->set(start, end, _halfWidth);
         _hasShapeFirstLine = true;
     } else
         addJoinShape(_lastLine, _currentLine);
@@ -161,12 +187,12 @@ inline void StrokePathBuilder::addLineShape(const FloatPoint& start, const LineT
     setCurrentLineAttribute();
 }
 
-inline void StrokePathBuilder::addCloseSubpathShape(const FloatPoint& start, const CloseSubpathElement* element)
+inline void StrokePathBuilder::addCloseSubpathShape(const FloatPoint& start, const FloatPoint& end)
 {
-    if (!_hasShapeFirstLine || start == element->to)
+    if (!_hasShapeFirstLine || start == end)
         return;
 
-    _currentLine->set(start, element->to, _halfWidth);
+    _currentLine->set(start, end, _halfWidth);
     addJoinShape(_lastLine, _currentLine);
     addJoinShape(_currentLine, _shapeFirstLine);
 
@@ -260,21 +286,16 @@ void StrokePathBuilder::bezierCurveShape(const FloatPoint& start, const FloatPoi
     } while (points >= buffer);
 }
 
-inline void StrokePathBuilder::addBezierCurveShape(const FloatPoint& start, const QuadraticCurveToElement* element)
+inline void StrokePathBuilder::addQuadraticCurveShape(const FloatPoint& start, const FloatPoint& control, const FloatPoint& end)
 {
     static const Float twoThird = static_cast<Float>(2) / 3;
-    const FloatPoint control1(twoThird * (element->control.x - start.x) + start.x, twoThird * (element->control.y - start.y) + start.y);
-    const FloatPoint control2(twoThird * (element->control.x - element->to.x) + element->to.x, twoThird * (element->control.y - element->to.y) + element->to.y);
-    const BezierCurveToElement cubicCurve(control1, control2, element->to);
-    addBezierCurveShape(start, &cubicCurve);
+    const FloatPoint control1(twoThird * (control.x - start.x) + start.x, twoThird * (control.y - start.y) + start.y);
+    const FloatPoint control2(twoThird * (control.x - end.x) + end.x, twoThird * (control.y - end.y) + end.y);
+    addBezierCurveShape(start, control1, control2, end);
 }
 
-inline void StrokePathBuilder::addBezierCurveShape(const FloatPoint& start, const BezierCurveToElement* element)
+inline void StrokePathBuilder::addBezierCurveShape(const FloatPoint& start, const FloatPoint& control1, const FloatPoint& control2, const FloatPoint& end)
 {
-    const FloatPoint control1 = element->control1;
-    const FloatPoint control2 = element->control2;
-    const FloatPoint end = element->to;
-
     FloatPoint to = control1;
     FloatPoint from = control2;
     if (control1 == start) {
@@ -311,33 +332,64 @@ inline void StrokePathBuilder::addBezierCurveShape(const FloatPoint& start, cons
     bezierCurveShape(start, control1, control2, end);
 }
 
-inline void StrokePathBuilder::addArcShape(const FloatPoint& start, const ArcElement* element)
+/*!
+ * \brief Add an arc, which was added under another transform, as bezier curves
+ * \param start  the start point of the arc in the user space of the stroke
+ * \param arc  the arc in its own space
+ * \param transform  maps the space of the _arc_ to the user space of the stroke
+ * \param end  the end point of the arc in the user space of the stroke
+ *
+ * The arc is split the same way as SegmentApproximator::insertArc() does.
+ *
+ * \internal
+ */
+inline void StrokePathBuilder::addArcCurvesShape(const FloatPoint& start, const PathArc& arc, const Transform& transform, const FloatPoint& end)
+{
+    Transform arcTransform = transform;
+    arcTransform *= Transform(arc.radius.x, 0.0, 0.0, arc.radius.y, arc.center.x, arc.center.y);
+
+    const Float deltaAngle = arc.counterClockwise ? arc.startAngle - arc.endAngle : arc.endAngle - arc.startAngle;
+    const int segments = _segmentApproximator.calculateArcSegments(deltaAngle, std::max(arc.radius.x * 2, arc.radius.y * 2));
+    const Float step = (arc.counterClockwise ? -deltaAngle : deltaAngle) / segments;
+
+    FloatPoint from = start;
+    Float startAngle = arc.startAngle;
+    FloatPoint bezierPoints[3];
+    for (int i = 0; i < segments; i++, startAngle += step) {
+        const bool isLast = i == segments - 1;
+        _segmentApproximator.arcToCurve(bezierPoints, startAngle, isLast ? arc.endAngle : startAngle + step);
+        const FloatPoint to = isLast ? end : arcTransform.apply(bezierPoints[2]);
+        addBezierCurveShape(from, arcTransform.apply(bezierPoints[0]), arcTransform.apply(bezierPoints[1]), to);
+        from = to;
+    }
+}
+
+inline void StrokePathBuilder::addArcShape(const FloatPoint& start, const PathArc& arc, const FloatPoint& end)
 {
-    const Float direction = element->counterClockwise ? 1.0 : -1.0;
-    const FloatPoint end(element->to);
+    const Float direction = arc.counterClockwise ? 1.0 : -1.0;
 
     // Set the continuous vector to join or cap shape method.
-    _currentLine->set(start, start + direction * FloatPoint(std::sin(element->startAngle), -std::cos(element->startAngle)), _halfWidth);
+    _currentLine->set(start, start + direction * FloatPoint(std::sin(arc.startAngle), -std::cos(arc.startAngle)), _halfWidth);
 
     if (!_hasShapeFirstLine) {
-        _shapeFirstLine->set(start, start + direction * FloatPoint(std::sin(element->startAngle), -std::cos(element->startAngle)), _halfWidth);
+        _shapeFirstLine->set(start, start + direction * FloatPoint(std::sin(arc.startAngle), -std::cos(arc.startAngle)), _halfWidth);
         _hasShapeFirstLine = true;
     } else {
         addJoinShape(_lastLine, _currentLine);
     }
 
     // Set the continuous vector to join or cap shape method.
-    _currentLine->set(end - direction * FloatPoint(std::sin(element->endAngle), -std::cos(element->endAngle)), end, _halfWidth);
+    _currentLine->set(end - direction * FloatPoint(std::sin(arc.endAngle), -std::cos(arc.endAngle)), end, _halfWidth);
 
-    const FloatPoint firstRadius = element->radius + direction *  FloatPoint(_halfWidth, _halfWidth);
-    const FloatPoint secondRadius = element->radius - direction * FloatPoint(_halfWidth, _halfWidth);
+    const FloatPoint firstRadius = arc.radius + direction *  FloatPoint(_halfWidth, _halfWidth);
+    const FloatPoint secondRadius = arc.radius - direction * FloatPoint(_halfWidth, _halfWidth);
 
-    const FloatPoint startPoint(element->center.x + firstRadius.x * std::cos(element->startAngle), element->center.y + firstRadius.y * sin(element->startAngle));
-    const FloatPoint endPoint(element->center.x + secondRadius.x * std::cos(element->endAngle), element->center.y + secondRadius.y * sin(element->endAngle));
+    const FloatPoint startPoint(arc.center.x + firstRadius.x * std::cos(arc.startAngle), arc.center.y + firstRadius.y * sin(arc.startAngle));
+    const FloatPoint endPoint(arc.center.x + secondRadius.x * std::cos(arc.endAngle), arc.center.y + secondRadius.y * sin(arc.endAngle));
     _path.addMoveToElement(startPoint);
-    _path.addArcElement(element->center, firstRadius, element->startAngle, element->endAngle, element->counterClockwise);
+    _path.addArcElement(arc.center, firstRadius, arc.startAngle, arc.endAngle, arc.counterClockwise);
     _path.addLineToElement(endPoint);
-    _path.addArcElement(element->center, secondRadius, element->endAngle, element->startAngle, !element->counterClockwise);
+    _path.addArcElement(arc.center, secondRadius, arc.endAngle, arc.startAngle, !arc.counterClockwise);
     _path.addCloseSubpathElement();
 
     setCurrentLineAttribute();
@@ -31,6 +31,7 @@
 #include "gepard-float.h"
 #include "gepard-line-types.h"
 #include "gepard-path.h"
+#include "gepard-transform.h"
 #include "gepard-trapezoid-tessellator.h"
 
 namespace gepard {
@@ -64,16 +65,17 @@ class StrokePathBuilder {
 public:
     StrokePathBuilder(const Float width, const Float miterLimit, const LineJoinType joinMode, const LineCapType lineCap);
 
-    void convertStrokeToFill(const PathData* path);
+    void convertStrokeToFill(const PathData* path, const Transform& transform);
     PathData* pathData() { return &_path; }
 
 private:
     inline void addMoveToShape();
-    inline void addCloseSubpathShape(const FloatPoint&, const CloseSubpathElement*);
-    inline void addLineShape(const FloatPoint&, const LineToElement*);
-    inline void addBezierCurveShape(const FloatPoint&, const QuadraticCurveToElement*);
-    inline void addBezierCurveShape(const FloatPoint&, const BezierCurveToElement*);
-    inline void addArcShape(const FloatPoint&, const ArcElement*);
+    inline void addCloseSubpathShape(const FloatPoint&, const FloatPoint&);
+    inline void addLineShape(const FloatPoint&, const FloatPoint&);
+    inline void addQuadraticCurveShape(const FloatPoint&, const FloatPoint&, const FloatPoint&);
+    inline void addBezierCurveShape(const FloatPoint&, const FloatPoint&, const FloatPoint&, const FloatPoint&);
+    inline void addArcShape(const FloatPoint&, const PathArc&, const FloatPoint&);
+    inline void addArcCurvesShape(const FloatPoint&, const PathArc&, const Transform&, const FloatPoint&);
 
     void addCapShapeIfNeeded()
     {
@@ -34,19 +34,19 @@
 #include "gepard-float.h"
 #include "gepard-transform.h"
 #include <cmath>
+#include <algorithm>
 #include <list>
-#include <set>
+#include <unordered_map>
 
 namespace gepard {
 
 /* Segment */
 
-static unsigned s_segmentIds = 0;
-
-Segment::Segment(FloatPoint from, FloatPoint to, unsigned sameId, Float slope)
+template<typename Coordinate>
+BasicSegment<Coordinate>::BasicSegment(Point from, Point to, unsigned id, Float slope)
     : from(from)
     , to(to)
-    , id((sameId) ? sameId : ++s_segmentIds)
+    , id(id)
 {
     Float slopeInv = NAN;
     Float denom = this->to.y - this->from.y;
@@ -68,40 +68,46 @@ Segment::Segment(FloatPoint from, FloatPoint to, unsigned sameId, Float slope)
     realSlope = (slope == NAN) ? slopeInv : slope;
 }
 
-const int Segment::topY() const
+template<typename Coordinate>
+const int BasicSegment<Coordinate>::topY() const
 {
     return std::floor(this->from.y);
 }
 
-const int Segment::bottomY() const
+template<typename Coordinate>
+const int BasicSegment<Coordinate>::bottomY() const
 {
     return std::floor(this->to.y);
 }
 
-const Float Segment::slopeInv() const
+template<typename Coordinate>
+const Float BasicSegment<Coordinate>::slopeInv() const
 {
     return (this->to.x - this->from.x) / (this->to.y - this->from.y);
 }
 
-const Float Segment::factor() const
+template<typename Coordinate>
+const Float BasicSegment<Coordinate>::factor() const
 {
     return this->slopeInv() * this->from.y - this->from.x;
 }
 
-const bool Segment::isOnSegment(const Float y) const
+template<typename Coordinate>
+const bool BasicSegment<Coordinate>::isOnSegment(const Float y) const
 {
     return y < this->to.y && y > this->from.y;
 }
 
-const Segment Segment::splitSegment(const Float y)
+template<typename Coordinate>
+const BasicSegment<Coordinate> BasicSegment<Coordinate>::splitSegment(const Float y)
 {
     GD_ASSERT(this->from.y < this->to.y);
     GD_ASSERT(y > this->from.y && y < this->to.y);
 
     const Float x = this->slopeInv() * (y - this->from.y) + this->from.x;
-    FloatPoint to = this->to;
-    this->to = FloatPoint(x, y);
-    FloatPoint newPoint = this->to;
+    Point to = this->to;
+    this->to = Point(x, y);
+    Point newPoint = this->to;
 
     if (this->direction == Negative) {
         newPoint = to;
@@ -111,10 +117,11 @@ const Segment Segment::splitSegment(const Float y)
     GD_ASSERT(this->from.y != newPoint.y);
     GD_ASSERT(newPoint.y != to.y);
 
-    return Segment(newPoint, to, this->id, this->realSlope);
+    return BasicSegment(newPoint, to, this->id, this->realSlope);
 }
 
-const bool Segment::computeIntersectionY(Segment* segment, Float& y) const
+template<typename Coordinate>
+const bool BasicSegment<Coordinate>::computeIntersectionY(BasicSegment* segment, Float& y) const
 {
     if (this == segment)
         return false;
@@ -132,49 +139,94 @@ const bool Segment::computeIntersectionY(Segment* segment, Float& y) const
     return true;
 }
 
-std::ostream& operator<<(std::ostream& os, const Segment& s)
-{
-    return os << s.from << ((s.direction < 0) ? "<" : ((s.direction > 0) ? ">" : "=")) << s.to;
-}
-
-bool operator<(const Segment& lhs, const Segment& rhs)
+template<typename Coordinate>
+bool operator<(const BasicSegment<Coordinate>& lhs, const BasicSegment<Coordinate>& rhs)
 {
     GD_ASSERT(lhs.from <= lhs.to && rhs.from <= rhs.to);
     return (lhs.from < rhs.from) || (lhs.from == rhs.from && lhs.to < rhs.to);
 }
 
-bool operator==(const Segment& lhs, const Segment& rhs)
+template<typename Coordinate>
+bool operator==(const BasicSegment<Coordinate>& lhs, const BasicSegment<Coordinate>& rhs)
 {
     return (lhs.from == rhs.from) && (lhs.to == rhs.to);
 }
 
-bool operator<=(const Segment& lhs, const Segment& rhs)
+template<typename Coordinate>
+bool operator<=(const BasicSegment<Coordinate>& lhs, const BasicSegment<Coordinate>& rhs)
 {
     return (lhs < rhs) || (lhs == rhs);
 }
 
 /* SegmentApproximator */
 
-SegmentApproximator::SegmentApproximator(const int antiAliasLevel, const Float factor)
-    : kAntiAliasLevel(antiAliasLevel > 0 ? antiAliasLevel : GD_ANTIALIAS_LEVEL)
-    , kTolerance((factor > 0.0 ? factor : 1.0 ) / ((Float)kAntiAliasLevel))
+/*!
+ * \brief Stable LSD radix sort of the _items_ by 32 bit keys.
+ *
+ * Sorts 8 bits in a pass and skips the passes where every key has the
+ * same digit, so small key ranges need one or two passes.
+ *
+ * \internal
+ */
+template<typename T, typename KeyOf>
+static void radixSort(std::vector<T>& items, std::vector<T>& buffer, KeyOf keyOf)
 {
+    if (items.size() < 2)
+        return;
+
+    buffer.resize(items.size(), items.front());
+    for (int shift = 0; shift < 32; shift += 8) {
+        size_t offsets[257] = { 0 };
+        for (const T& item : items) {
+            ++offsets[((keyOf(item) >> shift) & 0xff) + 1];
+        }
+        if (offsets[((keyOf(items.front()) >> shift) & 0xff) + 1] == items.size())
+            continue;
+
+        for (int digit = 1; digit < 257; ++digit) {
+            offsets[digit] += offsets[digit - 1];
+        }
+        for (const T& item : items) {
+            buffer[offsets[(keyOf(item) >> shift) & 0xff]++] = item;
+        }
+        items.swap(buffer);
+    }
 }
 
-SegmentApproximator::~SegmentApproximator()
+/*!
+ * \brief Sort the sub-scanlines and remove the duplicates.
+ *
+ * \internal
+ */
+static void sortLines(std::vector<int>& lines, std::vector<int>& buffer)
 {
-    for (SegmentTree::iterator it = _segments.begin(); it != _segments.end(); ++it) {
-        delete it->second;
-    }
+    if (lines.empty())
+        return;
+
+    const uint32_t minY = *std::min_element(lines.begin(), lines.end());
+    radixSort(lines, buffer, [minY](const int y) { return uint32_t(y) - minY; });
+    lines.erase(std::unique(lines.begin(), lines.end()), lines.end());
+}
+
+template<typename Coordinate>
+BasicSegmentApproximator<Coordinate>::BasicSegmentApproximator(const int antiAliasLevel, const Float factor, EdgeTable* edgeTable)
+    : kAntiAliasLevel(antiAliasLevel > 0 ? antiAliasLevel : GD_ANTIALIAS_LEVEL)
+    , kTolerance((factor > 0.0 ? factor : 1.0 ) / ((Float)kAntiAliasLevel))
+    , _edgeTable(edgeTable ? *edgeTable : _ownEdgeTable)
+    , _segmentIds(0)
+{
+    _edgeTable.clear();
 }
 
-void SegmentApproximator::insertLine(const FloatPoint& from, const FloatPoint& to)
+template<typename Coordinate>
+void BasicSegmentApproximator<Coordinate>::insertLine(const FloatPoint& from, const FloatPoint& to)
 {
     GD_LOG4("Insert line: " << from << "->" << to);
     insertSegment(FloatPoint(from.x * kAntiAliasLevel, std::floor(from.y * kAntiAliasLevel)), FloatPoint(to.x * kAntiAliasLevel, std::floor(to.y * kAntiAliasLevel)));
 }
 
-const bool SegmentApproximator::quadCurveIsLineSegment(FloatPoint points[])
+template<typename Coordinate>
+const bool BasicSegmentApproximator<Coordinate>::quadCurveIsLineSegment(FloatPoint points[])
 {
     const Float x0 = points[0].x;
     const Float y0 = points[0].y;
@@ -209,7 +261,8 @@ const bool SegmentApproximator::quadCurveIsLineSegment(FloatPoint points[])
     return !(x1 < minX || x1 > maxX || y1 < minY || y1 > maxY);
 }
 
-void SegmentApproximator::splitQuadraticCurve(FloatPoint points[])
+template<typename Coordinate>
+void BasicSegmentApproximator<Coordinate>::splitQuadraticCurve(FloatPoint points[])
 {
     const FloatPoint a = points[0];
     const FloatPoint b = points[1];
@@ -225,7 +278,8 @@ void SegmentApproximator::splitQuadraticCurve(FloatPoint points[])
     points[4] = c;
 }
 
-void SegmentApproximator::insertQuadCurve(const FloatPoint& from, const FloatPoint& control, const FloatPoint& to)
+template<typename Coordinate>
+void BasicSegmentApproximator<Coordinate>::insertQuadCurve(const FloatPoint& from, const FloatPoint& control, const FloatPoint& to)
 {
     // De Casteljau algorithm.
     const int kNumberOfParts = 16;
@@ -255,7 +309,8 @@ void SegmentApproximator::insertQuadCurve(const FloatPoint& from, const FloatPoi
     } while (points >= buffer);
 }
 
-const bool SegmentApproximator::curveIsLineSegment(FloatPoint points[])
+template<typename Coordinate>
+const bool BasicSegmentApproximator<Coordinate>::curveIsLineSegment(FloatPoint points[])
 {
     const Float x0 = points[0].x;
     const Float y0 = points[0].y;
@@ -294,12 +349,14 @@ const bool SegmentApproximator::curveIsLineSegment(FloatPoint points[])
              || x2 < minX || x2 > maxX || y2 < minY || y2 > maxY);
 }
 
-const bool SegmentApproximator::collinear(const FloatPoint& p0, const FloatPoint& p1, const FloatPoint& p2)
+template<typename Coordinate>
+const bool BasicSegmentApproximator<Coordinate>::collinear(const FloatPoint& p0, const FloatPoint& p1, const FloatPoint& p2)
 {
     return std::fabs((p2.x - p0.x) * (p0.y - p1.y) - (p0.x - p1.x) * (p2.y - p0.y)) <= kTolerance;
 }
 
-const bool SegmentApproximator::curveIsLineSegment(const FloatPoint& p0, const FloatPoint& p1, const FloatPoint& p2)
+template<typename Coordinate>
+const bool BasicSegmentApproximator<Coordinate>::curveIsLineSegment(const FloatPoint& p0, const FloatPoint& p1, const FloatPoint& p2)
 {
     if (!collinear(p0, p1, p2))
         return false;
@@ -325,7 +382,8 @@ const bool SegmentApproximator::curveIsLineSegment(const FloatPoint& p0, const F
     return !(p1.x < minX || p1.x > maxX || p1.y < minY || p1.y > maxY);
 }
 
-void SegmentApproximator::splitCubeCurve(FloatPoint points[])
+template<typename Coordinate>
+void BasicSegmentApproximator<Coordinate>::splitCubeCurve(FloatPoint points[])
 {
     const FloatPoint a = points[0];
     const FloatPoint b = points[1];
@@ -347,7 +405,8 @@ void SegmentApproximator::splitCubeCurve(FloatPoint points[])
     points[6] = d;
 }
 
-void SegmentApproximator::insertBezierCurve(const FloatPoint& from, const FloatPoint& control1, const FloatPoint& control2, const FloatPoint& to)
+template<typename Coordinate>
+void BasicSegmentApproximator<Coordinate>::insertBezierCurve(const FloatPoint& from, const FloatPoint& control1, const FloatPoint& control2, const FloatPoint& to)
 {
     // De Casteljau algorithm.
     const int kNumberOfParts = 16;
@@ -378,7 +437,8 @@ void SegmentApproximator::insertBezierCurve(const FloatPoint& from, const FloatP
     } while (points >= buffer);
 }
 
-const int SegmentApproximator::calculateArcSegments(const Float& angle, const Float& radius)
+template<typename Coordinate>
+const int BasicSegmentApproximator<Coordinate>::calculateArcSegments(const Float& angle, const Float& radius)
 {
     const Float epsilon = kTolerance / radius;
     Float angleSegment;
@@ -393,7 +453,8 @@ const int SegmentApproximator::calculateArcSegments(const Float& angle, const Fl
     return std::ceil(fabs(angle) / angleSegment);
 }
 
-void SegmentApproximator::arcToCurve(FloatPoint result[], const Float& startAngle, const Float& endAngle)
+template<typename Coordinate>
+void BasicSegmentApproximator<Coordinate>::arcToCurve(FloatPoint result[], const Float& startAngle, const Float& endAngle)
 {
     const Float sinStartAngle = std::sin(startAngle);
     const Float cosStartAngle = std::cos(startAngle);
@@ -410,15 +471,18 @@ void SegmentApproximator::arcToCurve(FloatPoint result[], const Float& startAngl
     result[2].y = sinEndAngle;
 }
 
-void SegmentApproximator::insertArc(const FloatPoint& lastEndPoint, const ArcElement* arcElement, const Transform& globalTransform)
+template<typename Coordinate>
+void BasicSegmentApproximator<Coordinate>::insertArc(const FloatPoint& lastEndPoint, const PathElement& arcElement, const Transform& globalTransform)
 {
-    Float startAngle = arcElement->startAngle;
-    const Float endAngle = arcElement->endAngle;
-    const bool antiClockwise = arcElement->counterClockwise;
+    GD_ASSERT(arcElement.arc);
+    const PathArc& arc = *arcElement.arc;
+    Float startAngle = arc.startAngle;
+    const Float endAngle = arc.endAngle;
+    const bool antiClockwise = arc.counterClockwise;
 
     Transform arcTransform = globalTransform;
-    Transform axesTransform = { arcElement->radius.x, 0.0, 0.0, arcElement->radius.y, arcElement->center.x, arcElement->center.y };
-    arcTransform *= arcElement->transform * axesTransform;
+    Transform axesTransform = { arc.radius.x, 0.0, 0.0, arc.radius.y, arc.center.x, arc.center.y };
+    arcTransform *= axesTransform;
 
     FloatPoint startPoint = arcTransform.apply(FloatPoint(std::cos(startAngle), std::sin(startAngle)));
     insertLine(lastEndPoint, startPoint);
@@ -427,7 +491,7 @@ void SegmentApproximator::insertArc(const FloatPoint& lastEndPoint, const ArcEle
 
     const Float deltaAngle = antiClockwise ? startAngle - endAngle : endAngle - startAngle;
 
-    const int segments = calculateArcSegments(deltaAngle, std::max(arcElement->radius.x * 2, arcElement->radius.y * 2));
+    const int segments = calculateArcSegments(deltaAngle, std::max(arc.radius.x * 2, arc.radius.y * 2));
     Float step = deltaAngle / segments;
 
     if (antiClockwise) {
@@ -440,7 +504,7 @@ void SegmentApproximator::insertArc(const FloatPoint& lastEndPoint, const ArcEle
         bezierPoints[0] = arcTransform.apply(bezierPoints[0]);
         bezierPoints[1] = arcTransform.apply(bezierPoints[1]);
         if (i == segments - 1) {
-            bezierPoints[2] = globalTransform.apply(arcElement->to);
+            bezierPoints[2] = globalTransform.apply(arcElement.to());
         } else {
             bezierPoints[2] = arcTransform.apply(bezierPoints[2]);
         }
@@ -449,84 +513,190 @@ void SegmentApproximator::insertArc(const FloatPoint& lastEndPoint, const ArcEle
     }
 }
 
-void SegmentApproximator::printSegments()
+template<typename Coordinate>
+void BasicSegmentApproximator<Coordinate>::printSegments()
 {
-    for (auto& currentSegments : _segments) {
-        SegmentList currentList = *(currentSegments.second);
-        for (Segment& segment : currentList) {
-            std::cout << segment << std::endl;
+    for (const Segment& segment : _edgeTable.segments) {
+        std::cout << segment << std::endl;
+    }
+}
+
+/*!
+ * \brief Split the _segments_ at the sorted _lines_ into the segments of the edge table.
+ *
+ * \internal
+ */
+template<typename Coordinate>
+void BasicSegmentApproximator<Coordinate>::splitSegments(const SegmentList& segments, const std::vector<int>& lines)
+{
+    SegmentList& splitSegments = _edgeTable.segments;
+    splitSegments.clear();
+
+    for (Segment segment : segments) {
+        std::vector<int>::const_iterator line = std::upper_bound(lines.begin(), lines.end(), segment.topY());
+        for (; line != lines.end() && segment.isOnSegment(*line); ++line) {
+            const Segment bottomSegment = segment.splitSegment(*line);
+            splitSegments.push_back(segment);
+            segment = bottomSegment;
         }
+        splitSegments.push_back(segment);
     }
 }
 
-inline void SegmentApproximator::splitSegments()
+/*!
+ * \brief Bucket the segments of the edge table by sub-scanlines and sort the buckets.
+ *
+ * \internal
+ */
+template<typename Coordinate>
+void BasicSegmentApproximator<Coordinate>::sortSegments()
 {
-    for (SegmentTree::iterator currentSegments = _segments.begin(); currentSegments != _segments.end(); ++currentSegments) {
-        SegmentTree::iterator newSegments = currentSegments;
-        ++newSegments;
-        if (newSegments != _segments.end()) {
-            SegmentList* currentList = currentSegments->second;
-            SegmentList* newList = newSegments->second;
-            int splitY = std::floor(newSegments->first);
-            GD_ASSERT(currentList && newList);
-            GD_ASSERT(currentSegments->first < newSegments->first);
+    SegmentList& segments = _edgeTable.segments;
+    if (segments.empty())
+        return;
 
-            for (Segment& segment : *currentList) {
-                if (segment.isOnSegment(splitY)) {
-                    newList->push_front(segment.splitSegment(splitY));
-                }
+    const uint32_t minY = _edgeTable.lines.front();
+    radixSort(segments, _edgeTable.segmentBuffer, [minY](const Segment& segment) { return uint32_t(segment.topY()) - minY; });
+
+    for (typename SegmentList::iterator bucket = segments.begin(); bucket != segments.end();) {
+        typename SegmentList::iterator bucketEnd = bucket;
+        for (const int topY = bucket->topY(); bucketEnd != segments.end() && bucketEnd->topY() == topY; ++bucketEnd);
+        std::stable_sort(bucket, bucketEnd);
+        bucket = bucketEnd;
+    }
+}
+
+/*!
+ * \brief Push the intersection event of the neighbour segments if they cross.
+ *
+ * \internal
+ */
+template<typename Coordinate>
+void BasicSegmentApproximator<Coordinate>::pushIntersection(const size_t begin, const uint32_t left, const uint32_t right)
+{
+    Segment& leftSegment = _edgeTable.segments[begin + left];
+    Segment& rightSegment = _edgeTable.segments[begin + right];
+
+    // The segments span the same sub-scanlines, they cross if their order is reversed at the bottom.
+    if (!(leftSegment.to.x > rightSegment.to.x))
+        return;
+
+    typename EdgeTable::IntersectionEvent event;
+    event.left = left;
+    event.right = right;
+    event.y = NAN;
+    event.isOnSegments = leftSegment.computeIntersectionY(&rightSegment, event.y) && !std::isnan(event.y);
+    if (!event.isOnSegments) {
+        // The rounded intersection is at an end, but the pair needs to be swapped.
+        event.y = leftSegment.from.y;
+    }
+
+    _edgeTable.events.push_back(event);
+    std::push_heap(_edgeTable.events.begin(), _edgeTable.events.end());
+}
+
+/*!
+ * \brief Find the intersections of a bucket of segments with a sweep line.
+ *
+ * The segments of a bucket span the same sub-scanlines and they are sorted
+ * by their top x, so the sweep starts with this order and the only events
+ * are the crossings of the neighbours.  An event swaps the pair and checks
+ * them with their new neighbours, so finding the k intersections of n
+ * segments is O((n + k) log n).  The found sub-scanlines are appended to
+ * the EdgeTable::intersectionLines.
+ *
+ * \internal
+ */
+template<typename Coordinate>
+void BasicSegmentApproximator<Coordinate>::findIntersections(const size_t begin, const size_t end)
+{
+    const uint32_t count = end - begin;
+    if (count < 2)
+        return;
+
+    std::vector<uint32_t>& order = _edgeTable.sweepOrder;
+    std::vector<uint32_t>& positions = _edgeTable.sweepPositions;
+    std::vector<int>& ys = _edgeTable.intersectionLines;
+    order.resize(count);
+    positions.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        order[i] = positions[i] = i;
+    }
+
+    _edgeTable.events.clear();
+    for (uint32_t i = 1; i < count; ++i) {
+        pushIntersection(begin, i - 1, i);
+    }
+
+    while (!_edgeTable.events.empty()) {
+        std::pop_heap(_edgeTable.events.begin(), _edgeTable.events.end());
+        const typename EdgeTable::IntersectionEvent event = _edgeTable.events.back();
+        _edgeTable.events.pop_back();
+
+        // The pair has been separated or swapped by an earlier event.
+        if (positions[event.left] + 1 != positions[event.right])
+            continue;
+
+        if (event.isOnSegments) {
+            const int intersectionY = std::floor(event.y);
+            ys.push_back(intersectionY);
+            if ((Float)intersectionY != event.y) {
+                GD_ASSERT((Float)intersectionY < event.y);
+                ys.push_back(intersectionY + 1);
             }
         }
+
+        const uint32_t position = positions[event.left];
+        order[position] = event.right;
+        order[position + 1] = event.left;
+        positions[event.right] = position;
+        positions[event.left] = position + 1;
+
+        if (position > 0)
+            pushIntersection(begin, order[position - 1], event.right);
+        if (position + 2 < count)
+            pushIntersection(begin, event.left, order[position + 2]);
     }
 }
 
-SegmentList* SegmentApproximator::segments()
+template<typename Coordinate>
+const typename BasicSegmentApproximator<Coordinate>::SegmentList& BasicSegmentApproximator<Coordinate>::segments()
 {
+    SegmentList& segments = _edgeTable.segments;
+
     // Split segments with all y lines.
-    splitSegments();
+    sortLines(_edgeTable.lines, _edgeTable.lineBuffer);
+    splitSegments(_edgeTable.edges, _edgeTable.lines);
+    sortSegments();
 
     // Find all intersection points.
-    std::set<int> ys;
-    for (auto& currentSegments : _segments) {
-        SegmentList* currentList = currentSegments.second;
-        currentList->sort();
-        SegmentList::iterator currentSegment = currentList->begin();
-        for (SegmentList::iterator segment = currentSegment; currentSegment != currentList->end(); ++segment) {
-            if (segment != currentList->end()) {
-                Float y;
-                if (currentSegment->computeIntersectionY(&(*segment), y)) {
-                    const int intersectionY = std::floor(y);
-                    ys.insert(intersectionY);
-                    if ((Float)intersectionY != y) {
-                        GD_ASSERT((Float)intersectionY < y);
-                        ys.insert(intersectionY + 1);
-                    }
-                }
-            } else {
-                segment = ++currentSegment;
-            }
-        }
+    std::vector<int>& ys = _edgeTable.intersectionLines;
+    ys.clear();
+    for (size_t bucket = 0; bucket < segments.size();) {
+        size_t bucketEnd = bucket;
+        for (; bucketEnd < segments.size() && segments[bucketEnd].from.y == segments[bucket].from.y; ++bucketEnd);
+        findIntersections(bucket, bucketEnd);
+        bucket = bucketEnd;
     }
 
-    for (auto y : ys) {
-        insertSegmentList(y);
+    // Split segments with all intersection lines.
+    if (!ys.empty()) {
+        sortLines(ys, _edgeTable.lineBuffer);
+        _edgeTable.edges.swap(segments);
+        splitSegments(_edgeTable.edges, ys);
+        sortSegments();
     }
 
-    // Split segments with all y lines.
-    splitSegments();
-
-    // Merge and sort all segment list.
-    SegmentList* segments = new SegmentList();
-    for (SegmentTree::iterator currentSegments = _segments.begin(); currentSegments != _segments.end(); ++currentSegments) {
-        SegmentList* currentList = currentSegments->second;
-        currentList->sort();
+    // Fix intersection pairs.
+    for (typename SegmentList::iterator bucket = segments.begin(); bucket != segments.end();) {
+        typename SegmentList::iterator bucketEnd = bucket;
+        for (; bucketEnd != segments.end() && bucketEnd->from.y == bucket->from.y; ++bucketEnd);
 
         bool needSorting = false;
-        // Fix intersection pairs.
-        for (SegmentList::iterator segment = currentList->begin(); segment != currentList->end(); ++segment) {
+        for (typename SegmentList::iterator segment = bucket; segment != bucketEnd; ++segment) {
             GD_ASSERT(segment->to.y - segment->from.y >= 1.0);
             if (segment->to.y - segment->from.y == 1.0) {
-                for (SegmentList::iterator furtherSegment = segment; furtherSegment != currentList->end() ; ++furtherSegment) {
+                for (typename SegmentList::iterator furtherSegment = segment; furtherSegment != bucketEnd; ++furtherSegment) {
                     GD_ASSERT(segment->from.y == furtherSegment->from.y);
                     GD_ASSERT(segment->to.y == furtherSegment->to.y);
                     //! \todo(szledan): need to test this assert:
@@ -543,44 +713,55 @@ SegmentList* SegmentApproximator::segments()
             }
         }
         if (needSorting) {
-            --currentSegments;
+            std::stable_sort(bucket, bucketEnd);
         } else {
-            // Merge segment lists.
-            segments->merge(*currentList);
+            bucket = bucketEnd;
         }
     }
 
-    // Return independent segments.
+    // The buckets follow each other, so the segments are sorted.
     return segments;
 }
 
-void SegmentApproximator::insertSegment(const FloatPoint& from, const FloatPoint& to)
+/*!
+ * \brief The inserted segments sorted by their top sub-scanlines.
+ *
+ * The segments are not split, this is the edge table of the scanline walk
+ * of BasicTrapezoidTessellator::spanList().
+ */
+template<typename Coordinate>
+const typename BasicSegmentApproximator<Coordinate>::SegmentList& BasicSegmentApproximator<Coordinate>::edges()
+{
+    SegmentList& edges = _edgeTable.edges;
+    if (!edges.empty()) {
+        const int minY = std::floor(_boundingBox.minY);
+        radixSort(edges, _edgeTable.segmentBuffer, [minY](const Segment& segment) { return uint32_t(segment.topY() - minY); });
+    }
+    return edges;
+}
+
+template<typename Coordinate>
+void BasicSegmentApproximator<Coordinate>::insertSegment(const FloatPoint& from, const FloatPoint& to)
 {
     if (from.y == to.y)
         return;
 
-    Segment segment(from, to);
+    Segment segment(from, to, ++_segmentIds);
 
     // Update bounding-box.
-    _boundingBox.stretch(segment.from);
-    _boundingBox.stretch(segment.to);
+    _boundingBox.stretch(segment.from.toFloatPoint());
+    _boundingBox.stretch(segment.to.toFloatPoint());
 
     // Insert segment.
-    const int topY = segment.topY();
-    const int bottomY = segment.bottomY();
-
-    insertSegmentList(topY)->push_front(segment);
-    insertSegmentList(bottomY);
-}
-
-SegmentList* SegmentApproximator::insertSegmentList(const int y)
-{
-    return _segments[y] ? _segments[y] : _segments[y] = new SegmentList();
+    _edgeTable.edges.push_back(segment);
+    _edgeTable.lines.push_back(segment.topY());
+    _edgeTable.lines.push_back(segment.bottomY());
 }
 
 /* Trapezoid */
 
-const bool Trapezoid::isMergableInTo(const Trapezoid* other) const
+template<typename Coordinate>
+const bool BasicTrapezoid<Coordinate>::isMergableInTo(const BasicTrapezoid* other) const
 {
     GD_ASSERT(this->bottomY == other->topY);
 
@@ -595,7 +776,8 @@ const bool Trapezoid::isMergableInTo(const Trapezoid* other) const
     return false;
 }
 
-bool operator<(const Trapezoid& lhs, const Trapezoid& rhs)
+template<typename Coordinate>
+bool operator<(const BasicTrapezoid<Coordinate>& lhs, const BasicTrapezoid<Coordinate>& rhs)
 {
     if (lhs.topY < rhs.topY)
         return true;
@@ -613,75 +795,78 @@ bool operator<(const Trapezoid& lhs, const Trapezoid& rhs)
     return false;
 }
 
-bool operator==(const Trapezoid& lhs, const Trapezoid& rhs)
+template<typename Coordinate>
+bool operator==(const BasicTrapezoid<Coordinate>& lhs, const BasicTrapezoid<Coordinate>& rhs)
 {
     return lhs.topY == rhs.topY && lhs.topLeftX == rhs.topLeftX && lhs.topRightX == rhs.topRightX
             && lhs.bottomY == rhs.bottomY && lhs.bottomLeftX == rhs.bottomLeftX &&  lhs.bottomRightX == rhs.bottomRightX;
 }
 
-bool operator<=(const Trapezoid& lhs, const Trapezoid& rhs)
+template<typename Coordinate>
+bool operator<=(const BasicTrapezoid<Coordinate>& lhs, const BasicTrapezoid<Coordinate>& rhs)
 {
     return lhs < rhs || lhs == rhs;
 }
 
 /* TrapezoidTessellator */
 
-TrapezoidTessellator::TrapezoidTessellator(PathData& pathData, FillRule fillRule, int antiAliasingLevel)
+template<typename Coordinate>
+BasicTrapezoidTessellator<Coordinate>::BasicTrapezoidTessellator(PathData& pathData, FillRule fillRule, int antiAliasingLevel, BasicEdgeTable<Coordinate>* edgeTable)
     : _pathData(pathData)
     , _fillRule(fillRule)
     , _antiAliasingLevel(antiAliasingLevel)
+    , _edgeTable(edgeTable)
 {
 }
 
-const TrapezoidList TrapezoidTessellator::trapezoidList(const GepardState& state)
+/*!
+ * \brief Insert the elements of the path into the _segmentApproximator_.
+ *
+ * \internal
+ */
+template<typename Coordinate>
+void BasicTrapezoidTessellator<Coordinate>::insertPath(BasicSegmentApproximator<Coordinate>& segmentApproximator)
 {
-    PathElement* element = _pathData.firstElement();
-
-    if (!element || !element->next)
-        return TrapezoidList();
+    PathIterator it = _pathData.begin();
+    const PathIterator end = _pathData.end();
 
-    GD_ASSERT(element->type == PathElementTypes::MoveTo);
+    GD_ASSERT((*it).isMoveTo());
 
-    const Float subPixelPrecision = 1.0;
-    SegmentApproximator segmentApproximator(_antiAliasingLevel, subPixelPrecision);
+    // The points are transformed to the device space here, once.
     FloatPoint from;
-    FloatPoint to = element->to;
+    FloatPoint to = (*it).transform->apply((*it).to());
     FloatPoint lastMoveTo = to;
-    Transform at = state.transform;
 
-    // 1. Insert path elements.
-    do {
+    for (++it; it != end; ++it) {
+        const PathElement element = *it;
+        const Transform& at = *element.transform;
         from = to;
-        element = element->next;
-        to = element->to;
-        switch (element->type) {
+        to = at.apply(element.to());
+        switch (element.type) {
         case PathElementTypes::MoveTo: {
-            segmentApproximator.insertLine(at.apply(from), at.apply(lastMoveTo));
+            segmentApproximator.insertLine(from, lastMoveTo);
             lastMoveTo = to;
             break;
         }
         case PathElementTypes::LineTo: {
-            segmentApproximator.insertLine(at.apply(from), at.apply(to));
+            segmentApproximator.insertLine(from, to);
             break;
         }
         case PathElementTypes::CloseSubpath: {
-            segmentApproximator.insertLine(at.apply(from), at.apply(lastMoveTo));
+            segmentApproximator.insertLine(from, lastMoveTo);
             lastMoveTo = to;
             break;
         }
         case PathElementTypes::QuadraticCurve: {
-            QuadraticCurveToElement* qe = reinterpret_cast<QuadraticCurveToElement*>(element);
-            segmentApproximator.insertQuadCurve(at.apply(from), at.apply(qe->control), at.apply(to));
+            segmentApproximator.insertQuadCurve(from, at.apply(element.control()), to);
             break;
         }
         case PathElementTypes::BezierCurve: {
-            BezierCurveToElement* be = reinterpret_cast<BezierCurveToElement*>(element);
-            segmentApproximator.insertBezierCurve(at.apply(from), at.apply(be->control1), at.apply(be->control2), at.apply(to));
+            segmentApproximator.insertBezierCurve(from, at.apply(element.control1()), at.apply(element.control2()), to);
             break;
         }
         case PathElementTypes::Arc: {
-            ArcElement* ae = reinterpret_cast<ArcElement*>(element);
-            segmentApproximator.insertArc(at.apply(from), ae, at);
+            segmentApproximator.insertArc(from, element, at);
             break;
         }
         case PathElementTypes::Undefined:
@@ -689,96 +874,321 @@ const TrapezoidList TrapezoidTessellator::trapezoidList(const GepardState& state
             // unreachable
             break;
         }
-    } while (element->next != nullptr);
+    }
+
+    segmentApproximator.insertLine(to, lastMoveTo);
+
+    //! \todo(szledan): check the boundingBox calculation:
+    // NOTE:  maxX = (maxX + (_antiAliasingLevel - 1)) / _antiAliasingLevel;
+    _boundingBox.minX = (fixPrecision(segmentApproximator.boundingBox().minX) / _antiAliasingLevel);
+    _boundingBox.minY = (fixPrecision(segmentApproximator.boundingBox().minY) / _antiAliasingLevel);
+    _boundingBox.maxX = (fixPrecision(segmentApproximator.boundingBox().maxX) / _antiAliasingLevel);
+    _boundingBox.maxY = (fixPrecision(segmentApproximator.boundingBox().maxY) / _antiAliasingLevel);
+}
+
+static inline size_t hashCombine(const size_t seed, const Float value)
+{
+    return seed ^ (std::hash<Float>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+/*!
+ * \brief The horizontal edge of a trapezoid, the key of the vertical merge.
+ *
+ * \internal
+ */
+template<typename Coordinate>
+struct TrapezoidEdge {
+    TrapezoidEdge(const Coordinate y, const Coordinate leftX, const Coordinate rightX)
+        : y(y), leftX(leftX), rightX(rightX)
+    {
+    }
+
+    bool operator==(const TrapezoidEdge& other) const
+    {
+        return y == other.y && leftX == other.leftX && rightX == other.rightX;
+    }
+
+    const size_t hash() const
+    {
+        return hashCombine(hashCombine(hashCombine(0, y), leftX), rightX);
+    }
+
+    Coordinate y;
+    Coordinate leftX;
+    Coordinate rightX;
+};
+
+/*!
+ * \brief The left or right side of a trapezoid, the key of the horizontal merge.
+ *
+ * \internal
+ */
+template<typename Coordinate>
+struct TrapezoidSide {
+    TrapezoidSide(const Coordinate topY, const Coordinate bottomY, const Coordinate topX, const Coordinate bottomX)
+        : topY(topY), bottomY(bottomY), topX(topX), bottomX(bottomX)
+    {
+    }
+
+    bool operator==(const TrapezoidSide& other) const
+    {
+        return topY == other.topY && bottomY == other.bottomY && topX == other.topX && bottomX == other.bottomX;
+    }
+
+    const size_t hash() const
+    {
+        return hashCombine(hashCombine(hashCombine(hashCombine(0, topY), bottomY), topX), bottomX);
+    }
+
+    Coordinate topY;
+    Coordinate bottomY;
+    Coordinate topX;
+    Coordinate bottomX;
+};
 
-    segmentApproximator.insertLine(at.apply(element->to), at.apply(lastMoveTo));
+template<typename Key>
+struct TrapezoidKeyHash {
+    size_t operator()(const Key& key) const { return key.hash(); }
+};
+
+template<typename Coordinate>
+const typename BasicTrapezoidTessellator<Coordinate>::TrapezoidList BasicTrapezoidTessellator<Coordinate>::trapezoidList()
+{
+    if (_pathData.elementCount() < 2)
+        return TrapezoidList();
+
+    const Float subPixelPrecision = 1.0;
+    BasicSegmentApproximator<Coordinate> segmentApproximator(_antiAliasingLevel, subPixelPrecision, _edgeTable);
+
+    // 1. Insert path elements.
+    insertPath(segmentApproximator);
 
     // 2. Use approximator to generate the list of segments.
-    SegmentList* segmentList = segmentApproximator.segments();
-    TrapezoidList trapezoids;
+    const BasicSegmentList<Coordinate>& segmentList = segmentApproximator.segments();
 
     // 3. Generate trapezoids.
-    const Float denom = _antiAliasingLevel * 1 + 0;
-    if (segmentList) {
-        Trapezoid trapezoid;
-        int fill = 0;
-        bool isInFill = false;
-        for (Segment& segment : *segmentList) {
-            if (segment.from.y == segment.to.y)
-                continue;
-            if (fillRule() == EvenOdd) {
-                fill = !fill;
-            } else {
-                fill += segment.direction;
-            }
+    const Float denom = _antiAliasingLevel;
+    std::vector<Trapezoid> trapezoids;
+    Trapezoid trapezoid;
+    int fill = 0;
+    bool isInFill = false;
+    for (const BasicSegment<Coordinate>& segment : segmentList) {
+        if (segment.from.y == segment.to.y)
+            continue;
+        if (fillRule() == EvenOdd) {
+            fill = !fill;
+        } else {
+            fill += segment.direction;
+        }
 
-            if (fill) {
-                if (!isInFill) {
-                    trapezoid.topY = (fixPrecision(segment.topY() / denom));
-                    trapezoid.bottomY = (fixPrecision(segment.bottomY() / denom));
-                    trapezoid.topLeftX = (fixPrecision(segment.from.x) / denom);
-                    trapezoid.bottomLeftX = (fixPrecision(segment.to.x) / denom);
-                    trapezoid.leftId = segment.id;
-                    trapezoid.leftSlope = segment.realSlope;
-                    if (trapezoid.topY != trapezoid.bottomY)
-                        isInFill = true;
-                }
-            } else {
-                // TODO: Horizontal merge trapezoids.
-                trapezoid.topRightX = (fixPrecision(segment.from.x) / denom);
-                trapezoid.bottomRightX = (fixPrecision(segment.to.x) / denom);
-                trapezoid.rightId = segment.id;
-                trapezoid.rightSlope = segment.realSlope;
-                if (trapezoid.topY != trapezoid.bottomY) {
-                    trapezoids.push_back(trapezoid);
-                }
-                isInFill = false;
+        if (fill) {
+            if (!isInFill) {
+                trapezoid.topY = (fixPrecision(segment.topY() / denom));
+                trapezoid.bottomY = (fixPrecision(segment.bottomY() / denom));
+                trapezoid.topLeftX = (fixPrecision(segment.from.x) / denom);
+                trapezoid.bottomLeftX = (fixPrecision(segment.to.x) / denom);
+                trapezoid.leftId = segment.id;
+                trapezoid.leftSlope = segment.realSlope;
+                if (trapezoid.topY != trapezoid.bottomY)
+                    isInFill = true;
             }
-            //! \todo(szledan): we need this assert in the future,
-            //! but the TT doesn't work correctly now with that.
-            // GD_ASSERT(trapezoid.topY == (fixPrecision(segment.topY() / denom)));
+        } else {
+            trapezoid.topRightX = (fixPrecision(segment.from.x) / denom);
+            trapezoid.bottomRightX = (fixPrecision(segment.to.x) / denom);
+            trapezoid.rightId = segment.id;
+            trapezoid.rightSlope = segment.realSlope;
+            if (trapezoid.topY != trapezoid.bottomY) {
+                trapezoids.push_back(trapezoid);
+            }
+            isInFill = false;
         }
+        //! \todo(szledan): we need this assert in the future,
+        //! but the TT doesn't work correctly now with that.
+        // GD_ASSERT(trapezoid.topY == (fixPrecision(segment.topY() / denom)));
+    }
 
-        delete segmentList;
+    // 4. Vertical merge trapezoids.
+    // The segments are sorted by their tops, so the trapezoids are generated
+    // top-down and each one can continue the trapezoid which ends on its top.
+    TrapezoidList trapezoidList;
+    std::unordered_map<TrapezoidEdge<Coordinate>, Trapezoid*, TrapezoidKeyHash<TrapezoidEdge<Coordinate>>> bottomEdges;
+    bottomEdges.reserve(trapezoids.size());
+    for (const Trapezoid& current : trapezoids) {
+        GD_ASSERT(current.leftId != 0 && current.rightId != 0);
+        GD_ASSERT(current.leftSlope != NAN && current.rightSlope != NAN);
+
+        const auto upper = bottomEdges.find(TrapezoidEdge<Coordinate>(current.topY, current.topLeftX, current.topRightX));
+        Trapezoid* merged = nullptr;
+        if (upper != bottomEdges.end() && upper->second->isMergableInTo(&current)) {
+            merged = upper->second;
+            merged->bottomY = current.bottomY;
+            merged->bottomLeftX = current.bottomLeftX;
+            merged->bottomRightX = current.bottomRightX;
+            merged->leftId = current.leftId;
+            merged->rightId = current.rightId;
+            merged->leftSlope = current.leftSlope;
+            merged->rightSlope = current.rightSlope;
+            bottomEdges.erase(upper);
+        } else {
+            trapezoidList.push_back(current);
+            merged = &trapezoidList.back();
+        }
+        bottomEdges[TrapezoidEdge<Coordinate>(merged->bottomY, merged->bottomLeftX, merged->bottomRightX)] = merged;
+    }
 
-        //! \todo(szledan): check the boundingBox calculation:
-        // NOTE:  maxX = (maxX + (_antiAliasingLevel - 1)) / _antiAliasingLevel;
-        _boundingBox.minX = (fixPrecision(segmentApproximator.boundingBox().minX) / _antiAliasingLevel);
-        _boundingBox.minY = (fixPrecision(segmentApproximator.boundingBox().minY) / _antiAliasingLevel);
-        _boundingBox.maxX = (fixPrecision(segmentApproximator.boundingBox().maxX) / _antiAliasingLevel);
-        _boundingBox.maxY = (fixPrecision(segmentApproximator.boundingBox().maxY) / _antiAliasingLevel);
+    // 5. Horizontal merge trapezoids.
+    // The neighbours which share a whole side are merged after the vertical
+    // merge, because merging the pieces earlier would break the vertical
+    // merges of the other pieces, e.g. in the fans of the stroke joins.
+    std::unordered_map<TrapezoidSide<Coordinate>, Trapezoid*, TrapezoidKeyHash<TrapezoidSide<Coordinate>>> rightSides;
+    rightSides.reserve(trapezoidList.size());
+    for (typename TrapezoidList::iterator current = trapezoidList.begin(); current != trapezoidList.end();) {
+        const auto left = rightSides.find(TrapezoidSide<Coordinate>(current->topY, current->bottomY, current->topLeftX, current->bottomLeftX));
+        Trapezoid* merged = nullptr;
+        if (left != rightSides.end()) {
+            merged = left->second;
+            merged->topRightX = current->topRightX;
+            merged->bottomRightX = current->bottomRightX;
+            merged->rightId = current->rightId;
+            merged->rightSlope = current->rightSlope;
+            rightSides.erase(left);
+            current = trapezoidList.erase(current);
+        } else {
+            merged = &*current++;
+        }
+        rightSides[TrapezoidSide<Coordinate>(merged->topY, merged->bottomY, merged->topRightX, merged->bottomRightX)] = merged;
     }
 
-    trapezoids.sort();
+    return trapezoidList;
+}
 
-    // 4. Vertical merge trapezoids.
-    //! \todo(szledan): use MovePtr:
-    TrapezoidList trapezoidList;
-    for (TrapezoidList::iterator current = trapezoids.begin(); current != trapezoids.end(); ++current) {
-        const Float bottomY = current->bottomY;
-        TrapezoidList::iterator ft = current;
-        for (; (ft != trapezoids.end() && ft->bottomY == bottomY); ++ft);
-
-        GD_ASSERT(current->leftId != 0 && current->rightId != 0);
-        GD_ASSERT(current->leftSlope != NAN && current->rightSlope != NAN);
-        for (TrapezoidList::iterator further = current; (further != trapezoids.end() && further->topY <= bottomY); ++further) {
-            GD_ASSERT(further->leftId != 0 && further->rightId != 0);
-            GD_ASSERT(further->leftSlope != NAN && further->rightSlope != NAN);
-            if (further->topY == current->bottomY && current->isMergableInTo(&*further)) {
-                further->topY = current->topY;
-                further->topLeftX = current->topLeftX;
-                further->topRightX = current->topRightX;
-                current->leftId = 0;
-                current->rightId = 0;
-                break;
+/*!
+ * \brief Generate the filled spans of the sub-scanlines.
+ *
+ * The spans are generated by an active edge table walk: the edges which
+ * cross a sub-scanline are sampled in its middle, sorted by x, and the
+ * fill rule is applied from left to right.  The edges are not split at the
+ * intersections and no trapezoids are built, so this is the cheaper output
+ * for the backends which rasterize on the CPU.  The spans are ordered by
+ * y, then by x.
+ *
+ * Only the sub-scanlines in the [_clipTopY_, _clipBottomY_) range are
+ * walked, so the cost doesn't depend on the parts of the path which are
+ * outside of the surface.
+ */
+template<typename Coordinate>
+const typename BasicTrapezoidTessellator<Coordinate>::SpanList BasicTrapezoidTessellator<Coordinate>::spanList(const int clipTopY, const int clipBottomY)
+{
+    SpanList spans;
+    if (_pathData.elementCount() < 2)
+        return spans;
+
+    const Float subPixelPrecision = 1.0;
+    BasicSegmentApproximator<Coordinate> segmentApproximator(_antiAliasingLevel, subPixelPrecision, _edgeTable);
+
+    // 1. Insert path elements.
+    insertPath(segmentApproximator);
+
+    // 2. Walk the sub-scanlines with the active edges.
+    struct ActiveEdge {
+        Float x; //!< In the middle of the current sub-scanline.
+        Float dx;
+        int bottom;
+        int direction;
+    };
+
+    const BasicSegmentList<Coordinate>& edges = segmentApproximator.edges();
+    const Float denom = _antiAliasingLevel;
+    std::vector<ActiveEdge> activeEdges;
+    // Most of the sub-scanlines have one span.
+    const Float visibleTopY = std::max(Float(std::floor(_boundingBox.minY * denom)), Float(clipTopY));
+    const Float visibleBottomY = std::min(Float(std::ceil(_boundingBox.maxY * denom)), Float(clipBottomY));
+    if (visibleTopY < visibleBottomY)
+        spans.reserve(size_t(visibleBottomY - visibleTopY) + 1);
+    const bool isEvenOdd = fillRule() == EvenOdd;
+    size_t next = 0;
+    int nextTopY = edges.empty() ? 0 : edges.front().topY();
+    int y = nextTopY;
+
+    while (next < edges.size() || !activeEdges.empty()) {
+        // Skip the empty sub-scanlines.
+        if (activeEdges.empty())
+            y = std::max(nextTopY, clipTopY);
+        if (y >= clipBottomY)
+            break;
+
+        // The edges above the clip start at the first visible sub-scanline.
+        for (; next < edges.size() && nextTopY <= y;) {
+            const BasicSegment<Coordinate>& edge = edges[next];
+            if (edge.bottomY() > y) {
+                ActiveEdge activeEdge;
+                activeEdge.dx = edge.slopeInv();
+                activeEdge.x = edge.from.x + (Float(y - nextTopY) + 0.5) * activeEdge.dx;
+                activeEdge.bottom = edge.bottomY();
+                activeEdge.direction = edge.direction;
+                activeEdges.push_back(activeEdge);
+            }
+            if (++next < edges.size())
+                nextTopY = edges[next].topY();
+        }
+
+        // The order of the edges changes only at the crossings, so the insertion sort is cheap.
+        const size_t activeCount = activeEdges.size();
+        ActiveEdge* active = activeEdges.data();
+        for (size_t i = 1; i < activeCount; ++i) {
+            if (active[i - 1].x <= active[i].x)
+                continue;
+            const ActiveEdge activeEdge = active[i];
+            size_t j = i;
+            for (; j > 0 && active[j - 1].x > activeEdge.x; --j) {
+                active[j] = active[j - 1];
+            }
+            active[j] = activeEdge;
+        }
+
+        int fill = 0;
+        Float left = 0;
+        for (size_t i = 0; i < activeCount; ++i) {
+            const int previousFill = fill;
+            fill = isEvenOdd ? !fill : fill + active[i].direction;
+
+            if (!previousFill) {
+                left = active[i].x;
+            } else if (!fill && left < active[i].x) {
+                Span span;
+                span.y = y;
+                span.left = left / denom;
+                span.right = active[i].x / denom;
+                spans.push_back(span);
             }
         }
-        if (current->leftId) {
-            trapezoidList.push_back(*current);
+
+        // Step to the next sub-scanline.
+        ++y;
+        size_t count = 0;
+        for (size_t i = 0; i < activeCount; ++i) {
+            if (active[i].bottom > y) {
+                active[count] = active[i];
+                active[count++].x += active[i].dx;
+            }
         }
+        activeEdges.resize(count);
     }
 
-    return trapezoidList;
+    return spans;
 }
 
+template struct BasicSegment<Float>;
+template struct BasicSegment<float>;
+template struct BasicSegment<Fixed>;
+template class BasicSegmentApproximator<Float>;
+template class BasicSegmentApproximator<float>;
+template class BasicSegmentApproximator<Fixed>;
+template struct BasicTrapezoid<Float>;
+template struct BasicTrapezoid<float>;
+template struct BasicTrapezoid<Fixed>;
+template class BasicTrapezoidTessellator<Float>;
+template class BasicTrapezoidTessellator<float>;
+template class BasicTrapezoidTessellator<Fixed>;
+
 } // namespace gepard
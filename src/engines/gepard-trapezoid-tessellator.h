@@ -32,28 +32,106 @@
 
 #include "gepard-bounding-box.h"
 #include "gepard-defs.h"
+#include "gepard-fixed.h"
 #include "gepard-float-point.h"
 #include "gepard-float.h"
 #include "gepard-line-types.h"
 #include "gepard-path.h"
 #include "gepard-state.h"
+#include <limits>
 #include <list>
-#include <map>
+#include <vector>
 
 namespace gepard {
 
 #define GD_ANTIALIAS_LEVEL 16
 
+/*!
+ * \brief The number type of the segments and trapezoids of the tessellator.
+ *
+ * It is selected by the GEOMETRY build option: Float (default), float or
+ * 24.8 Fixed.  The computations are done in Float in every case, only the
+ * stored coordinates are rounded to the selected type.
+ *
+ * \internal
+ */
+#if defined(GD_GEOMETRY_FIXED)
+typedef Fixed GeometryCoordinate;
+#elif defined(GD_GEOMETRY_FLOAT)
+typedef float GeometryCoordinate;
+#else
+typedef Float GeometryCoordinate;
+#endif
+
+/*!
+ * \brief The types which are stored with the coordinates.
+ *
+ * The slopes can be infinite, so the Fixed coordinates use float slopes.
+ *
+ * \internal
+ */
+template<typename Coordinate>
+struct GeometryTraits {
+    typedef Coordinate Slope;
+};
+
+template<>
+struct GeometryTraits<Fixed> {
+    typedef float Slope;
+};
+
+/* SegmentPoint */
+
+template<typename Coordinate>
+struct SegmentPoint {
+    SegmentPoint() : x(0), y(0) {}
+    SegmentPoint(const Float x_, const Float y_) : x(x_), y(y_) {}
+    SegmentPoint(const FloatPoint& p) : x(p.x), y(p.y) {}
+
+    const FloatPoint toFloatPoint() const { return FloatPoint(x, y); }
+
+    Coordinate x;
+    Coordinate y;
+};
+
+template<typename Coordinate>
+inline std::ostream& operator<<(std::ostream& os, const SegmentPoint<Coordinate>& p)
+{
+    return os << p.x << "," << p.y;
+}
+
+template<typename Coordinate>
+inline bool operator==(const SegmentPoint<Coordinate>& a, const SegmentPoint<Coordinate>& b)
+{
+    return Float(a.x) == Float(b.x) && Float(a.y) == Float(b.y);
+}
+
+template<typename Coordinate>
+inline bool operator<(const SegmentPoint<Coordinate>& lhs, const SegmentPoint<Coordinate>& rhs)
+{
+    return (Float(lhs.y) < Float(rhs.y)) || (Float(lhs.y) == Float(rhs.y) && Float(lhs.x) < Float(rhs.x));
+}
+
+template<typename Coordinate>
+inline bool operator<=(const SegmentPoint<Coordinate>& lhs, const SegmentPoint<Coordinate>& rhs)
+{
+    return lhs < rhs || lhs == rhs;
+}
+
 /* Segment */
 
-struct Segment {
+template<typename Coordinate>
+struct BasicSegment {
+    typedef SegmentPoint<Coordinate> Point;
+    typedef typename GeometryTraits<Coordinate>::Slope Slope;
+
     enum {
         Negative = -1,
         EqualOrNonExist = 0,
         Positive = 1,
     };
 
-    Segment(FloatPoint from, FloatPoint to, unsigned sameId = 0, Float slope = NAN);
+    BasicSegment(Point from, Point to, unsigned id = 0, Float slope = NAN);
 
     const int topY() const;
     const int bottomY() const;
@@ -61,43 +139,101 @@ struct Segment {
     const Float factor() const;
     const bool isOnSegment(const Float y) const;
 
-    const Segment splitSegment(const Float y);
-    const bool computeIntersectionY(Segment* segment, Float& y) const;
+    const BasicSegment splitSegment(const Float y);
+    const bool computeIntersectionY(BasicSegment* segment, Float& y) const;
 
-    FloatPoint from;
-    FloatPoint to;
-    Float id;
-    Float realSlope;
+    Point from;
+    Point to;
+    unsigned id;
+    Slope realSlope;
     int direction;
 };
 
-inline std::ostream& operator<<(std::ostream& os, const Segment& s);
+template<typename Coordinate>
+inline std::ostream& operator<<(std::ostream& os, const BasicSegment<Coordinate>& s)
+{
+    return os << s.from << ((s.direction < 0) ? "<" : ((s.direction > 0) ? ">" : "=")) << s.to;
+}
+
+template<typename Coordinate>
+inline bool operator<(const BasicSegment<Coordinate>& lhs, const BasicSegment<Coordinate>& rhs);
+template<typename Coordinate>
+inline bool operator==(const BasicSegment<Coordinate>& lhs, const BasicSegment<Coordinate>& rhs);
+template<typename Coordinate>
+inline bool operator<=(const BasicSegment<Coordinate>& lhs, const BasicSegment<Coordinate>& rhs);
+
+/* SegmentList */
 
-inline bool operator<(const Segment& lhs, const Segment& rhs);
-inline bool operator==(const Segment& lhs, const Segment& rhs);
-inline bool operator<=(const Segment& lhs, const Segment& rhs);
+template<typename Coordinate>
+using BasicSegmentList = std::vector<BasicSegment<Coordinate>>;
 
-/* SegmentList, SegmentTree */
+/* EdgeTable */
+
+/*!
+ * \brief Contiguous storage of the segments of a SegmentApproximator.
+ *
+ * The vectors keep their capacity when the table is cleared, so a table
+ * which is reused by the fills of a context doesn't allocate once it has
+ * grown to the size of the paths, see GepardContext::edgeTable.
+ *
+ * \internal
+ */
+template<typename Coordinate>
+struct BasicEdgeTable {
+    /*!
+     * \brief A crossing of neighbour segments, see SegmentApproximator::findIntersections().
+     *
+     * \internal
+     */
+    struct IntersectionEvent {
+        //! The heap of the events has the smallest y on the top.
+        bool operator<(const IntersectionEvent& other) const { return y > other.y; }
+
+        Float y;
+        uint32_t left;
+        uint32_t right;
+        bool isOnSegments;
+    };
 
-typedef std::list<Segment> SegmentList;
-typedef std::map<const int, SegmentList*> SegmentTree;
+    void clear()
+    {
+        edges.clear();
+        lines.clear();
+        intersectionLines.clear();
+        segments.clear();
+    }
+
+    BasicSegmentList<Coordinate> edges; //!< The inserted segments.
+    std::vector<int> lines; //!< The sub-scanlines where the segments are split.
+    std::vector<int> intersectionLines; //!< The sub-scanlines of the intersections.
+    BasicSegmentList<Coordinate> segments; //!< The split segments ordered by sub-scanlines, see segments().
+    BasicSegmentList<Coordinate> segmentBuffer; //!< Scratch space of the sorts.
+    std::vector<int> lineBuffer;
+    std::vector<uint32_t> sweepOrder; //!< The segments of a bucket ordered by x at the sweep line.
+    std::vector<uint32_t> sweepPositions; //!< The inverse of the sweepOrder.
+    std::vector<IntersectionEvent> events; //!< Heap of the crossings, see findIntersections().
+};
 
 /* SegmentApproximator */
 
-class SegmentApproximator {
+template<typename Coordinate>
+class BasicSegmentApproximator {
 public:
-    SegmentApproximator(const int antiAliasLevel = GD_ANTIALIAS_LEVEL, const Float factor = 1.0);
-    ~SegmentApproximator();
+    typedef BasicSegment<Coordinate> Segment;
+    typedef BasicSegmentList<Coordinate> SegmentList;
+    typedef BasicEdgeTable<Coordinate> EdgeTable;
+
+    BasicSegmentApproximator(const int antiAliasLevel = GD_ANTIALIAS_LEVEL, const Float factor = 1.0, EdgeTable* edgeTable = nullptr);
 
     void insertLine(const FloatPoint& from, const FloatPoint& to);
     void insertQuadCurve(const FloatPoint& from, const FloatPoint& control, const FloatPoint& to);
     void insertBezierCurve(const FloatPoint& from, const FloatPoint& control1, const FloatPoint& control2, const FloatPoint& to);
-    void insertArc(const FloatPoint& lastEndPoint, const ArcElement* arcElement, const Transform& transform);
+    void insertArc(const FloatPoint& lastEndPoint, const PathElement& arcElement, const Transform& transform);
 
-    SegmentList* segments();
+    const SegmentList& segments();
+    const SegmentList& edges();
     const BoundingBox boundingBox() const { return _boundingBox; }
 
-    inline void splitSegments();
     void printSegments();
 
     const bool quadCurveIsLineSegment(FloatPoint[]);
@@ -116,68 +252,131 @@ public:
     const Float kTolerance;
 private:
     void insertSegment(const FloatPoint& from, const FloatPoint& to);
-    SegmentList* insertSegmentList(const int y);
+    void splitSegments(const SegmentList& segments, const std::vector<int>& lines);
+    void sortSegments();
+    void findIntersections(const size_t begin, const size_t end);
+    void pushIntersection(const size_t begin, const uint32_t left, const uint32_t right);
 
-    SegmentTree _segments;
+    EdgeTable _ownEdgeTable;
+    EdgeTable& _edgeTable;
 
     BoundingBox _boundingBox;
+    unsigned _segmentIds; //!< The last id, the segments of a path are numbered from 1.
 };
 
 /* Trapezoid */
 
-struct Trapezoid {
-    const bool isMergableInTo(const Trapezoid* other) const;
+template<typename Coordinate>
+struct BasicTrapezoid {
+    typedef typename GeometryTraits<Coordinate>::Slope Slope;
 
-    Float topY;
-    Float topLeftX;
-    Float topRightX;
-    Float bottomY;
-    Float bottomLeftX;
-    Float bottomRightX;
+    const bool isMergableInTo(const BasicTrapezoid* other) const;
+
+    Coordinate topY;
+    Coordinate topLeftX;
+    Coordinate topRightX;
+    Coordinate bottomY;
+    Coordinate bottomLeftX;
+    Coordinate bottomRightX;
 
     unsigned leftId;
     unsigned rightId;
-    Float leftSlope;
-    Float rightSlope;
+    Slope leftSlope;
+    Slope rightSlope;
 };
 
-inline std::ostream& operator<<(std::ostream& os, const Trapezoid& t)
+template<typename Coordinate>
+inline std::ostream& operator<<(std::ostream& os, const BasicTrapezoid<Coordinate>& t)
 {
     return os << t.topY << "," << t.topLeftX << "," << t.topRightX << "," << t.bottomY << "," << t.bottomLeftX << "," << t.bottomRightX;
 }
 
-inline bool operator<(const Trapezoid& lhs, const Trapezoid& rhs);
-inline bool operator==(const Trapezoid& lhs, const Trapezoid& rhs);
-inline bool operator<=(const Trapezoid& lhs, const Trapezoid& rhs);
+template<typename Coordinate>
+inline bool operator<(const BasicTrapezoid<Coordinate>& lhs, const BasicTrapezoid<Coordinate>& rhs);
+template<typename Coordinate>
+inline bool operator==(const BasicTrapezoid<Coordinate>& lhs, const BasicTrapezoid<Coordinate>& rhs);
+template<typename Coordinate>
+inline bool operator<=(const BasicTrapezoid<Coordinate>& lhs, const BasicTrapezoid<Coordinate>& rhs);
 
 /* TrapezoidList */
 
-typedef std::list<Trapezoid> TrapezoidList;
+template<typename Coordinate>
+using BasicTrapezoidList = std::list<BasicTrapezoid<Coordinate>>;
+
+/* Span */
+
+/*!
+ * \brief A filled [left, right) range of a sub-scanline.
+ *
+ * The x values are pixels, the y is the index of the sub-scanline: the
+ * span is sampled in the middle of the y / antiAliasingLevel pixel row's
+ * y % antiAliasingLevel sub-scanline.
+ *
+ * \internal
+ */
+template<typename Coordinate>
+struct BasicSpan {
+    int y;
+    Coordinate left;
+    Coordinate right;
+};
+
+/* SpanList */
+
+template<typename Coordinate>
+using BasicSpanList = std::vector<BasicSpan<Coordinate>>;
 
 /* TrapezoidTessellator */
 
-class TrapezoidTessellator {
-public:
+/*!
+ * \brief The fill rules of every BasicTrapezoidTessellator.
+ *
+ * \internal
+ */
+struct TrapezoidFillRule {
     enum FillRule {
         EvenOdd,
         NonZero,
     };
+};
 
-    TrapezoidTessellator(PathData&, FillRule = NonZero, int antiAliasingLevel = GD_ANTIALIAS_LEVEL);
+template<typename Coordinate>
+class BasicTrapezoidTessellator : public TrapezoidFillRule {
+public:
+    typedef BasicTrapezoid<Coordinate> Trapezoid;
+    typedef BasicTrapezoidList<Coordinate> TrapezoidList;
+    typedef BasicSpan<Coordinate> Span;
+    typedef BasicSpanList<Coordinate> SpanList;
+
+    BasicTrapezoidTessellator(PathData&, FillRule = NonZero, int antiAliasingLevel = GD_ANTIALIAS_LEVEL, BasicEdgeTable<Coordinate>* edgeTable = nullptr);
 
     const FillRule fillRule() const { return _fillRule; }
-    const TrapezoidList trapezoidList(const GepardState& state);
+    const TrapezoidList trapezoidList();
+    const SpanList spanList(const int clipTopY = std::numeric_limits<int>::min(), const int clipBottomY = std::numeric_limits<int>::max());
     const BoundingBox boundingBox() const { return _boundingBox; }
     const int antiAliasingLevel() const { return _antiAliasingLevel; }
 
 private:
+    void insertPath(BasicSegmentApproximator<Coordinate>&);
+
     PathData& _pathData;
     const FillRule _fillRule;
     const int _antiAliasingLevel;
+    BasicEdgeTable<Coordinate>* _edgeTable;
 
     BoundingBox _boundingBox;
 };
 
+typedef BasicSegment<GeometryCoordinate> Segment;
+typedef BasicSegmentList<GeometryCoordinate> SegmentList;
+typedef BasicEdgeTable<GeometryCoordinate> EdgeTable;
+typedef BasicSegmentApproximator<GeometryCoordinate> SegmentApproximator;
+typedef BasicTrapezoid<GeometryCoordinate> Trapezoid;
+typedef BasicTrapezoidList<GeometryCoordinate> TrapezoidList;
+typedef BasicSpan<GeometryCoordinate> Span;
+typedef BasicSpanList<GeometryCoordinate> SpanList;
+typedef BasicTrapezoidTessellator<GeometryCoordinate> TrapezoidTessellator;
+
 } // namespace gepard
 
 #endif // GEPARD_TRAPEZOID_TESSELLATOR_H
@@ -28,6 +28,7 @@
 
 #include "gepard-gles2.h"
 
+#include "gepard-bounding-box.h"
 #include "gepard-color.h"
 #include "gepard-defs.h"
 #include "gepard-float.h"
@@ -35,7 +36,9 @@
 #include "gepard-gles2-shader-factory.h"
 #include "gepard-state.h"
 #include "gepard-trapezoid-tessellator.h"
+#include <cmath>
 #include <string>
+#include <vector>
 
 namespace gepard {
 namespace gles2 {
@@ -47,6 +50,7 @@ static const std::string s_fillPathVertexShader = GD_GLES2_SHADER_PROGRAM(
 
     attribute vec4 a_trapezoidXs;
     attribute vec4 a_trapezoidYsAndIndex;
+    attribute vec3 a_color;
 
     // To reduce the rounding issues of float16 variables,
     // the numbers are spearated for integer and fractional parts.
@@ -54,6 +58,7 @@ static const std::string s_fillPathVertexShader = GD_GLES2_SHADER_PROGRAM(
     varying vec4 v_y1y2;
     varying vec4 v_x1x2;
     varying vec2 v_dx1dx2;
+    varying vec3 v_color;
 
     void main(void)
     {
@@ -121,6 +126,7 @@ static const std::string s_fillPathVertexShader = GD_GLES2_SHADER_PROGRAM(
 
         v_dx1dx2[0] = dx1 * (1.0 / float(GD_ANTIALIAS_LEVEL));
         v_dx1dx2[1] = dx2 * (1.0 / float(GD_ANTIALIAS_LEVEL));
+        v_color = a_color;
         gl_Position = vec4((2.0 * position.xy / u_size) - 1.0, 0.0, 1.0);
     }
 );
@@ -131,6 +137,7 @@ static const std::string s_fillPathFragmentShader = GD_GLES2_SHADER_PROGRAM(
     varying vec4 v_y1y2;
     varying vec4 v_x1x2;
     varying vec2 v_dx1dx2;
+    varying vec3 v_color;
 
     void main(void)
     {
@@ -169,7 +176,7 @@ static const std::string s_fillPathFragmentShader = GD_GLES2_SHADER_PROGRAM(
             alpha = sum * step;
         }
 
-        gl_FragColor = vec4(0.0, 0.0, 0.0, alpha);
+        gl_FragColor = vec4(v_color, alpha);
     }
 );
 
@@ -179,12 +186,15 @@ static const std::string s_copyPathVertexShader = GD_GLES2_SHADER_PROGRAM(
     uniform vec2 u_viewportSize;
 
     attribute vec4 a_position;
+    attribute float a_alpha;
 
     varying vec2 v_texturePosition;
+    varying float v_alpha;
 
     void main()
     {
         v_texturePosition = a_position.zw;
+        v_alpha = a_alpha;
         gl_Position = vec4((2.0 * a_position.xy / u_viewportSize) - 1.0, 0.0, 1.0);
     }
 );
@@ -192,18 +202,24 @@ static const std::string s_copyPathVertexShader = GD_GLES2_SHADER_PROGRAM(
 static const std::string s_copyPathFragmentShader = GD_GLES2_SHADER_PROGRAM(
     precision highp float;
 
-    uniform vec4 u_color;
     uniform sampler2D u_texture;
 
     varying vec2 v_texturePosition;
+    varying float v_alpha;
 
     void main()
     {
-        gl_FragColor = vec4(u_color.rgb, u_color.a * texture2D(u_texture, v_texturePosition).a);
+        vec4 coverage = texture2D(u_texture, v_texturePosition);
+        gl_FragColor = vec4(coverage.rgb, v_alpha * coverage.a);
     }
 );
 
-static void setupPathVertexAttributes(const Trapezoid& trapezoid, GLfloat* attributes)
+//! Number of the floats of a vertex: trapezoid Xs, Ys and index, RGB color.
+static const int s_pathVertexStride = 11;
+//! Number of the floats of a trapezoid.
+static const int s_pathTrapezoidStride = 4 * s_pathVertexStride;
+
+static void setupPathVertexAttributes(const Trapezoid& trapezoid, const Color& color, GLfloat* attributes)
 {
     GD_ASSERT(trapezoid.topY - trapezoid.bottomY);
     for (int i = 0; i < 4; ++i) {
@@ -214,43 +230,72 @@ static void setupPathVertexAttributes(const Trapezoid& trapezoid, GLfloat* attri
         *attributes++ = trapezoid.bottomY;
         *attributes++ = trapezoid.topY;
         *attributes++ = i + ((i & 0x1) << 1);
-        attributes++; // Advance to the end of the stride.
+        attributes++; // Unused.
+        *attributes++ = color.r;
+        *attributes++ = color.g;
+        *attributes++ = color.b;
     }
 }
 
-void GepardGLES2::fillPath(PathData* pathData, const GepardState& state)
+/*!
+ * \brief Fill a path with GLES2 backend.
+ *
+ * The coverage of the consecutive fills is collected in a batch: the
+ * alpha channel of the coverage texture accumulates the coverage and the
+ * RGB channels get the color of the trapezoids.  The batched fills never
+ * share pixels, so every pixel has one color.  The batch is resolved
+ * (copied to the _fboId) when a fill would overlap with the already
+ * batched ones, when the batch is full, or by any other drawing operation
+ * or flush, see resolvePathBatch().
+ */
+void GepardGLES2::fillPath(PathData* pathData, const GepardState& state, const TrapezoidTessellator::FillRule fillRule)
 {
     makeCurrent();
-    if (!pathData->firstElement())
+    if (pathData->isEmpty())
         return;
 
-    const Color& fillColor = state.fillColor;
     const uint32_t width = _context.surface->width();
     const uint32_t height = _context.surface->height();
 
-    GLuint textureId;
-    {
-        GLuint fboId;
-        glGenFramebuffers(1, &fboId);
-        glBindFramebuffer(GL_FRAMEBUFFER, fboId);
-
-        glGenTextures(1, &textureId);
-        glBindTexture(GL_TEXTURE_2D, textureId);
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
-
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureId, 0);
-        glBindFramebuffer(GL_FRAMEBUFFER, fboId);
-
-        //! \todo(szledan) check: are we really need this glClear?
-        glClear(GL_COLOR_BUFFER_BIT);
-        glBlendFunc(GL_ONE, GL_ONE);
+    TrapezoidTessellator tt(*pathData, fillRule, GD_ANTIALIAS_LEVEL, &_context.edgeTable);
+    const TrapezoidList trapezoidList = tt.trapezoidList();
+
+    // The coverage is written only inside the bounding box of the path
+    // (with a safety pixel for the rounding of the tessellator).
+    const BoundingBox& bb = tt.boundingBox();
+    BoundingBox coverageBox;
+    coverageBox.stretch(FloatPoint(clamp(std::floor(bb.minX) - 1, Float(0), Float(width)), clamp(std::floor(bb.minY) - 1, Float(0), Float(height))));
+    coverageBox.stretch(FloatPoint(clamp(std::ceil(bb.maxX) + 1, Float(0), Float(width)), clamp(std::ceil(bb.maxY) + 1, Float(0), Float(height))));
+    if (coverageBox.isEmpty())
+        return;
+
+    if (_pathBatch.size() >= kMaximumNumberOfBatchedFills) {
+        resolvePathBatch();
     }
 
-    {
+    for (const BatchedFill& fill : _pathBatch) {
+        if (fill.coverageBox.intersects(coverageBox)) {
+            GD_LOG2("The path overlaps the batched ones.");
+            resolvePathBatch();
+            break;
+        }
+    }
+
+    if (_pathBatch.empty()) {
+        bindCoverageTarget();
+        glEnable(GL_SCISSOR_TEST);
+
+        // Clear only the area which was written by the previous batch.
+        if (!_coverageDirtyBox.isEmpty()) {
+            glScissor(GLint(_coverageDirtyBox.minX), GLint(_coverageDirtyBox.minY),
+                GLsizei(_coverageDirtyBox.maxX - _coverageDirtyBox.minX), GLsizei(_coverageDirtyBox.maxY - _coverageDirtyBox.minY));
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
+        _coverageDirtyBox = BoundingBox();
+
+        // Replace the color and accumulate the coverage.
+        glBlendFuncSeparate(GL_ONE, GL_ZERO, GL_ONE, GL_ONE);
+
         ShaderProgram& fillProgram = _shaderProgramManager.getProgram("fillPathProgram", s_fillPathVertexShader, s_fillPathFragmentShader);
         glUseProgram(fillProgram.id);
 
@@ -260,7 +305,7 @@ void GepardGLES2::fillPath(PathData* pathData, const GepardState& state)
             glUniform2f(index, width, height);
         }
 
-        constexpr int strideLength = 8 * sizeof(GLfloat);
+        constexpr int strideLength = s_pathVertexStride * sizeof(GLfloat);
         int offset = 0;
         {
             const GLint size = 4;
@@ -278,80 +323,128 @@ void GepardGLES2::fillPath(PathData* pathData, const GepardState& state)
             offset += size;
         }
 
-        TrapezoidTessellator::FillRule fillRule = TrapezoidTessellator::FillRule::NonZero;
-
-        TrapezoidTessellator tt(*pathData, fillRule, GD_ANTIALIAS_LEVEL);
-        const TrapezoidList trapezoidList = tt.trapezoidList(state);
-
-        int trapezoidIndex = 0;
-        for (Trapezoid trapezoid : trapezoidList) {
-            GD_ASSERT(trapezoid.topY < trapezoid.bottomY);
-            GD_ASSERT(trapezoid.topLeftX <= trapezoid.topRightX);
-            GD_ASSERT(trapezoid.bottomLeftX <= trapezoid.bottomRightX);
-
-            if (!trapezoid.leftId || !trapezoid.rightId)
-                continue;
-
-            setupPathVertexAttributes(trapezoid, _attributes + trapezoidIndex * 32);
-            trapezoidIndex++;
-            if (trapezoidIndex >= std::min(kMaximumNumberOfUshortQuads, kMaximumNumberOfAttributes / 32)) {
-                GD_LOG2("Draw '" << trapezoidIndex << "' trapezoids with triangles in pairs.");
-                glDrawElements(GL_TRIANGLES, 6 * trapezoidIndex, GL_UNSIGNED_SHORT, nullptr);
-                trapezoidIndex = 0;
-            }
+        {
+            const GLint size = 3;
+            const GLint index = glGetAttribLocation(fillProgram.id, "a_color");
+            glEnableVertexAttribArray(index);
+            glVertexAttribPointer(index, size, GL_FLOAT, GL_FALSE, strideLength, _attributes + offset);
+            offset += size;
         }
+    }
 
-        if (trapezoidIndex) {
-            GD_LOG2("Draw '" << trapezoidIndex << "' trapezoids with triangles in pairs.");
-            glDrawElements(GL_TRIANGLES, 6 * trapezoidIndex, GL_UNSIGNED_SHORT, nullptr);
+    _pathBatch.push_back({ coverageBox, state.fillColor.a });
+    // The coverage writes are limited to the area of the batch, which is
+    // cleared before the next batch.
+    _coverageDirtyBox.stretch(coverageBox);
+    glScissor(GLint(_coverageDirtyBox.minX), GLint(_coverageDirtyBox.minY),
+        GLsizei(_coverageDirtyBox.maxX - _coverageDirtyBox.minX), GLsizei(_coverageDirtyBox.maxY - _coverageDirtyBox.minY));
+
+    const int maximumNumberOfTrapezoids = std::min(kMaximumNumberOfUshortQuads, kMaximumNumberOfAttributes / s_pathTrapezoidStride);
+    for (Trapezoid trapezoid : trapezoidList) {
+        GD_ASSERT(trapezoid.topY < trapezoid.bottomY);
+        GD_ASSERT(trapezoid.topLeftX <= trapezoid.topRightX);
+        GD_ASSERT(trapezoid.bottomLeftX <= trapezoid.bottomRightX);
+
+        if (!trapezoid.leftId || !trapezoid.rightId)
+            continue;
+
+        setupPathVertexAttributes(trapezoid, state.fillColor, _attributes + _batchedTrapezoids * s_pathTrapezoidStride);
+        _batchedTrapezoids++;
+        if (_batchedTrapezoids >= maximumNumberOfTrapezoids) {
+            drawPathBatchCoverage();
         }
     }
+}
 
-    {
-        glBindFramebuffer(GL_FRAMEBUFFER, _fboId);
+/*!
+ * \brief Accumulate the coverage of the trapezoids in the _attributes.
+ *
+ * \internal
+ */
+void GepardGLES2::drawPathBatchCoverage()
+{
+    if (_batchedTrapezoids) {
+        GD_LOG2("Draw '" << _batchedTrapezoids << "' trapezoids with triangles in pairs.");
+        glDrawElements(GL_TRIANGLES, 6 * _batchedTrapezoids, GL_UNSIGNED_SHORT, nullptr);
+        _batchedTrapezoids = 0;
+    }
+}
 
-        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE);
+/*!
+ * \brief Copy the coverage of the batched fills to the _fboId.
+ *
+ * The coverage holds premultiplied colors of the fills.  Only the areas of
+ * the batched fills are copied, with one draw call.
+ *
+ * \internal
+ */
+void GepardGLES2::resolvePathBatch()
+{
+    if (_pathBatch.empty())
+        return;
 
-        ShaderProgram& copyProgram = _shaderProgramManager.getProgram("copyPathProgram", s_copyPathVertexShader, s_copyPathFragmentShader);
-        glUseProgram(copyProgram.id);
+    drawPathBatchCoverage();
 
-        {
-            const GLint index = glGetUniformLocation(copyProgram.id, "u_viewportSize");
-            glUniform2f(index, width, height);
-        }
+    const uint32_t width = _context.surface->width();
+    const uint32_t height = _context.surface->height();
+    GD_LOG2("Resolve path batch with '" << _pathBatch.size() << "' fills.");
 
-        {
-            const GLfloat textureCoords[] = {
-                0.0, 0.0, 0.0, 0.0,
-                (GLfloat)width, 0.0, 1.0, 0.0,
-                0.0, (GLfloat)height, 0.0, 1.0,
-                (GLfloat)width, (GLfloat)height, 1.0, 1.0,
-            };
-
-            const GLint index = glGetAttribLocation(copyProgram.id, "a_position");
-            glEnableVertexAttribArray(index);
-            glVertexAttribPointer(index, 4, GL_FLOAT, GL_FALSE, 0, textureCoords);
-        }
+    glBindFramebuffer(GL_FRAMEBUFFER, _fboId);
 
-        {
-            const GLint index = glGetUniformLocation(copyProgram.id, "u_color");
-            glUniform4f(index, ((Float)fillColor.r), ((Float)fillColor.g), ((Float)fillColor.b), fillColor.a);
-        }
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE);
 
-        {
-            glActiveTexture(GL_TEXTURE0);
-            const GLint index = glGetUniformLocation(copyProgram.id, "u_texture");
-            glUniform1i(index, GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, textureId);
-        }
+    ShaderProgram& copyProgram = _shaderProgramManager.getProgram("copyPathProgram", s_copyPathVertexShader, s_copyPathFragmentShader);
+    glUseProgram(copyProgram.id);
 
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    {
+        const GLint index = glGetUniformLocation(copyProgram.id, "u_viewportSize");
+        glUniform2f(index, width, height);
+    }
+
+    // One quad for every fill of the batch.
+    std::vector<GLfloat> textureCoords;
+    std::vector<GLfloat> alphas;
+    textureCoords.reserve(_pathBatch.size() * 16);
+    alphas.reserve(_pathBatch.size() * 4);
+    for (const BatchedFill& fill : _pathBatch) {
+        const GLfloat left = fill.coverageBox.minX;
+        const GLfloat top = fill.coverageBox.minY;
+        const GLfloat right = fill.coverageBox.maxX;
+        const GLfloat bottom = fill.coverageBox.maxY;
+        const GLfloat quad[] = {
+            left, top, left / width, top / height,
+            right, top, right / width, top / height,
+            left, bottom, left / width, bottom / height,
+            right, bottom, right / width, bottom / height,
+        };
+        textureCoords.insert(textureCoords.end(), quad, quad + 16);
+        alphas.insert(alphas.end(), 4, GLfloat(fill.alpha));
+    }
 
-        glDeleteTextures(1, &textureId);
+    {
+        const GLint index = glGetAttribLocation(copyProgram.id, "a_position");
+        glEnableVertexAttribArray(index);
+        glVertexAttribPointer(index, 4, GL_FLOAT, GL_FALSE, 0, textureCoords.data());
+    }
+
+    {
+        const GLint index = glGetAttribLocation(copyProgram.id, "a_alpha");
+        glEnableVertexAttribArray(index);
+        glVertexAttribPointer(index, 1, GL_FLOAT, GL_FALSE, 0, alphas.data());
+    }
+
+    {
+        glActiveTexture(GL_TEXTURE0);
+        const GLint index = glGetUniformLocation(copyProgram.id, "u_texture");
+        glUniform1i(index, GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, _coverageTextureId);
     }
 
+    // The scissor box is still the bounds of the batch.
+    glDrawElements(GL_TRIANGLES, 6 * _pathBatch.size(), GL_UNSIGNED_SHORT, nullptr);
+    glDisable(GL_SCISSOR_TEST);
 
-    render();
+    _pathBatch.clear();
 }
 
 } // namespace gles2
@@ -78,6 +78,7 @@ static const std::string s_fillRectFragmentShader = GD_GLES2_SHADER_PROGRAM(
 void GepardGLES2::fillRect(const Float x, const Float y, const Float w, const Float h, const Color& fillColor)
 {
     makeCurrent();
+    resolvePathBatch();
     glBindFramebuffer(GL_FRAMEBUFFER, _fboId);
 
     GD_LOG1("Fill rect with GLES2 (" << x << ", " << y << ", " << w << ", " << h << ")");
@@ -128,8 +129,6 @@ void GepardGLES2::fillRect(const Float x, const Float y, const Float w, const Fl
 
     GD_LOG2("4. Draw '" << quadCount << "' quads with triangles in pairs.");
     glDrawElements(GL_TRIANGLES, quadCount * 6, GL_UNSIGNED_SHORT, nullptr);
-
-    render();
 }
 
 } // namespace gles2
@@ -38,24 +38,20 @@
 namespace gepard {
 namespace gles2 {
 
-void GepardGLES2::strokePath()
+void GepardGLES2::strokePath(PathData* pathData, const GepardState& state)
 {
-    PathData* pathData = _context.path.pathData();
-    GepardState& state = _context.currentState();
-
-    GD_LOG3("Path: " << pathData->firstElement());
+    GD_LOG3("Path: " << *pathData);
     if (!pathData || pathData->isEmpty())
         return;
 
     Float miterLimit = state.miterLimit ? state.miterLimit : 10;
 
     StrokePathBuilder sPath(state.lineWitdh, miterLimit, state.lineJoinMode, state.lineCapMode);
-    sPath.convertStrokeToFill(pathData);
+    sPath.convertStrokeToFill(pathData, state.transform);
 
-    Color tempColor = state.fillColor;
-    state.fillColor = state.strokeColor;
-    fillPath(sPath.pathData(), state);
-    state.fillColor = tempColor;
+    GepardState strokeState = state;
+    strokeState.fillColor = state.strokeColor;
+    fillPath(sPath.pathData(), strokeState);
 }
 
 } // namespace gles2
@@ -32,6 +32,8 @@
 #include "gepard-engine.h"
 #include "gepard-gles2-defs.h"
 #include "gepard-gles2-shader-factory.h"
+#include <map>
+#include <mutex>
 
 namespace gepard {
 namespace gles2 {
@@ -65,35 +67,117 @@ static const std::string s_textureFragmentShader = GD_GLES2_SHADER_PROGRAM(
     }
 );
 
+static const EGLint s_configAttribs[] = {
+    EGL_RED_SIZE, 8,
+    EGL_GREEN_SIZE, 8,
+    EGL_BLUE_SIZE, 8,
+    EGL_ALPHA_SIZE, 8,
+    EGL_DEPTH_SIZE, 8,
+    EGL_STENCIL_SIZE, 8,
+
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+    EGL_SURFACE_TYPE, EGL_WINDOW_BIT,
+    EGL_SAMPLE_BUFFERS, 0,
+    EGL_SAMPLES, 0,
+    EGL_NONE
+};
+
+static const EGLint s_contextAttribs[] = {
+    // Identify OpenGL 2 ES context
+    EGL_CONTEXT_CLIENT_VERSION, 2,
+    EGL_NONE,
+};
+
+/*!
+ * \brief The GepardGLES2 whose EGL context is current on the calling thread,
+ * see makeCurrent().
+ *
+ * \internal
+ */
+static thread_local GepardGLES2* s_currentGepardGLES2 = nullptr;
+
+/*!
+ * \brief The number of the GepardGLES2 instances per initialized EGL display.
+ *
+ * The contexts of the different threads may share a display, which is
+ * terminated only by the destructor of its last user.
+ *
+ * \internal
+ */
+static std::map<EGLDisplay, unsigned> s_displayReferences;
+static std::mutex s_displayMutex;
+
 const int GepardGLES2::kMaximumNumberOfAttributes = GLushort(-1) + 1;
 const int GepardGLES2::kMaximumNumberOfUshortQuads = GepardGLES2::kMaximumNumberOfAttributes / 6;
+const size_t GepardGLES2::kMaximumNumberOfBatchedFills = 256;
+
+/*!
+ * \brief Check whether EGL can create an OpenGL ES 2.0 context on the
+ * initialized _eglDisplay_ of the _display_.
+ *
+ * \internal
+ */
+static const bool canCreateContext(const EGLDisplay eglDisplay, void* display)
+{
+    if (!display) {
+        eglBindAPI(EGL_OPENGL_ES_API);
+    }
+
+    EGLConfig eglConfig = 0;
+    EGLint numOfConfigs = 0;
+    if (eglChooseConfig(eglDisplay, s_configAttribs, &eglConfig, 1, &numOfConfigs) != EGL_TRUE || (display && !numOfConfigs)) {
+        return false;
+    }
+
+    const EGLContext eglContext = eglCreateContext(eglDisplay, eglConfig, EGL_NO_CONTEXT, s_contextAttribs);
+    if (eglContext == EGL_NO_CONTEXT) {
+        return false;
+    }
+    eglDestroyContext(eglDisplay, eglContext);
+
+    return true;
+}
+
+/*!
+ * \brief Check whether EGL can create an OpenGL ES 2.0 context for the
+ * _surface_, the same way as the constructor does.
+ *
+ * The display is terminated again if it was initialized by this check and
+ * no GepardGLES2 uses it, so a failed check doesn't leak it.
+ */
+const bool GepardGLES2::isAvailable(Surface* surface)
+{
+    std::lock_guard<std::mutex> guard(s_displayMutex);
+    void* display = surface->getDisplay();
+    const EGLDisplay eglDisplay = eglGetDisplay((EGLNativeDisplayType)display);
+    if (eglDisplay == EGL_NO_DISPLAY) {
+        return false;
+    }
+
+    // The query fails on a display which is not initialized yet.
+    const bool wasInitialized = eglQueryString(eglDisplay, EGL_VERSION);
+    if (eglInitialize(eglDisplay, NULL, NULL) != EGL_TRUE) {
+        return false;
+    }
+
+    const bool available = canCreateContext(eglDisplay, display);
+
+    if (!wasInitialized && !s_displayReferences.count(eglDisplay)) {
+        eglTerminate(eglDisplay);
+    }
+    return available;
+}
 
 GepardGLES2::GepardGLES2(GepardContext& context)
     : _context(context)
+    , _coverageFboId(0)
+    , _coverageTextureId(0)
+    , _coverageWidth(0)
+    , _coverageHeight(0)
+    , _batchedTrapezoids(0)
 {
     GD_LOG1("Create GepardGLES2 with surface: " << context.surface);
 
-    const EGLint configAttribs[] = {
-        EGL_RED_SIZE, 8,
-        EGL_GREEN_SIZE, 8,
-        EGL_BLUE_SIZE, 8,
-        EGL_ALPHA_SIZE, 8,
-        EGL_DEPTH_SIZE, 8,
-        EGL_STENCIL_SIZE, 8,
-
-        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
-        EGL_SURFACE_TYPE, EGL_WINDOW_BIT,
-        EGL_SAMPLE_BUFFERS, 0,
-        EGL_SAMPLES, 0,
-        EGL_NONE
-    };
-
-    const EGLint contextAttribs[] = {
-        // Identify OpenGL 2 ES context
-        EGL_CONTEXT_CLIENT_VERSION, 2,
-        EGL_NONE,
-    };
-
     GD_LOG2("Get and set EGL display and surface.");
     EGLDisplay eglDisplay = 0;
     EGLSurface eglSurface = 0;
@@ -111,8 +195,12 @@ GepardGLES2::GepardGLES2(GepardContext& context)
     }
 
     // 2. Initialize EGL.
-    if (eglInitialize(eglDisplay, NULL, NULL) != EGL_TRUE) {
-        GD_CRASH("eglInitialize returned with EGL_FALSE");
+    {
+        std::lock_guard<std::mutex> guard(s_displayMutex);
+        if (eglInitialize(eglDisplay, NULL, NULL) != EGL_TRUE) {
+            GD_CRASH("eglInitialize returned with EGL_FALSE");
+        }
+        s_displayReferences[eglDisplay]++;
     }
 
     if (!display) {
@@ -121,7 +209,7 @@ GepardGLES2::GepardGLES2(GepardContext& context)
     }
 
     // 4. Find a config that matches all requirements.
-    if (eglChooseConfig(eglDisplay, configAttribs, &eglConfig, 1, &numOfConfigs) != EGL_TRUE) {
+    if (eglChooseConfig(eglDisplay, s_configAttribs, &eglConfig, 1, &numOfConfigs) != EGL_TRUE) {
         GD_CRASH("eglChooseConfig returned with EGL_FALSE");
     }
 
@@ -133,7 +221,7 @@ GepardGLES2::GepardGLES2(GepardContext& context)
     }
 
     // 6. Create a context.
-    _eglContext = eglCreateContext(eglDisplay, eglConfig, EGL_NO_CONTEXT, contextAttribs);
+    _eglContext = eglCreateContext(eglDisplay, eglConfig, EGL_NO_CONTEXT, s_contextAttribs);
     if (_eglContext == EGL_NO_CONTEXT) {
         GD_CRASH("eglCreateContext returned EGL_NO_CONTEXT");
     }
@@ -196,32 +284,101 @@ GepardGLES2::~GepardGLES2()
         free(_attributes);
     }
 
+    if (_coverageFboId) {
+        makeCurrent();
+        glDeleteFramebuffers(1, &_coverageFboId);
+        glDeleteTextures(1, &_coverageTextureId);
+    }
+
     if (_eglDisplay != EGL_NO_DISPLAY) {
         eglMakeCurrent(_eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
         eglDestroyContext(_eglDisplay, _eglContext);
         eglDestroySurface(_eglDisplay, _eglSurface);
-        eglTerminate(_eglDisplay);
+        s_currentGepardGLES2 = nullptr;
+
+        std::lock_guard<std::mutex> guard(s_displayMutex);
+        if (!--s_displayReferences[_eglDisplay]) {
+            s_displayReferences.erase(_eglDisplay);
+            eglTerminate(_eglDisplay);
+        }
         GD_LOG1("Destroyed GepardGLES2 (display and surface were: " << _eglDisplay  << " and " << _eglSurface << ".");
     } else if (_eglContext != EGL_NO_CONTEXT) {
         //! \todo destroy EGL Context
     }
 }
 
-void GepardGLES2::makeCurrent()
+/*!
+ * \brief Present the pending drawings on the surface.
+ *
+ * The primitives draw only into the framebuffer object, the surface is
+ * updated (swapped or read back) here once per frame.
+ */
+void GepardGLES2::flush()
 {
-    static GepardGLES2* currentGepardGLES2 = nullptr;
+    makeCurrent();
+    resolvePathBatch();
+    render();
+    _context.surface->frameReady(_context.frameCount);
+}
 
-    if (this != currentGepardGLES2) {
+/*!
+ * \brief Bind the EGL context of this instance to the calling thread.
+ *
+ * Each thread tracks its own current context, so the instances of the
+ * different threads do not rebind each other's contexts.
+ */
+void GepardGLES2::makeCurrent()
+{
+    if (this != s_currentGepardGLES2) {
         GD_LOG1("Make current binds the EGL rendering context.");
         if (eglMakeCurrent(_eglDisplay, _eglSurface, _eglSurface, _eglContext) != EGL_TRUE) {
             GD_CRASH("eglMakeCurrent returned EGL_FALSE");
         }
-        currentGepardGLES2 = this;
+        s_currentGepardGLES2 = this;
     }
 
     GD_LOG3("Current GepardGLES2: " << this);
 }
 
+/*!
+ * \brief Bind the render target of the path coverage.
+ *
+ * The texture is (re)allocated and cleared only if the size of the surface
+ * has changed, otherwise fillPath() keeps it clear outside of the
+ * _coverageDirtyBox.
+ *
+ * \internal
+ */
+void GepardGLES2::bindCoverageTarget()
+{
+    const uint32_t width = _context.surface->width();
+    const uint32_t height = _context.surface->height();
+
+    if (!_coverageFboId) {
+        glGenFramebuffers(1, &_coverageFboId);
+        glGenTextures(1, &_coverageTextureId);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, _coverageFboId);
+
+    if (_coverageWidth != width || _coverageHeight != height) {
+        GD_LOG2("Allocate " << width << "x" << height << " coverage texture.");
+        glBindTexture(GL_TEXTURE_2D, _coverageTextureId);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _coverageTextureId, 0);
+
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        _coverageWidth = width;
+        _coverageHeight = height;
+        _coverageDirtyBox = BoundingBox();
+    }
+}
+
 void GepardGLES2::render()
 {
     //! \todo(szledan): if needed, call 'makeCurrent();'.
@@ -264,9 +421,9 @@ void GepardGLES2::render()
         glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*) _context.surface->getBuffer());
     } else {
         glBindFramebuffer(GL_FRAMEBUFFER, _fboId);
-        std::vector<uint32_t> buffer(width * height);
-        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*) buffer.data());
-        _context.surface->drawBuffer(buffer.data());
+        _readbackBuffer.resize(width * height);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*) _readbackBuffer.data());
+        _context.surface->drawBuffer(_readbackBuffer.data());
     }
 }
 
@@ -28,16 +28,20 @@
 #ifndef GEPARD_GLES2_H
 #define GEPARD_GLES2_H
 
+#include "gepard-bounding-box.h"
 #include "gepard-color.h"
 #include "gepard-context.h"
+#include "gepard-engine-backend.h"
 #include "gepard-float.h"
 #include "gepard-gles2-defs.h"
 #include "gepard-gles2-shader-factory.h"
 #include "gepard-image.h"
 #include "gepard-state.h"
+#include "gepard-trapezoid-tessellator.h"
 #include "gepard.h"
 #include <EGL/egl.h>
 #include <GLES2/gl2.h>
+#include <vector>
 
 namespace gepard {
 
@@ -46,21 +50,31 @@ class Surface;
 
 namespace gles2 {
 
-class GepardGLES2 {
+class GepardGLES2 : public GepardEngineBackend {
 public:
     static const int kMaximumNumberOfAttributes;
     static const int kMaximumNumberOfUshortQuads;
+    static const size_t kMaximumNumberOfBatchedFills;
+
+    static const bool isAvailable(Surface*);
 
     explicit GepardGLES2(GepardContext&);
-    ~GepardGLES2();
+    virtual ~GepardGLES2();
+
+    virtual const Gepard::Backend type() const { return Gepard::GLES2Backend; }
 
-    void fillRect(const Float x, const Float y, const Float w, const Float h, const Color& fillColor);
-    void fillPath(PathData*, const GepardState&);
-    void strokePath();
+    virtual void fillRect(const Float x, const Float y, const Float w, const Float h, const Color& fillColor);
+    virtual void fillPath(PathData*, const GepardState&, const TrapezoidTessellator::FillRule = TrapezoidTessellator::NonZero);
+    virtual void strokePath(PathData*, const GepardState&);
+    virtual void flush();
+    virtual void finish() {}
 
 private:
     void makeCurrent();
     void render();
+    void bindCoverageTarget();
+    void drawPathBatchCoverage();
+    void resolvePathBatch();
 
     ShaderProgramManager _shaderProgramManager;
 
@@ -75,13 +89,24 @@ private:
     GLuint _fboId;
     GLuint _textureId;
 
+    GLuint _coverageFboId; //!< Render target of the path coverage, see fillPath().
+    GLuint _coverageTextureId;
+    uint32_t _coverageWidth;
+    uint32_t _coverageHeight;
+    BoundingBox _coverageDirtyBox; //!< The area of the coverage written by the last batch.
+    struct BatchedFill {
+        BoundingBox coverageBox;
+        Float alpha;
+    };
+    std::vector<BatchedFill> _pathBatch;
+    int _batchedTrapezoids; //!< Number of the trapezoids in the _attributes.
+
     GLfloat* _attributes;
+    std::vector<uint32_t> _readbackBuffer; //!< Used by render() if the surface has no buffer.
 };
 
 } // namespace gles2
 
-typedef gles2::GepardGLES2 GepardEngineBackend;
-
 } // namespace gepard
 
 #endif // GEPARD_GLES2_H
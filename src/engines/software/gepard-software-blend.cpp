@@ -0,0 +1,347 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef GD_USE_SOFTWARE
+
+#include "gepard-software-blend.h"
+
+#include "gepard-color.h"
+#include "gepard-defs.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GD_SOFTWARE_BLEND_X86 1
+#include <immintrin.h>
+#define GD_TARGET(TARGET) __attribute__((target(TARGET)))
+#endif // __GNUC__ && (__x86_64__ || __i386__)
+
+namespace gepard {
+namespace software {
+
+/* Scalar */
+
+static inline uint32_t div255(const uint32_t value)
+{
+    // Rounded division by 255 without the division.
+    return (value + 128 + ((value + 128) >> 8)) >> 8;
+}
+
+static inline uint32_t scalePixel(const uint32_t pixel, const uint32_t scale)
+{
+    uint32_t result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        result |= div255(((pixel >> shift) & 0xff) * scale) << shift;
+    }
+    return result;
+}
+
+static inline uint32_t blendPixel(const uint32_t src, const uint32_t dst)
+{
+    const uint32_t invAlpha = 255 - (src >> 24);
+    uint32_t result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        const uint32_t channel = ((src >> shift) & 0xff) + div255(((dst >> shift) & 0xff) * invAlpha);
+        result |= std::min(channel, 255u) << shift;
+    }
+    return result;
+}
+
+static void fillSpanScalar(uint32_t* dst, const int count, const uint32_t color)
+{
+    for (int i = 0; i < count; ++i) {
+        dst[i] = blendPixel(color, dst[i]);
+    }
+}
+
+static void fillMaskedSpanScalar(uint32_t* dst, const int count, const uint32_t color, const uint8_t* mask)
+{
+    for (int i = 0; i < count; ++i) {
+        if (mask[i])
+            dst[i] = blendPixel(scalePixel(color, mask[i]), dst[i]);
+    }
+}
+
+static void fillOpaqueSpanScalar(uint32_t* dst, const int count, const uint32_t color)
+{
+    std::fill(dst, dst + count, color);
+}
+
+static const SpanBlender s_scalarBlender = { "scalar", fillSpanScalar, fillMaskedSpanScalar, fillOpaqueSpanScalar };
+
+#ifdef GD_SOFTWARE_BLEND_X86
+
+/* SSE2 */
+
+GD_TARGET("sse2") static inline __m128i div255SSE2(__m128i value)
+{
+    value = _mm_add_epi16(value, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(value, _mm_srli_epi16(value, 8)), 8);
+}
+
+GD_TARGET("sse2") static inline __m128i broadcastAlphaSSE2(const __m128i pixels)
+{
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+GD_TARGET("sse2") static void fillSpanSSE2(uint32_t* dst, const int count, const uint32_t color)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i src = _mm_unpacklo_epi8(_mm_set1_epi32(color), zero);
+    const __m128i invAlpha = _mm_set1_epi16(255 - (color >> 24));
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        const __m128i lo = _mm_add_epi16(src, div255SSE2(_mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), invAlpha)));
+        const __m128i hi = _mm_add_epi16(src, div255SSE2(_mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), invAlpha)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+    }
+
+    fillSpanScalar(dst + i, count - i, color);
+}
+
+GD_TARGET("sse2") static void fillMaskedSpanSSE2(uint32_t* dst, const int count, const uint32_t color, const uint8_t* mask)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i max = _mm_set1_epi16(255);
+    const __m128i src = _mm_unpacklo_epi8(_mm_set1_epi32(color), zero);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        int32_t masks;
+        std::memcpy(&masks, mask + i, sizeof(masks));
+        if (!masks)
+            continue;
+
+        // Repeat the mask value of every pixel on its four channels.
+        __m128i scale = _mm_cvtsi32_si128(masks);
+        scale = _mm_unpacklo_epi8(scale, scale);
+        scale = _mm_unpacklo_epi16(scale, scale);
+
+        const __m128i srcLo = div255SSE2(_mm_mullo_epi16(src, _mm_unpacklo_epi8(scale, zero)));
+        const __m128i srcHi = div255SSE2(_mm_mullo_epi16(src, _mm_unpackhi_epi8(scale, zero)));
+        const __m128i invAlphaLo = _mm_sub_epi16(max, broadcastAlphaSSE2(srcLo));
+        const __m128i invAlphaHi = _mm_sub_epi16(max, broadcastAlphaSSE2(srcHi));
+
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        const __m128i lo = _mm_add_epi16(srcLo, div255SSE2(_mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), invAlphaLo)));
+        const __m128i hi = _mm_add_epi16(srcHi, div255SSE2(_mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), invAlphaHi)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+    }
+
+    fillMaskedSpanScalar(dst + i, count - i, color, mask + i);
+}
+
+GD_TARGET("sse2") static void fillOpaqueSpanSSE2(uint32_t* dst, const int count, const uint32_t color)
+{
+    const __m128i src = _mm_set1_epi32(color);
+
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), src);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), src);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), src);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 12), src);
+    }
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), src);
+    }
+
+    fillOpaqueSpanScalar(dst + i, count - i, color);
+}
+
+static const SpanBlender s_sse2Blender = { "sse2", fillSpanSSE2, fillMaskedSpanSSE2, fillOpaqueSpanSSE2 };
+
+/* AVX2 */
+
+GD_TARGET("avx2") static inline __m256i div255AVX2(__m256i value)
+{
+    value = _mm256_add_epi16(value, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(value, _mm256_srli_epi16(value, 8)), 8);
+}
+
+GD_TARGET("avx2") static inline __m256i broadcastAlphaAVX2(const __m256i pixels)
+{
+    return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+GD_TARGET("avx2") static void fillSpanAVX2(uint32_t* dst, const int count, const uint32_t color)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i src = _mm256_unpacklo_epi8(_mm256_set1_epi32(color), zero);
+    const __m256i invAlpha = _mm256_set1_epi16(255 - (color >> 24));
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        const __m256i lo = _mm256_add_epi16(src, div255AVX2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(pixels, zero), invAlpha)));
+        const __m256i hi = _mm256_add_epi16(src, div255AVX2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(pixels, zero), invAlpha)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_packus_epi16(lo, hi));
+    }
+
+    fillSpanSSE2(dst + i, count - i, color);
+}
+
+GD_TARGET("avx2") static void fillMaskedSpanAVX2(uint32_t* dst, const int count, const uint32_t color, const uint8_t* mask)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i max = _mm256_set1_epi16(255);
+    const __m256i src = _mm256_unpacklo_epi8(_mm256_set1_epi32(color), zero);
+    const __m256i repeat = _mm256_set1_epi32(0x01010101);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int64_t masks;
+        std::memcpy(&masks, mask + i, sizeof(masks));
+        if (!masks)
+            continue;
+
+        // Repeat the mask value of every pixel on its four channels.
+        const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(mask + i));
+        const __m256i scale = _mm256_mullo_epi32(_mm256_cvtepu8_epi32(bytes), repeat);
+
+        const __m256i srcLo = div255AVX2(_mm256_mullo_epi16(src, _mm256_unpacklo_epi8(scale, zero)));
+        const __m256i srcHi = div255AVX2(_mm256_mullo_epi16(src, _mm256_unpackhi_epi8(scale, zero)));
+        const __m256i invAlphaLo = _mm256_sub_epi16(max, broadcastAlphaAVX2(srcLo));
+        const __m256i invAlphaHi = _mm256_sub_epi16(max, broadcastAlphaAVX2(srcHi));
+
+        const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        const __m256i lo = _mm256_add_epi16(srcLo, div255AVX2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(pixels, zero), invAlphaLo)));
+        const __m256i hi = _mm256_add_epi16(srcHi, div255AVX2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(pixels, zero), invAlphaHi)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_packus_epi16(lo, hi));
+    }
+
+    fillMaskedSpanSSE2(dst + i, count - i, color, mask + i);
+}
+
+GD_TARGET("avx2") static void fillOpaqueSpanAVX2(uint32_t* dst, const int count, const uint32_t color)
+{
+    const __m256i src = _mm256_set1_epi32(color);
+
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), src);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 8), src);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 16), src);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 24), src);
+    }
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), src);
+    }
+
+    fillOpaqueSpanSSE2(dst + i, count - i, color);
+}
+
+static const SpanBlender s_avx2Blender = { "avx2", fillSpanAVX2, fillMaskedSpanAVX2, fillOpaqueSpanAVX2 };
+
+#endif // GD_SOFTWARE_BLEND_X86
+
+/*!
+ * \brief The span blenders which can run on this CPU
+ * \return  list of the blenders, the last one is the fastest
+ *
+ * \internal
+ */
+const std::vector<const SpanBlender*> supportedSpanBlenders()
+{
+    std::vector<const SpanBlender*> blenders;
+    blenders.push_back(&s_scalarBlender);
+
+#ifdef GD_SOFTWARE_BLEND_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        blenders.push_back(&s_sse2Blender);
+        if (__builtin_cpu_supports("avx2"))
+            blenders.push_back(&s_avx2Blender);
+    }
+#endif // GD_SOFTWARE_BLEND_X86
+
+    return blenders;
+}
+
+static const SpanBlender* selectSpanBlender()
+{
+    const SpanBlender* blender = supportedSpanBlenders().back();
+    GD_LOG1("Use '" << blender->name << "' span blender.");
+    return blender;
+}
+
+/*!
+ * \brief The fastest span blender of this CPU, selected at the first call
+ *
+ * \internal
+ */
+const SpanBlender& spanBlender()
+{
+    static const SpanBlender* s_spanBlender = selectSpanBlender();
+    return *s_spanBlender;
+}
+
+/*!
+ * \brief Convert the color to premultiplied ABGR raw data format.
+ *
+ * \internal
+ */
+const uint32_t premultiply(const Color& color)
+{
+    const uint32_t raw = Color::toRawDataABGR(color);
+    const uint32_t alpha = raw >> 24;
+    return (scalePixel(raw, alpha) & 0x00ffffff) | (alpha << 24);
+}
+
+/*!
+ * \brief Convert premultiplied pixels to non-premultiplied ones.
+ * \param src  premultiplied pixels
+ * \param dst  destination of the converted pixels
+ * \param count  number of the pixels
+ *
+ * \internal
+ */
+void unpremultiplySpan(const uint32_t* src, uint32_t* dst, const int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const uint32_t pixel = src[i];
+        const uint32_t alpha = pixel >> 24;
+
+        if (alpha == 255) {
+            dst[i] = pixel;
+        } else if (!alpha) {
+            dst[i] = 0;
+        } else {
+            uint32_t result = alpha << 24;
+            for (int shift = 0; shift < 24; shift += 8) {
+                const uint32_t channel = (((pixel >> shift) & 0xff) * 255 + (alpha >> 1)) / alpha;
+                result |= std::min(channel, 255u) << shift;
+            }
+            dst[i] = result;
+        }
+    }
+}
+
+} // namespace software
+} // namespace gepard
+
+#endif // GD_USE_SOFTWARE
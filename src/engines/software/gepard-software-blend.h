@@ -0,0 +1,76 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef GD_USE_SOFTWARE
+
+#ifndef GEPARD_SOFTWARE_BLEND_H
+#define GEPARD_SOFTWARE_BLEND_H
+
+#include "gepard-defs.h"
+
+#include "gepard-color.h"
+#include <stdint.h>
+#include <vector>
+
+namespace gepard {
+namespace software {
+
+/*!
+ * \brief The SpanBlender struct
+ *
+ * Span blenders of 8-bit premultiplied pixels in ABGR raw data format with
+ * the source-over operator. Every implementation computes the same result
+ * bit by bit:
+ *
+ *  dst = min(255, src + div255(dst * (255 - srcAlpha)))
+ *
+ * The _fillMaskedSpan_ scales the source color with the 8-bit coverage mask
+ * before the blending. The _fillOpaqueSpan_ only stores the color, so it
+ * can be used when the source alpha is 255.
+ *
+ * \internal
+ */
+struct SpanBlender {
+    typedef void (*FillSpan)(uint32_t* dst, const int count, const uint32_t color);
+    typedef void (*FillMaskedSpan)(uint32_t* dst, const int count, const uint32_t color, const uint8_t* mask);
+
+    const char* name;
+    FillSpan fillSpan;
+    FillMaskedSpan fillMaskedSpan;
+    FillSpan fillOpaqueSpan;
+};
+
+const SpanBlender& spanBlender();
+const std::vector<const SpanBlender*> supportedSpanBlenders();
+
+const uint32_t premultiply(const Color& color);
+void unpremultiplySpan(const uint32_t* src, uint32_t* dst, const int count);
+
+} // namespace software
+} // namespace gepard
+
+#endif // GEPARD_SOFTWARE_BLEND_H
+
+#endif // GD_USE_SOFTWARE
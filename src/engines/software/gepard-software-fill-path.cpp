@@ -0,0 +1,257 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef GD_USE_SOFTWARE
+
+#include "gepard-software.h"
+
+#include "gepard-color.h"
+#include "gepard-defs.h"
+#include "gepard-float.h"
+#include "gepard-software-blend.h"
+#include "gepard-state.h"
+#include "gepard-trapezoid-tessellator.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace gepard {
+namespace software {
+
+/*!
+ * \brief Horizontal sub-pixel precision of the coverage accumulation.
+ *
+ * The x coordinates of the spans are rounded to 24.8 fixed point numbers,
+ * so a fully covered pixel adds 256 to the coverage per sub-scanline.
+ */
+static const int kSubPixelShift = 8;
+static const int32_t kSubPixelScale = 1 << kSubPixelShift;
+static const int32_t kSubPixelMask = kSubPixelScale - 1;
+static const int32_t kFullCoverage = kSubPixelScale * GD_ANTIALIAS_LEVEL;
+
+/*!
+ * \brief Accumulate a span of a sub-scanline into the coverage cells.
+ *
+ * The cells store the differences of the coverage values of the neighbouring
+ * pixels, so the coverage of a pixel is the sum of the cells from the left
+ * to the pixel. This way a span of any length touches only four cells.
+ *
+ * The span is clipped to the [clipLeft, clipRight] range. Since the clip
+ * values are integers, clipping doesn't change the coverage of the pixels
+ * inside the range.
+ *
+ * \internal
+ */
+static inline void accumulateSpan(int32_t* cells, const int clipLeft, const int clipRight, Float left, Float right, int& minX, int& maxX)
+{
+    left = clamp(left, Float(clipLeft), Float(clipRight));
+    right = clamp(right, Float(clipLeft), Float(clipRight));
+
+    const int32_t x0 = int32_t(std::lround(left * kSubPixelScale));
+    const int32_t x1 = int32_t(std::lround(right * kSubPixelScale));
+    if (x0 >= x1)
+        return;
+
+    const int i0 = x0 >> kSubPixelShift;
+    const int i1 = x1 >> kSubPixelShift;
+    const int32_t f0 = x0 & kSubPixelMask;
+    const int32_t f1 = x1 & kSubPixelMask;
+
+    cells[i0] += kSubPixelScale - f0;
+    cells[i0 + 1] += f0;
+    cells[i1] -= kSubPixelScale - f1;
+    cells[i1 + 1] -= f1;
+
+    minX = std::min(minX, i0);
+    maxX = std::max(maxX, i1);
+}
+
+/*!
+ * \brief Blend the accumulated coverage of a row into the buffer.
+ * \param y  the row of the buffer
+ * \param minX  first touched coverage cell
+ * \param maxX  last touched coverage cell
+ * \param right  the pixels from this column are not blended
+ * \param color  the premultiplied fill color in ABGR raw data format
+ * \param cells  the coverage row
+ * \param mask  the mask row for the span blender
+ *
+ * The used coverage cells are cleared for the next row.
+ *
+ * \internal
+ */
+void GepardSoftware::blendSpan(const int y, const int minX, const int maxX, const int right, const uint32_t color, int32_t* cells, uint8_t* mask)
+{
+    const int width = _context.surface->width();
+    const int end = std::min(maxX + 1, right);
+    int32_t coverage = 0;
+
+    for (int x = minX; x < end; ++x) {
+        coverage += cells[x];
+        cells[x] = 0;
+        mask[x] = (clamp(coverage, 0, kFullCoverage) * 255 + (kFullCoverage >> 1)) / kFullCoverage;
+    }
+    for (int x = end; x <= maxX + 1; ++x) {
+        cells[x] = 0;
+    }
+
+    if (minX < end)
+        spanBlender().fillMaskedSpan(_buffer.data() + y * width + minX, end - minX, color, mask + minX);
+}
+
+/*!
+ * \brief Rasterize the spans of a tile with anti-aliasing.
+ * \param tile  the area to draw and the touching spans
+ * \param color  the premultiplied fill color in ABGR raw data format
+ * \param cells  a cleared coverage row, which is used only by this call
+ * \param mask  a mask row, which is used only by this call
+ *
+ * Every pixel row is sampled on GD_ANTIALIAS_LEVEL sub-scanlines. The spans
+ * of a row are accumulated into a sparse coverage row, and only the touched
+ * part of the row is blended into the buffer.
+ *
+ * \internal
+ */
+void GepardSoftware::rasterizeTile(const Tile& tile, const uint32_t color, int32_t* cells, uint8_t* mask)
+{
+    int row = tile.spans.front()->y / GD_ANTIALIAS_LEVEL;
+    int minX = tile.right;
+    int maxX = -1;
+
+    for (const Span* span : tile.spans) {
+        const int y = span->y / GD_ANTIALIAS_LEVEL;
+        if (y != row) {
+            if (minX <= maxX)
+                blendSpan(row, minX, maxX, tile.right, color, cells, mask);
+            row = y;
+            minX = tile.right;
+            maxX = -1;
+        }
+        accumulateSpan(cells, tile.left, tile.right, span->left, span->right, minX, maxX);
+    }
+
+    if (minX <= maxX)
+        blendSpan(row, minX, maxX, tile.right, color, cells, mask);
+}
+
+/*!
+ * \brief Rasterize the spans with anti-aliasing.
+ * \param spans  the output of the TrapezoidTessellator::spanList()
+ * \param color  the fill color
+ *
+ * The spans are binned into the tiles of the surface, and the tiles are
+ * rasterized in parallel when the backend has worker threads. The tiles
+ * don't overlap and every tile keeps the draw order, so the result is the
+ * same as the single-threaded one.
+ *
+ * \internal
+ */
+void GepardSoftware::rasterizeSpans(const SpanList& spans, const Color& color)
+{
+    const int width = _context.surface->width();
+    const int height = _context.surface->height();
+    const int maxSubY = height * GD_ANTIALIAS_LEVEL;
+
+    GD_LOG2("1. Bin '" << spans.size() << "' spans into '" << _tiles.size() << "' tiles.");
+    Float minX = width;
+    Float maxX = 0;
+    int minY = maxSubY;
+    int maxY = 0;
+    const int columns = (width + kTileSize - 1) / kTileSize;
+    const bool isTiled = _tiles.size() > 1;
+
+    for (Tile& tile : _tiles)
+        tile.spans.clear();
+
+    for (const Span& span : spans) {
+        if (span.y < 0 || span.y >= maxSubY || span.right <= 0 || span.left >= width)
+            continue;
+
+        minX = std::min(minX, Float(span.left));
+        maxX = std::max(maxX, Float(span.right));
+        minY = std::min(minY, span.y);
+        maxY = std::max(maxY, span.y);
+
+        if (!isTiled) {
+            _tiles.front().spans.push_back(&span);
+            continue;
+        }
+
+        const int firstColumn = int(std::max(Float(span.left), Float(0.0))) / kTileSize;
+        const int lastColumn = int(std::min(Float(span.right), Float(width - 1))) / kTileSize;
+        Tile* rowTiles = _tiles.data() + span.y / GD_ANTIALIAS_LEVEL / kTileSize * columns;
+        for (int column = firstColumn; column <= lastColumn; ++column)
+            rowTiles[column].spans.push_back(&span);
+    }
+
+    if (minY > maxY)
+        return;
+
+    std::vector<Tile*> usedTiles;
+    for (Tile& tile : _tiles) {
+        if (!tile.spans.empty())
+            usedTiles.push_back(&tile);
+    }
+
+    GD_LOG2("2. Accumulate coverage and blend '" << usedTiles.size() << "' tiles.");
+    const uint32_t premultipliedColor = premultiply(color);
+    const size_t cellsPerWorker = width + 2;
+    if (_threadPool) {
+        _threadPool->run(usedTiles.size(), [this, &usedTiles, premultipliedColor, cellsPerWorker](const size_t job, const unsigned worker) {
+            rasterizeTile(*usedTiles[job], premultipliedColor, _coverage.data() + worker * cellsPerWorker, _masks.data() + worker * cellsPerWorker);
+        });
+    } else {
+        rasterizeTile(*usedTiles.front(), premultipliedColor, _coverage.data(), _masks.data());
+    }
+
+    GD_LOG2("3. Mark the area dirty.");
+    const int left = int(std::max(minX, Float(0.0)));
+    const int right = std::min(int(maxX) + 1, width);
+    const int top = minY / GD_ANTIALIAS_LEVEL;
+    const int bottom = maxY / GD_ANTIALIAS_LEVEL + 1;
+    markDirty(left, top, right, bottom);
+}
+
+/*!
+ * \brief Fill path with Software backend.
+ * \param pathData  the path to fill
+ * \param state  the state which contains the fill color
+ * \param fillRule  the used fill rule
+ */
+void GepardSoftware::fillPath(PathData* pathData, const GepardState& state, const TrapezoidTessellator::FillRule fillRule)
+{
+    if (!pathData || pathData->isEmpty())
+        return;
+
+    TrapezoidTessellator tt(*pathData, fillRule, GD_ANTIALIAS_LEVEL, &_context.edgeTable);
+    const SpanList spanList = tt.spanList(0, _context.surface->height() * GD_ANTIALIAS_LEVEL);
+
+    rasterizeSpans(spanList, state.fillColor);
+}
+
+} // namespace software
+} // namespace gepard
+
+#endif // GD_USE_SOFTWARE
@@ -0,0 +1,124 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef GD_USE_SOFTWARE
+
+#include "gepard-software-thread-pool.h"
+
+#include "gepard-defs.h"
+
+namespace gepard {
+namespace software {
+
+ThreadPool::ThreadPool(const unsigned threadCount)
+    : _nextJob(0)
+{
+    GD_ASSERT(threadCount);
+    for (unsigned worker = 1; worker < threadCount; ++worker) {
+        _threads.push_back(std::thread(&ThreadPool::work, this, worker));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+    _wakeUp.notify_all();
+
+    for (std::thread& thread : _threads) {
+        thread.join();
+    }
+}
+
+/*!
+ * \brief Process the jobs and return when all of them are finished.
+ * \param jobCount  number of the jobs
+ * \param job  function which is called with the job and the worker indices
+ *
+ * The order of the jobs is undefined, but a job is never processed by two
+ * workers at the same time.
+ */
+void ThreadPool::run(const size_t jobCount, const Job& job)
+{
+    if (_threads.empty() || jobCount <= 1) {
+        for (size_t i = 0; i < jobCount; ++i) {
+            job(i, 0);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _job = &job;
+        _jobCount = jobCount;
+        _nextJob = 0;
+        _busyWorkers = _threads.size();
+        _generation++;
+    }
+    _wakeUp.notify_all();
+
+    process(0);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this] { return !_busyWorkers; });
+    _job = nullptr;
+}
+
+void ThreadPool::work(const unsigned worker)
+{
+    unsigned generation = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wakeUp.wait(lock, [this, generation] { return _quit || _generation != generation; });
+            if (_quit)
+                return;
+            generation = _generation;
+        }
+
+        process(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!--_busyWorkers)
+                _done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::process(const unsigned worker)
+{
+    for (size_t i = _nextJob++; i < _jobCount; i = _nextJob++) {
+        (*_job)(i, worker);
+    }
+}
+
+} // namespace software
+} // namespace gepard
+
+#endif // GD_USE_SOFTWARE
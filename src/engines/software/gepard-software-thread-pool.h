@@ -0,0 +1,85 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef GD_USE_SOFTWARE
+
+#ifndef GEPARD_SOFTWARE_THREAD_POOL_H
+#define GEPARD_SOFTWARE_THREAD_POOL_H
+
+#include "gepard-defs.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gepard {
+namespace software {
+
+/*!
+ * \brief The ThreadPool class
+ *
+ * Persistent worker threads which process a batch of independent jobs.
+ * The calling thread works as the first worker, so a pool of N threads
+ * starts only N-1 extra threads.
+ *
+ * \internal
+ */
+class ThreadPool {
+public:
+    typedef std::function<void(const size_t job, const unsigned worker)> Job;
+
+    explicit ThreadPool(const unsigned threadCount);
+    ~ThreadPool();
+
+    const unsigned threadCount() const { return _threads.size() + 1; }
+
+    void run(const size_t jobCount, const Job& job);
+
+private:
+    void work(const unsigned worker);
+    void process(const unsigned worker);
+
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    std::condition_variable _wakeUp;
+    std::condition_variable _done;
+
+    const Job* _job = nullptr;
+    size_t _jobCount = 0;
+    std::atomic<size_t> _nextJob;
+    unsigned _busyWorkers = 0;
+    unsigned _generation = 0;
+    bool _quit = false;
+};
+
+} // namespace software
+} // namespace gepard
+
+#endif // GEPARD_SOFTWARE_THREAD_POOL_H
+
+#endif // GD_USE_SOFTWARE
@@ -27,21 +27,66 @@
 
 #include "gepard-software.h"
 
+#include "gepard-bounding-box.h"
 #include "gepard-color.h"
 #include "gepard-defs.h"
 #include "gepard-float.h"
+#include "gepard-float-point.h"
+#include "gepard-software-blend.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
 
 namespace gepard {
 namespace software {
 
+const int GepardSoftware::kTileSize = 64;
+
 GepardSoftware::GepardSoftware(GepardContext& context)
     : _context(context)
+    , _threadPool(nullptr)
 {
-    _buffer.reserve(context.surface->width() * context.surface->height());
+    const int width = context.surface->width();
+    const int height = context.surface->height();
+    _buffer.resize(width * height);
+    _surfaceBuffer.resize(width * height);
+
+    unsigned threadCount = context.threadCount ? context.threadCount : std::thread::hardware_concurrency();
+    threadCount = std::max(threadCount, 1u);
+
+    if (threadCount > 1) {
+        _threadPool = new ThreadPool(threadCount);
+
+        for (int top = 0; top < height; top += kTileSize) {
+            for (int left = 0; left < width; left += kTileSize) {
+                Tile tile;
+                tile.left = left;
+                tile.top = top;
+                tile.right = std::min(left + kTileSize, width);
+                tile.bottom = std::min(top + kTileSize, height);
+                _tiles.push_back(tile);
+            }
+        }
+    } else {
+        Tile tile;
+        tile.left = 0;
+        tile.top = 0;
+        tile.right = width;
+        tile.bottom = height;
+        _tiles.push_back(tile);
+    }
+
+    // Every worker has its own coverage and mask rows with two extra cells,
+    // because the accumulation writes one cell past the last touched pixel.
+    _coverage.resize((width + 2) * threadCount);
+    _masks.resize((width + 2) * threadCount);
 }
 
 GepardSoftware::~GepardSoftware()
 {
+    if (_threadPool) {
+        delete _threadPool;
+    }
 }
 
 /*!
@@ -50,46 +95,102 @@ GepardSoftware::~GepardSoftware()
  * \param y  Y-axis value of _start_ and _end_ point
  * \param w  size on X-axis
  * \param h  size on Y-axis
+ * \param fillColor  the color of the rect
  *
  */
-void GepardSoftware::fillRect(const Float x, const Float y, const Float w, const Float h)
+void GepardSoftware::fillRect(const Float x, const Float y, const Float w, const Float h, const Color& fillColor)
 {
     GD_LOG1("Fill rect with Software backend (" << x << ", " << y << ", " << w << ", " << h << ")");
 
-    const Color fillColor = _context.currentState().fillColor;
-    const uint32_t width = _context.surface->width();
+    const int width = _context.surface->width();
+    const int height = _context.surface->height();
 
     //! \todo (szledan): anti-aliassing
-    //! \fixme (szledan): checking boundary
-    GD_LOG2("1. Fill destination buffer.");
-    for (int j = y; j < y + h; ++j)
-        for (int i = x; i < x + w; ++i) {
-            uint32_t& dstRaw = _buffer[j * width + i];
-            Color dst = Color::fromRawDataABGR(dstRaw);
-            Color src = fillColor;
-
-            // Apply src-alpha, one-minus-src-alpha blending mode.
-            // Use one-minus-src-alpha on dst.
-            dst *= (1.0f - src.a);
+    const int left = int(clamp(x, Float(0.0), Float(width)));
+    const int top = int(clamp(y, Float(0.0), Float(height)));
+    const int right = int(std::ceil(clamp(x + w, Float(0.0), Float(width))));
+    const int bottom = int(std::ceil(clamp(y + h, Float(0.0), Float(height))));
+    if (left >= right || top >= bottom)
+        return;
+
+    const uint32_t color = premultiply(fillColor);
+    const uint32_t alpha = color >> 24;
+    if (!alpha) {
+        GD_LOG2("Skip the transparent rect.");
+        return;
+    }
 
-            // Use src-alpha on src.
-            src *= src.a;
-
-            dstRaw = Color::toRawDataABGR(src + dst);
+    GD_LOG2("1. Fill destination buffer.");
+    // Opaque colors overwrite the pixels, so there is nothing to blend.
+    const bool isOpaque = (alpha == 255);
+    const SpanBlender::FillSpan fillSpan = isOpaque ? spanBlender().fillOpaqueSpan : spanBlender().fillSpan;
+    if (left == 0 && right == width) {
+        // The rows are continuous.
+        fillSpan(_buffer.data() + top * width, (bottom - top) * width, color);
+    } else {
+        for (int j = top; j < bottom; ++j) {
+            fillSpan(_buffer.data() + j * width + left, right - left, color);
         }
+    }
 
-    GD_LOG2("2. Call drawBuffer method of surface.");
-    _context.surface->drawBuffer(_buffer.data());
+    GD_LOG2("2. Mark the area dirty.");
+    markDirty(left, top, right, bottom);
 }
 
-void GepardSoftware::fill()
+/*!
+ * \brief Record a changed rectangle of the buffer.
+ * \param left  the first column
+ * \param top  the first row
+ * \param right  the column after the last one
+ * \param bottom  the row after the last one
+ *
+ * The area is copied to the surface by the next flush().
+ *
+ * \internal
+ */
+void GepardSoftware::markDirty(const int left, const int top, const int right, const int bottom)
 {
-    GD_NOT_IMPLEMENTED();
+    BoundingBox bb;
+    bb.stretch(FloatPoint(left, top));
+    bb.stretch(FloatPoint(right, bottom));
+    _dirtyRegion.add(bb);
 }
 
-void GepardSoftware::stroke()
+/*!
+ * \brief Present the changed areas of the buffer on the surface.
+ *
+ * The _buffer holds premultiplied pixels, but the surfaces expect
+ * non-premultiplied ones, so only the dirty areas are converted and
+ * passed to the surface.
+ */
+void GepardSoftware::flush()
 {
-    GD_NOT_IMPLEMENTED();
+    if (_dirtyRegion.isEmpty()) {
+        _context.surface->frameReady(_context.frameCount);
+        return;
+    }
+
+    const int width = _context.surface->width();
+    std::vector<Surface::Rect> rects;
+    rects.reserve(_dirtyRegion.boxes().size());
+
+    for (const BoundingBox& box : _dirtyRegion.boxes()) {
+        const int left = int(box.minX);
+        const int top = int(box.minY);
+        const int right = int(box.maxX);
+        const int bottom = int(box.maxY);
+
+        for (int j = top; j < bottom; ++j) {
+            const int offset = j * width + left;
+            unpremultiplySpan(_buffer.data() + offset, _surfaceBuffer.data() + offset, right - left);
+        }
+        rects.push_back({ uint32_t(left), uint32_t(top), uint32_t(right - left), uint32_t(bottom - top) });
+    }
+
+    GD_LOG2("Present " << rects.size() << " dirty rects.");
+    _context.surface->drawBufferRects(_surfaceBuffer.data(), rects);
+    _dirtyRegion.clear();
+    _context.surface->frameReady(_context.frameCount);
 }
 
 } // namespace software
@@ -33,8 +33,15 @@
 #include "gepard-color.h"
 #include "gepard-context.h"
 #include "gepard-defs.h"
+#include "gepard-dirty-region.h"
+#include "gepard-engine-backend.h"
 #include "gepard-float.h"
 #include "gepard-image.h"
+#include "gepard-path.h"
+#include "gepard-software-blend.h"
+#include "gepard-software-thread-pool.h"
+#include "gepard-state.h"
+#include "gepard-trapezoid-tessellator.h"
 #include "gepard.h"
 #include <vector>
 
@@ -45,24 +52,55 @@ class Surface;
 
 namespace software {
 
-class GepardSoftware {
+/*!
+ * \brief The Tile struct
+ *
+ * A [left, right) x [top, bottom) pixel area of the surface and the
+ * spans of the current draw which touch it, sorted by their sub-scanlines.
+ *
+ * \internal
+ */
+struct Tile {
+    int left;
+    int top;
+    int right;
+    int bottom;
+    std::vector<const Span*> spans;
+};
+
+class GepardSoftware : public GepardEngineBackend {
 public:
+    static const int kTileSize;
+
     explicit GepardSoftware(GepardContext&);
-    ~GepardSoftware();
+    virtual ~GepardSoftware();
+
+    virtual const Gepard::Backend type() const { return Gepard::SoftwareBackend; }
 
-    void fillRect(const Float x, const Float y, const Float w, const Float h);
-    void fill();
-    void stroke();
+    virtual void fillRect(const Float x, const Float y, const Float w, const Float h, const Color& fillColor);
+    virtual void fillPath(PathData*, const GepardState&, const TrapezoidTessellator::FillRule = TrapezoidTessellator::NonZero);
+    virtual void strokePath(PathData*, const GepardState&);
+    virtual void flush();
+    virtual void finish() {}
 
 private:
+    void rasterizeSpans(const SpanList&, const Color&);
+    void rasterizeTile(const Tile&, const uint32_t color, int32_t* cells, uint8_t* mask);
+    void blendSpan(const int y, const int minX, const int maxX, const int right, const uint32_t color, int32_t* cells, uint8_t* mask);
+    void markDirty(const int left, const int top, const int right, const int bottom);
+
     GepardContext& _context;
-    std::vector<uint32_t> _buffer;
+    std::vector<uint32_t> _buffer; //!< Premultiplied pixels.
+    std::vector<uint32_t> _surfaceBuffer; //!< Non-premultiplied copy of the _buffer for the surface.
+    std::vector<int32_t> _coverage;
+    std::vector<uint8_t> _masks;
+    std::vector<Tile> _tiles;
+    DirtyRegion _dirtyRegion; //!< Changed areas of the _buffer since the last flush.
+    ThreadPool* _threadPool;
 };
 
 } // namespace software
 
-typedef software::GepardSoftware GepardEngineBackend;
-
 } // namespace gepard
 
 #endif // GEPARD_SOFTWARE_H
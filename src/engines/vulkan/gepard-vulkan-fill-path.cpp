@@ -0,0 +1,253 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef GD_USE_VULKAN
+
+#include "gepard-vulkan.h"
+
+#include "gepard-bounding-box.h"
+#include "gepard-defs.h"
+#include "gepard-float.h"
+#include "gepard-state.h"
+#include "gepard-trapezoid-tessellator.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace gepard {
+namespace vulkan {
+
+//! Number of the floats of a trapezoid: the Xs and the Ys.
+static const uint32_t s_trapezoidStride = 6;
+
+/*!
+ * \brief Fill a path with Vulkan backend.
+ *
+ * It is the port of the GLES2 trapezoid coverage approach: the coverage of
+ * the trapezoids is accumulated in the _coverageImage, which is copied to the
+ * surface image with the fill color.  The trapezoids are drawn instanced
+ * from the device local _trapezoidBuffer, see drawTrapezoidCoverage().
+ */
+void GepardVulkan::fillPath(PathData* pathData, const GepardState& state, const TrapezoidTessellator::FillRule fillRule)
+{
+    if (pathData->isEmpty())
+        return;
+
+    const uint32_t width = _context.surface->width();
+    const uint32_t height = _context.surface->height();
+
+    TrapezoidTessellator tt(*pathData, fillRule, GD_ANTIALIAS_LEVEL, &_context.edgeTable);
+    const TrapezoidList trapezoidList = tt.trapezoidList();
+
+    // The coverage is written only inside the bounding box of the path
+    // (with a safety pixel for the rounding of the tessellator).
+    const BoundingBox& bb = tt.boundingBox();
+    BoundingBox coverageBox;
+    coverageBox.stretch(FloatPoint(clamp(std::floor(bb.minX) - 1, Float(0), Float(width)), clamp(std::floor(bb.minY) - 1, Float(0), Float(height))));
+    coverageBox.stretch(FloatPoint(clamp(std::ceil(bb.maxX) + 1, Float(0), Float(width)), clamp(std::ceil(bb.maxY) + 1, Float(0), Float(height))));
+    if (coverageBox.isEmpty())
+        return;
+
+    // The same order as the attributes of the GLES2 backend.
+    std::vector<float> trapezoids;
+    trapezoids.reserve(trapezoidList.size() * s_trapezoidStride);
+    for (const Trapezoid& trapezoid : trapezoidList) {
+        GD_ASSERT(trapezoid.topY < trapezoid.bottomY);
+        GD_ASSERT(trapezoid.topLeftX <= trapezoid.topRightX);
+        GD_ASSERT(trapezoid.bottomLeftX <= trapezoid.bottomRightX);
+
+        if (!trapezoid.leftId || !trapezoid.rightId)
+            continue;
+
+        trapezoids.push_back(trapezoid.bottomLeftX);
+        trapezoids.push_back(trapezoid.bottomRightX);
+        trapezoids.push_back(trapezoid.topLeftX);
+        trapezoids.push_back(trapezoid.topRightX);
+        trapezoids.push_back(trapezoid.bottomY);
+        trapezoids.push_back(trapezoid.topY);
+    }
+
+    if (trapezoids.empty())
+        return;
+
+    const PathPushConstants pushConstants = {
+        { float(width), float(height) },
+        { 0.0f, 0.0f },
+        { float(state.fillColor.r), float(state.fillColor.g), float(state.fillColor.b), float(state.fillColor.a) },
+    };
+
+    const VkClearRect clearRect = {
+        {
+            {
+                int32_t(coverageBox.minX),                      // int32_t x
+                int32_t(coverageBox.minY),                      // int32_t y
+            },  // VkOffset2D    offset;
+            {
+                uint32_t(coverageBox.maxX - coverageBox.minX),  // uint32_t    width
+                uint32_t(coverageBox.maxY - coverageBox.minY),  // uint32_t    height
+            }, // VkExtent2D    extent;
+        },      // VkRect2D    rect;
+        0u,     // uint32_t    baseArrayLayer;
+        1u,     // uint32_t    layerCount;
+    };
+
+    const uint32_t trapezoidCount = trapezoids.size() / s_trapezoidStride;
+    const uint32_t maximumTrapezoidCount = kTrapezoidBufferSize / (s_trapezoidStride * sizeof(float));
+    for (uint32_t first = 0; first < trapezoidCount; first += maximumTrapezoidCount) {
+        const uint32_t count = std::min(trapezoidCount - first, maximumTrapezoidCount);
+        // Only the first part clears the coverage.
+        drawTrapezoidCoverage(trapezoids.data() + first * s_trapezoidStride, count, pushConstants, first ? nullptr : &clearRect);
+    }
+
+    // Copy the coverage of the bounding box to the surface image.
+    const float left = coverageBox.minX;
+    const float top = coverageBox.minY;
+    const float right = coverageBox.maxX;
+    const float bottom = coverageBox.maxY;
+    const float vertexData[] = {
+        left, top,
+        right, top,
+        left, bottom,
+        right, bottom,
+    };
+
+    const VkDeviceSize vertexBufferOffset = uploadVertexData(vertexData, (VkDeviceSize)sizeof(vertexData));
+    const VkCommandBuffer commandBuffer = _frames[_currentFrame].commandBuffer;
+
+    _vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, getPipeline(CopyPathPipeline));
+    _vk.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _pipelineLayout, 0, 1, &_coverageDescriptorSet, 0, nullptr);
+    _vk.vkCmdPushConstants(commandBuffer, _pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(pushConstants), &pushConstants);
+    _vk.vkCmdBindVertexBuffers(commandBuffer, 0, 1, &_vertexRing.buffer, &vertexBufferOffset);
+    _vk.vkCmdBindIndexBuffer(commandBuffer, _rectIndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+
+    const uint32_t indexCount = 6;
+    _vk.vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, 0, 0);
+}
+
+/*!
+ * \brief Accumulate the coverage of the trapezoids in the _coverageImage.
+ * \param clearRect  the area which is cleared before the drawing, or nullptr
+ *
+ * The trapezoids are staged in the _vertexRing and copied into the device
+ * local _trapezoidBuffer.  The copy and the coverage pass are outside of the
+ * render pass of the surface, which is restarted at the end.
+ *
+ * \internal
+ */
+void GepardVulkan::drawTrapezoidCoverage(const float* trapezoids, const uint32_t trapezoidCount, const PathPushConstants& pushConstants, const VkClearRect* clearRect)
+{
+    const VkDeviceSize size = trapezoidCount * s_trapezoidStride * sizeof(float);
+    GD_ASSERT(size <= kTrapezoidBufferSize);
+
+    // The upload can submit the frame, so the commands are recorded after it.
+    const VkDeviceSize stagingOffset = uploadVertexData(trapezoids, size);
+    const VkCommandBuffer commandBuffer = _frames[_currentFrame].commandBuffer;
+
+    _vk.vkCmdEndRenderPass(commandBuffer);
+
+    // The previous coverage pass must finish reading the buffer before the copy.
+    const VkBufferMemoryBarrier preCopyBarrier = {
+        VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,    // VkStructureType    sType;
+        nullptr,                                    // const void*        pNext;
+        VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,        // VkAccessFlags      srcAccessMask;
+        VK_ACCESS_TRANSFER_WRITE_BIT,               // VkAccessFlags      dstAccessMask;
+        VK_QUEUE_FAMILY_IGNORED,                    // uint32_t           srcQueueFamilyIndex;
+        VK_QUEUE_FAMILY_IGNORED,                    // uint32_t           dstQueueFamilyIndex;
+        _trapezoidBuffer,                           // VkBuffer           buffer;
+        0u,                                         // VkDeviceSize       offset;
+        size,                                       // VkDeviceSize       size;
+    };
+
+    const VkBufferMemoryBarrier postCopyBarrier = {
+        VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,    // VkStructureType    sType;
+        nullptr,                                    // const void*        pNext;
+        VK_ACCESS_TRANSFER_WRITE_BIT,               // VkAccessFlags      srcAccessMask;
+        VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,        // VkAccessFlags      dstAccessMask;
+        VK_QUEUE_FAMILY_IGNORED,                    // uint32_t           srcQueueFamilyIndex;
+        VK_QUEUE_FAMILY_IGNORED,                    // uint32_t           dstQueueFamilyIndex;
+        _trapezoidBuffer,                           // VkBuffer           buffer;
+        0u,                                         // VkDeviceSize       offset;
+        size,                                       // VkDeviceSize       size;
+    };
+
+    const VkBufferCopy region = {
+        stagingOffset,  // VkDeviceSize    srcOffset;
+        0u,             // VkDeviceSize    dstOffset;
+        size,           // VkDeviceSize    size;
+    };
+
+    _vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, (VkDependencyFlags)0, 0, (const VkMemoryBarrier*)nullptr, 1, &preCopyBarrier, 0, (const VkImageMemoryBarrier*)nullptr);
+    _vk.vkCmdCopyBuffer(commandBuffer, _vertexRing.buffer, _trapezoidBuffer, 1, &region);
+    _vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, (VkDependencyFlags)0, 0, (const VkMemoryBarrier*)nullptr, 1, &postCopyBarrier, 0, (const VkImageMemoryBarrier*)nullptr);
+
+    const VkRect2D renderArea = {
+        {
+            0,                              // int32_t x
+            0,                              // int32_t y
+        },  // VkOffset2D    offset;
+        {
+            _context.surface->width(),      // uint32_t    width
+            _context.surface->height(),     // uint32_t    height
+        }, // VkExtent2D    extent;
+    };
+
+    const VkRenderPassBeginInfo renderPassInfo = {
+        VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,   // VkStructureType        sType;
+        nullptr,                                    // const void*            pNext;
+        _coverageRenderPass,                        // VkRenderPass           renderPass;
+        _coverageFrameBuffer,                       // VkFramebuffer          framebuffer;
+        renderArea,                                 // VkRect2D               renderArea;
+        0u,                                         // uint32_t               clearValueCount;
+        nullptr,                                    // const VkClearValue*    pClearValues;
+    };
+
+    _vk.vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+    if (clearRect) {
+        const VkClearAttachment clearAttachment = {
+            VK_IMAGE_ASPECT_COLOR_BIT,  // VkImageAspectFlags    aspectMask;
+            0u,                         // uint32_t              colorAttachment;
+            { 0.0, 0.0, 0.0, 0.0 },     // VkClearValue          clearValue;
+        };
+
+        _vk.vkCmdClearAttachments(commandBuffer, 1, &clearAttachment, 1, clearRect);
+    }
+
+    const VkDeviceSize vertexBufferOffset = 0u;
+    _vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, getPipeline(FillPathPipeline));
+    _vk.vkCmdPushConstants(commandBuffer, _pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(pushConstants), &pushConstants);
+    _vk.vkCmdBindVertexBuffers(commandBuffer, 0, 1, &_trapezoidBuffer, &vertexBufferOffset);
+
+    GD_LOG2("Draw '" << trapezoidCount << "' trapezoids with instanced triangle strips.");
+    _vk.vkCmdDraw(commandBuffer, 4, trapezoidCount, 0, 0);
+
+    _vk.vkCmdEndRenderPass(commandBuffer);
+    beginSurfaceRenderPass(commandBuffer);
+}
+
+} // namespace vulkan
+} // namespace gepard
+
+#endif // GD_USE_VULKAN
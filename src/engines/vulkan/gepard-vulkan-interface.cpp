@@ -39,8 +39,8 @@ GepardVulkanInterface::GepardVulkanInterface(const char *libraryName)
 
 GepardVulkanInterface::~GepardVulkanInterface()
 {
-    GD_ASSERT(_vulkanLibrary);
-    dlclose(_vulkanLibrary);
+    if (_vulkanLibrary)
+        dlclose(_vulkanLibrary);
 }
 
 void GepardVulkanInterface::loadGlobalFunctions()
@@ -68,6 +68,17 @@ void GepardVulkanInterface::loadInstanceFunctions(const VkInstance instance)
 
     GD_VK_INSTANCE_FUNTION_LIST(GD_VK_LOAD_FUNCTION)
 
+#undef GD_VK_LOAD_FUNCTION
+}
+
+void GepardVulkanInterface::loadSurfaceFunctions(const VkInstance instance)
+{
+#define GD_VK_LOAD_FUNCTION(fun)\
+    fun = (PFN_##fun) vkGetInstanceProcAddr (instance, #fun); \
+    GD_ASSERT(fun && "Couldn't load " #fun "!");
+
+    GD_VK_SURFACE_FUNTION_LIST(GD_VK_LOAD_FUNCTION)
+
 #if defined(VK_USE_PLATFORM_XLIB_KHR)
     GD_VK_LOAD_FUNCTION(vkCreateXlibSurfaceKHR);
 #endif // VK_USE_PLATFORM_XLIB_KHR
@@ -86,6 +97,17 @@ void GepardVulkanInterface::loadDeviceFunctions(const VkDevice device)
 #undef GD_VK_LOAD_FUNCTION
 }
 
+void GepardVulkanInterface::loadSwapchainFunctions(const VkDevice device)
+{
+#define GD_VK_LOAD_FUNCTION(fun)\
+    fun = (PFN_##fun) vkGetDeviceProcAddr (device, #fun); \
+    GD_ASSERT(fun && "Couldn't load " #fun "!");
+
+    GD_VK_SWAPCHAIN_FUNTION_LIST(GD_VK_LOAD_FUNCTION)
+
+#undef GD_VK_LOAD_FUNCTION
+}
+
 } // namespace vulkan
 } // namespace gepard
 
@@ -52,7 +52,10 @@ namespace vulkan {
     FUNC(vkCreateDevice); \
     FUNC(vkGetDeviceProcAddr); \
     FUNC(vkGetPhysicalDeviceMemoryProperties); \
-    FUNC(vkGetPhysicalDeviceFeatures); \
+    FUNC(vkGetPhysicalDeviceFeatures);
+
+// Instance level vulkan functions of the surface extensions
+#define GD_VK_SURFACE_FUNTION_LIST(FUNC) \
     FUNC(vkDestroySurfaceKHR); \
     FUNC(vkGetPhysicalDeviceSurfaceFormatsKHR); \
     FUNC(vkGetPhysicalDeviceSurfaceCapabilitiesKHR); \
@@ -61,6 +64,7 @@ namespace vulkan {
 // Device level vulkan functions
 #define GD_VK_DEVICE_FUNTION_LIST(FUNC) \
     FUNC(vkDestroyDevice); \
+    FUNC(vkDeviceWaitIdle); \
     FUNC(vkGetDeviceQueue); \
     FUNC(vkCreateCommandPool); \
     FUNC(vkResetCommandPool); \
@@ -86,10 +90,21 @@ namespace vulkan {
     FUNC(vkFreeMemory); \
     FUNC(vkCreateGraphicsPipelines); \
     FUNC(vkDestroyPipeline); \
+    FUNC(vkCreatePipelineCache); \
+    FUNC(vkDestroyPipelineCache); \
+    FUNC(vkGetPipelineCacheData); \
     FUNC(vkCreateShaderModule); \
     FUNC(vkDestroyShaderModule); \
     FUNC(vkCreatePipelineLayout); \
     FUNC(vkDestroyPipelineLayout); \
+    FUNC(vkCreateDescriptorSetLayout); \
+    FUNC(vkDestroyDescriptorSetLayout); \
+    FUNC(vkCreateDescriptorPool); \
+    FUNC(vkDestroyDescriptorPool); \
+    FUNC(vkAllocateDescriptorSets); \
+    FUNC(vkUpdateDescriptorSets); \
+    FUNC(vkCreateSampler); \
+    FUNC(vkDestroySampler); \
     FUNC(vkCmdBeginRenderPass); \
     FUNC(vkCmdEndRenderPass); \
     FUNC(vkCreateBuffer); \
@@ -99,13 +114,19 @@ namespace vulkan {
     FUNC(vkInvalidateMappedMemoryRanges); \
     FUNC(vkUnmapMemory); \
     FUNC(vkCmdBindPipeline); \
+    FUNC(vkCmdBindDescriptorSets); \
+    FUNC(vkCmdPushConstants); \
     FUNC(vkCmdDraw); \
     FUNC(vkCmdDrawIndexed); \
     FUNC(vkCmdDrawIndirect); \
     FUNC(vkCmdDrawIndexedIndirect); \
     FUNC(vkCreateFence); \
     FUNC(vkDestroyFence); \
+    FUNC(vkGetFenceStatus); \
     FUNC(vkWaitForFences); \
+    FUNC(vkResetFences); \
+    FUNC(vkCreateSemaphore); \
+    FUNC(vkDestroySemaphore); \
     FUNC(vkCmdBindVertexBuffers); \
     FUNC(vkCmdBindIndexBuffer); \
     FUNC(vkCmdPipelineBarrier); \
@@ -115,7 +136,10 @@ namespace vulkan {
     FUNC(vkCmdCopyImage); \
     FUNC(vkCmdBlitImage); \
     FUNC(vkCmdClearColorImage); \
-    FUNC(vkCmdClearAttachments); \
+    FUNC(vkCmdClearAttachments);
+
+// Device level vulkan functions of the swapchain extension
+#define GD_VK_SWAPCHAIN_FUNTION_LIST(FUNC) \
     FUNC(vkCreateSwapchainKHR); \
     FUNC(vkDestroySwapchainKHR); \
     FUNC(vkGetSwapchainImagesKHR); \
@@ -129,7 +153,11 @@ public:
 
     void loadGlobalFunctions();
     void loadInstanceFunctions(const VkInstance instance);
+    void loadSurfaceFunctions(const VkInstance instance);
     void loadDeviceFunctions(const VkDevice device);
+    void loadSwapchainFunctions(const VkDevice device);
+
+    const bool isLoaded() const { return _vulkanLibrary; }
 
 #define GD_VK_DECLARE_FUNCTION(fun) PFN_##fun fun
 
@@ -138,11 +166,13 @@ public:
     GD_VK_GLOBAL_FUNTION_LIST(GD_VK_DECLARE_FUNCTION)
 
     GD_VK_INSTANCE_FUNTION_LIST(GD_VK_DECLARE_FUNCTION)
+    GD_VK_SURFACE_FUNTION_LIST(GD_VK_DECLARE_FUNCTION)
 #if defined(VK_USE_PLATFORM_XLIB_KHR)
     GD_VK_DECLARE_FUNCTION(vkCreateXlibSurfaceKHR);
 #endif // VK_USE_PLATFORM_XLIB_KHR
 
     GD_VK_DEVICE_FUNTION_LIST(GD_VK_DECLARE_FUNCTION)
+    GD_VK_SWAPCHAIN_FUNTION_LIST(GD_VK_DECLARE_FUNCTION)
 
 #undef GD_VK_DECLARE_FUNCTION
 
@@ -27,7 +27,15 @@
 
 #include "gepard-vulkan.h"
 
+#include "copy-path.frag.h"
+#include "copy-path.vert.h"
+#include "fill-path.frag.h"
+#include "fill-path.vert.h"
+#include "fill-rect.frag.h"
+#include "fill-rect.vert.h"
 #include "gepard-float.h"
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <string>
@@ -42,36 +50,108 @@
 namespace gepard {
 namespace vulkan {
 
-static const uint64_t oneMiliSec = 1000000;
-static const uint64_t timeout = (uint64_t)16 * oneMiliSec; // 16 ms
+const uint32_t GepardVulkan::kFramesInFlight = 2;
+const VkDeviceSize GepardVulkan::kVertexRingSize = 1024 * 1024;
+const VkDeviceSize GepardVulkan::kTrapezoidBufferSize = 256 * 1024;
+const VkDeviceSize GepardVulkan::kMemoryBlockSize = 16 * 1024 * 1024;
+
+/*!
+ * \brief Check whether the Vulkan loader is installed and it has a device.
+ *
+ * The surface is not checked yet, createSwapChain() expects an X11 display.
+ */
+const bool GepardVulkan::isAvailable(Surface*)
+{
+    GepardVulkanInterface vk("libvulkan.so");
+    if (!vk.isLoaded()) {
+        return false;
+    }
+    vk.loadGlobalFunctions();
+
+    const VkInstanceCreateInfo instanceCreateInfo = {
+        VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO, // VkStructureType             sType;
+        nullptr,                                // const void*                 pNext;
+        0u,                                     // VkInstanceCreateFlags       flags;
+        nullptr,                                // const VkApplicationInfo*    pApplicationInfo;
+        0u,                                     // uint32_t                    enabledLayerCount;
+        nullptr,                                // const char* const*          ppEnabledLayerNames;
+        0u,                                     // uint32_t                    enabledExtensionCount;
+        nullptr,                                // const char* const*          ppEnabledExtensionNames;
+    };
+
+    VkInstance instance = 0;
+    if (vk.vkCreateInstance(&instanceCreateInfo, nullptr, &instance) != VK_SUCCESS) {
+        return false;
+    }
+
+    // Only these two are needed, loadInstanceFunctions() would assert on
+    // the functions of the not enabled extensions.
+    const PFN_vkEnumeratePhysicalDevices enumeratePhysicalDevices = (PFN_vkEnumeratePhysicalDevices)vk.vkGetInstanceProcAddr(instance, "vkEnumeratePhysicalDevices");
+    const PFN_vkDestroyInstance destroyInstance = (PFN_vkDestroyInstance)vk.vkGetInstanceProcAddr(instance, "vkDestroyInstance");
+
+    uint32_t deviceCount = 0;
+    if (enumeratePhysicalDevices) {
+        enumeratePhysicalDevices(instance, &deviceCount, nullptr);
+    }
+    if (destroyInstance) {
+        destroyInstance(instance, nullptr);
+    }
+
+    return deviceCount > 0;
+}
 
 GepardVulkan::GepardVulkan(GepardContext& context)
     : _context(context)
     , _vk("libvulkan.so")
     , _allocator(nullptr)
     , _instance(0)
+    , _bufferImageGranularity(1)
     , _imageFormat(VK_FORMAT_R8G8B8A8_UNORM)
     , _wsiSurface(0)
     , _wsiSwapChain(0)
+    , _pipelineCache(0)
+    , _pipelineLayout(0)
+    , _currentFrame(0)
+    , _rectIndexBuffer(0)
+    , _trapezoidBuffer(0)
+    , _coverageRenderPass(0)
+    , _coverageImage(0)
+    , _coverageImageView(0)
+    , _coverageFrameBuffer(0)
+    , _coverageSampler(0)
+    , _descriptorSetLayout(0)
+    , _descriptorPool(0)
 {
     GD_LOG1("GepardVulkan");
     _vk.loadGlobalFunctions();
     GD_LOG2(" - Global functions are loaded");
     createDefaultInstance();
     _vk.loadInstanceFunctions(_instance);
+    if (_context.surface->getDisplay())
+        _vk.loadSurfaceFunctions(_instance);
     GD_LOG2(" - Instance functions are loaded");
     chooseDefaultDevice();
     _vk.loadDeviceFunctions(_device);
+    if (_context.surface->getDisplay())
+        _vk.loadSwapchainFunctions(_device);
     GD_LOG2(" - Device functions are loaded");
     createCommandPool();
-    allocatePrimaryCommandBuffer();
-    GD_LOG2(" - Command buffer is allocated");
+    allocatePrimaryCommandBuffers();
+    GD_LOG2(" - Command buffers are allocated");
+    createFrames();
+    GD_LOG2(" - Frames are created");
     createDefaultRenderPass();
     GD_LOG2(" - Default render pass is created");
     createSurfaceImage();
     GD_LOG2(" - Surface backing image is created");
     createDefaultFrameBuffer();
     GD_LOG2(" - Default frame buffer is created");
+    createCoverageTarget();
+    GD_LOG2(" - Path coverage target is created");
+    createDefaultBuffers();
+    GD_LOG2(" - Vertex ring and index buffer are created");
+    createPipelineCache();
+    GD_LOG2(" - Pipeline cache is created");
     if (_context.surface->getDisplay())
         createSwapChain();
 }
@@ -79,6 +159,57 @@ GepardVulkan::GepardVulkan(GepardContext& context)
 GepardVulkan::~GepardVulkan()
 {
     //! \todo (kkristof) it would be extremely usefull to have container classes for these
+    if (_device) {
+        _vk.vkDeviceWaitIdle(_device);
+        completeReadbacks(true);
+    }
+#ifdef GD_LOG_LEVEL
+    const BlockAllocator::Statistics statistics = memoryStatistics();
+    GD_LOG1("Device memory: " << statistics.blockCount << " blocks, " << statistics.reservedBytes << " bytes reserved, "
+        << statistics.usedBytes << " bytes used, " << statistics.fragmentedBytes << " bytes fragmented");
+#endif // GD_LOG_LEVEL
+    for (auto& frame: _frames) {
+        _vk.vkDestroyFence(_device, frame.fence, _allocator);
+        _vk.vkDestroySemaphore(_device, frame.imageAcquired, _allocator);
+        _vk.vkDestroySemaphore(_device, frame.renderFinished, _allocator);
+    }
+    for (auto& pipeline: _pipelines) {
+        _vk.vkDestroyPipeline(_device, pipeline.second, _allocator);
+    }
+    if (_pipelineLayout) {
+        _vk.vkDestroyPipelineLayout(_device, _pipelineLayout, _allocator);
+    }
+    if (_descriptorPool) {
+        _vk.vkDestroyDescriptorPool(_device, _descriptorPool, _allocator);
+    }
+    if (_descriptorSetLayout) {
+        _vk.vkDestroyDescriptorSetLayout(_device, _descriptorSetLayout, _allocator);
+    }
+    if (_coverageSampler) {
+        _vk.vkDestroySampler(_device, _coverageSampler, _allocator);
+    }
+    if (_coverageFrameBuffer) {
+        _vk.vkDestroyFramebuffer(_device, _coverageFrameBuffer, _allocator);
+    }
+    if (_coverageImageView) {
+        _vk.vkDestroyImageView(_device, _coverageImageView, _allocator);
+    }
+    if (_coverageImage) {
+        _vk.vkDestroyImage(_device, _coverageImage, _allocator);
+    }
+    if (_coverageRenderPass) {
+        _vk.vkDestroyRenderPass(_device, _coverageRenderPass, _allocator);
+    }
+    if (_pipelineCache) {
+        savePipelineCache();
+        _vk.vkDestroyPipelineCache(_device, _pipelineCache, _allocator);
+    }
+    for (auto& shaderModule: _shaderModules) {
+        _vk.vkDestroyShaderModule(_device, shaderModule.second, _allocator);
+    }
+    for (auto& buffer: _buffers) {
+        _vk.vkDestroyBuffer(_device, buffer, _allocator);
+    }
     if (_frameBuffer) {
         _vk.vkDestroyFramebuffer(_device, _frameBuffer, _allocator);
     }
@@ -97,8 +228,10 @@ GepardVulkan::~GepardVulkan()
     if (_primaryCommandBuffers.size()) {
         _vk.vkFreeCommandBuffers(_device, _commandPool, _primaryCommandBuffers.size(), _primaryCommandBuffers.data());
     }
-    for (auto& allocation: _memoryAllocations) {
-        _vk.vkFreeMemory(_device, allocation, _allocator);
+    for (auto& pool: _memoryPools) {
+        for (auto& block: pool.second.blocks) {
+            _vk.vkFreeMemory(_device, block, _allocator);
+        }
     }
     if (_commandPool) {
         _vk.vkDestroyCommandPool(_device, _commandPool, _allocator);
@@ -117,13 +250,13 @@ GepardVulkan::~GepardVulkan()
     }
 }
 
-void GepardVulkan::fillRect(const Float x, const Float y, const Float w, const Float h)
+void GepardVulkan::fillRect(const Float x, const Float y, const Float w, const Float h, const Color& fillColor)
 {
     // Vertex data setup
-    const float r = _context.currentState().fillColor.r;
-    const float g = _context.currentState().fillColor.g;
-    const float b = _context.currentState().fillColor.b;
-    const float a = _context.currentState().fillColor.a;
+    const float r = fillColor.r;
+    const float g = fillColor.g;
+    const float b = fillColor.b;
+    const float a = fillColor.a;
 
     const float left = (float)((2.0 * x / (float)_context.surface->width()) - 1.0);
     const float right = (float)((2.0 * (x + w) / (float)_context.surface->width()) - 1.0);
@@ -137,449 +270,230 @@ void GepardVulkan::fillRect(const Float x, const Float y, const Float w, const F
         right, bottom, 1.0, 1.0, r, g, b, a,
     };
 
-    const uint32_t rectIndicies[] = {0, 1, 2, 2, 1, 3};
+    const VkDeviceSize vertexBufferOffset = uploadVertexData(vertexData, (VkDeviceSize)sizeof(vertexData));
 
-    const VkBufferCreateInfo vertexBufferInfo = {
-        VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,   // VkStructureType        sType;
-        nullptr,                                // const void*            pNext;
-        0,                                      // VkBufferCreateFlags    flags;
-        (VkDeviceSize)sizeof(vertexData),       // VkDeviceSize           size;
-        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,      // VkBufferUsageFlags     usage;
-        VK_SHARING_MODE_EXCLUSIVE,              // VkSharingMode          sharingMode;
-        1u,                                     // uint32_t               queueFamilyIndexCount;
-        &_queueFamilyIndex,                     // const uint32_t*        pQueueFamilyIndices;
-    };
+    // Drawing
 
-    VkBuffer vertexBuffer;
-    VkDeviceMemory vertexBufferMemory;
-    VkDeviceSize vertexBufferOffset = 0;
+    const VkCommandBuffer commandBuffer = _frames[_currentFrame].commandBuffer;
 
-    _vk.vkCreateBuffer(_device, &vertexBufferInfo, _allocator, &vertexBuffer);
+    _vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, getPipeline(FillRectPipeline));
 
-    // Upload vertex data.
-    {
-        VkMemoryRequirements memoryRequirements;
-        _vk.vkGetBufferMemoryRequirements(_device, vertexBuffer, &memoryRequirements);
-        const VkMemoryAllocateInfo allocationInfo = {
-            VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,                                         // VkStructureType    sType;
-            nullptr,                                                                        // const void*        pNext;
-            memoryRequirements.size,                                                        // VkDeviceSize       allocationSize;
-            getMemoryTypeIndex(memoryRequirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT),    // uint32_t           memoryTypeIndex;
-        };
+    _vk.vkCmdBindVertexBuffers(commandBuffer, 0, 1, &_vertexRing.buffer, &vertexBufferOffset);
+    _vk.vkCmdBindIndexBuffer(commandBuffer, _rectIndexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
-        _vk.vkAllocateMemory(_device, &allocationInfo, _allocator, &vertexBufferMemory);
-        _vk.vkBindBufferMemory(_device, vertexBuffer, vertexBufferMemory, vertexBufferOffset);
+    const uint32_t indexCount = 6;
+    _vk.vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, 0, 0);
+}
 
-        void* data;
-        _vk.vkMapMemory(_device, vertexBufferMemory, 0, (VkDeviceSize)sizeof(vertexData), 0, &data);
+/*!
+ * \brief Submit the recorded frame and present it on the surface.
+ *
+ * The CPU never waits for the GPU here: it can run kFramesInFlight frames
+ * ahead of it. The memory buffer surfaces receive the frame later, see
+ * completeReadbacks().
+ */
+void GepardVulkan::flush()
+{
+    submitFrame(true);
+}
 
-        std::memcpy(data, vertexData, (VkDeviceSize)sizeof(vertexData));
+/*!
+ * \brief Wait for the GPU and deliver every pending readback to the surface.
+ */
+void GepardVulkan::finish()
+{
+    completeReadbacks(true);
+}
 
-        const VkMappedMemoryRange range = {
-            VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,  // VkStructureType    sType;
-            nullptr,                                // const void*        pNext;
-            vertexBufferMemory,                     // VkDeviceMemory     memory;
-            0,                                      // VkDeviceSize       offset;
-            (VkDeviceSize)sizeof(vertexData),       // VkDeviceSize       size;
-        };
+/*!
+ * \brief Start recording the current frame, if it is not started yet.
+ *
+ * It blocks only if the GPU has not finished the kFramesInFlight-th
+ * previous frame, which used the same command buffer.
+ *
+ * \internal
+ */
+void GepardVulkan::beginFrame()
+{
+    Frame& frame = _frames[_currentFrame];
 
-        _vk.vkFlushMappedMemoryRanges(_device, 1, &range);
-        _vk.vkUnmapMemory(_device, vertexBufferMemory);
+    if (frame.isRecording) {
+        return;
     }
 
-    VkBuffer indexBuffer;
-    VkDeviceMemory indexBufferMemory;
-
-    // Upload index data.
-    {
-        const VkBufferCreateInfo indexBufferInfo = {
-            VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,   // VkStructureType        sType;
-            nullptr,                                // const void*            pNext;
-            0,                                      // VkBufferCreateFlags    flags;
-            (VkDeviceSize)sizeof(rectIndicies),     // VkDeviceSize           size;
-            VK_BUFFER_USAGE_INDEX_BUFFER_BIT,       // VkBufferUsageFlags     usage;
-            VK_SHARING_MODE_EXCLUSIVE,              // VkSharingMode          sharingMode;
-            1u,                                     // uint32_t               queueFamilyIndexCount;
-            &_queueFamilyIndex,                      // const uint32_t*        pQueueFamilyIndices;
-        };
-
-        _vk.vkCreateBuffer(_device, &indexBufferInfo, _allocator, &indexBuffer);
+    _vk.vkWaitForFences(_device, 1, &frame.fence, VK_TRUE, UINT64_MAX);
+    // The readback of this frame must be delivered before its buffer is reused.
+    completeReadbacks(false);
+    _vk.vkResetFences(_device, 1, &frame.fence);
 
-        VkMemoryRequirements memoryRequirements;
-        _vk.vkGetBufferMemoryRequirements(_device, indexBuffer, &memoryRequirements);
-        const VkMemoryAllocateInfo allocationInfo = {
-            VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,                                         // VkStructureType    sType;
-            nullptr,                                                                        // const void*        pNext;
-            memoryRequirements.size,                                                        // VkDeviceSize       allocationSize;
-            getMemoryTypeIndex(memoryRequirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT),    // uint32_t           memoryTypeIndex;
-        };
+    const VkCommandBufferBeginInfo commandBufferBeginInfo = {
+       VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, // VkStructureType                          sType;
+       nullptr,                                     // const void*                              pNext;
+       VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, // VkCommandBufferUsageFlags                flags;
+       nullptr,                                     // const VkCommandBufferInheritanceInfo*    pInheritanceInfo;
+    };
 
-        _vk.vkAllocateMemory(_device, &allocationInfo, _allocator, &indexBufferMemory);
-        _vk.vkBindBufferMemory(_device, indexBuffer, indexBufferMemory, 0);
+    _vk.vkBeginCommandBuffer(frame.commandBuffer, &commandBufferBeginInfo);
+    beginSurfaceRenderPass(frame.commandBuffer);
 
-        void* data;
-        _vk.vkMapMemory(_device, indexBufferMemory, 0, (VkDeviceSize)sizeof(rectIndicies), 0, &data);
+    // Each frame owns a segment of the vertex ring.
+    _vertexRing.offset = _currentFrame * (_vertexRing.size / kFramesInFlight);
+    frame.isRecording = true;
+}
 
-        std::memcpy(data, rectIndicies, (VkDeviceSize)sizeof(rectIndicies));
+/*!
+ * \brief Begin the render pass of the surface image.
+ *
+ * The render pass is active during the recording of a frame, except for the
+ * transfers and the coverage passes of the paths.
+ *
+ * \internal
+ */
+void GepardVulkan::beginSurfaceRenderPass(const VkCommandBuffer commandBuffer)
+{
+    const VkRect2D renderArea = {
+        {
+            0,                              // int32_t x
+            0,                              // int32_t y
+        },  // VkOffset2D    offset;
+        {
+            _context.surface->width(),      // uint32_t    width
+            _context.surface->height(),     // uint32_t    height
+        }, // VkExtent2D    extent;
+    };
 
-        const VkMappedMemoryRange range = {
-            VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,  // VkStructureType    sType;
-            nullptr,                                // const void*        pNext;
-            indexBufferMemory,                      // VkDeviceMemory     memory;
-            0,                                      // VkDeviceSize       offset;
-            (VkDeviceSize)sizeof(rectIndicies),     // VkDeviceSize       size;
-        };
+    const VkClearValue clearValue = { 0.0, 0.0, 0.0, 0.0 };
 
-        _vk.vkFlushMappedMemoryRanges(_device, 1, &range);
-        _vk.vkUnmapMemory(_device, indexBufferMemory);
-    }
+    const VkRenderPassBeginInfo renderPassInfo = {
+        VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,   // VkStructureType        sType;
+        nullptr,                                    // const void*            pNext;
+        _renderPass,                                // VkRenderPass           renderPass;
+        _frameBuffer,                               // VkFramebuffer          framebuffer;
+        renderArea,                                 // VkRect2D               renderArea;
+        1u,                                         // uint32_t               clearValueCount;
+        &clearValue,                                // const VkClearValue*    pClearValues;
+    };
 
-    // Pipeline creation
+    _vk.vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+}
 
-    VkShaderModule vertex;
-    VkShaderModule fragment;
+/*!
+ * \brief Submit the current frame and step to the next one.
+ * \param present  copy the result to the swap chain or to the buffer of
+ * the surface
+ *
+ * \internal
+ */
+void GepardVulkan::submitFrame(const bool present)
+{
+    Frame& frame = _frames[_currentFrame];
+
+    if (!frame.isRecording) {
+        // Nothing is drawn since the previous frame, but the surface is
+        // notified about the flush after the pending readbacks.
+        if (present) {
+            _emptyFrames.push_back(_context.frameCount);
+            completeReadbacks(false);
+        }
+        return;
+    }
 
-    //! \todo (kkristof) better file handling is needed.
-    {
-        std::ifstream vertexInput( "src/engines/vulkan/shaders/vert.spv", std::ios::binary );
-        std::vector<char> vertexCode((std::istreambuf_iterator<char>(vertexInput)), (std::istreambuf_iterator<char>()));
+    _vk.vkCmdEndRenderPass(frame.commandBuffer);
 
-        std::ifstream fragmentInput( "src/engines/vulkan/shaders/frag.spv", std::ios::binary );
-        std::vector<char> fragmentCode((std::istreambuf_iterator<char>(fragmentInput)), (std::istreambuf_iterator<char>()));
+    const bool presentSwapChain = present && _context.surface->getDisplay();
+    const bool readBuffer = present && !presentSwapChain && _context.surface->getBuffer();
+    uint32_t imageIndex = 0;
 
-        const VkShaderModuleCreateInfo vertexModulInfo = {
-            VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,            // VkStructureType              sType;
-            nullptr,                                                // const void*                  pNext;
-            0,                                                      // VkShaderModuleCreateFlags    flags;
-            vertexCode.size(),                                      // size_t                       codeSize;
-            reinterpret_cast<const uint32_t*>(vertexCode.data()),   // const uint32_t*              pCode;
-        };
-        _vk.vkCreateShaderModule(_device, &vertexModulInfo, _allocator, &vertex);
-
-        const VkShaderModuleCreateInfo fragmentModulInfo = {
-            VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,            // VkStructureType              sType;
-            nullptr,                                                // const void*                  pNext;
-            0,                                                      // VkShaderModuleCreateFlags    flags;
-            fragmentCode.size(),                                    // size_t                       codeSize;
-            reinterpret_cast<const uint32_t*>(fragmentCode.data()), // const uint32_t*              pCode;
-        };
-        _vk.vkCreateShaderModule(_device, &fragmentModulInfo, _allocator, &fragment);
+    if (presentSwapChain) {
+        _vk.vkAcquireNextImageKHR(_device, _wsiSwapChain, UINT64_MAX, frame.imageAcquired, VK_NULL_HANDLE, &imageIndex);
+        recordPresentImage(frame.commandBuffer, imageIndex);
+    } else if (readBuffer) {
+        recordReadImage(frame.commandBuffer, frame.readbackBuffer);
     }
 
-    const VkPipelineShaderStageCreateInfo stages[] = {
-        {
-            VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,    // VkStructureType                     sType;
-            nullptr,                                                // const void*                         pNext;
-            0,                                                      // VkPipelineShaderStageCreateFlags    flags;
-            VK_SHADER_STAGE_VERTEX_BIT,                             // VkShaderStageFlagBits               stage;
-            vertex,                                                 // VkShaderModule                      module;
-            "main",                                                 // const char*                         pName;
-            nullptr,                                                // const VkSpecializationInfo*         pSpecializationInfo;
-        },
-        {
-            VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,    // VkStructureType                     sType;
-            nullptr,                                                // const void*                         pNext;
-            0,                                                      // VkPipelineShaderStageCreateFlags    flags;
-            VK_SHADER_STAGE_FRAGMENT_BIT,                           // VkShaderStageFlagBits               stage;
-            fragment,                                               // VkShaderModule                      module;
-            "main",                                                 // const char*                         pName;
-            nullptr,                                                // const VkSpecializationInfo*         pSpecializationInfo;
-        }
-    };
+    _vk.vkEndCommandBuffer(frame.commandBuffer);
 
-    const VkVertexInputBindingDescription bindingDescription = {
-        0u,                             // uint32_t             binding;
-        2 * (4 * sizeof(float)),        // uint32_t             stride;
-        VK_VERTEX_INPUT_RATE_VERTEX,    // VkVertexInputRate    inputRate;
-    };
+    const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
 
-    const VkVertexInputAttributeDescription vertexAttributeDescriptions[] = {
-        {
-            0u,                             // uint32_t location
-            0u,                             // uint32_t binding
-            VK_FORMAT_R32G32B32A32_SFLOAT,  // VkFormat format
-            0u,                             // uint32_t offset
-        },
-        {
-            1u,                             // uint32_t location
-            0u,                             // uint32_t binding
-            VK_FORMAT_R32G32B32A32_SFLOAT,  // VkFormat format
-            sizeof(float) * 4,              // uint32_t offset
-        },
-    };
+    const VkSubmitInfo submitInfo = {
+        VK_STRUCTURE_TYPE_SUBMIT_INFO,                  // VkStructureType                sType;
+        nullptr,                                        // const void*                    pNext;
+        presentSwapChain ? 1u : 0u,                     // uint32_t                       waitSemaphoreCount;
+        &frame.imageAcquired,                           // const VkSemaphore*             pWaitSemaphores;
+        &waitStage,                                     // const VkPipelineStageFlags*    pWaitDstStageMask;
+        1u,                                             // uint32_t                       commandBufferCount;
+        &frame.commandBuffer,                           // const VkCommandBuffer*         pCommandBuffers;
+        presentSwapChain ? 1u : 0u,                     // uint32_t                       signalSemaphoreCount;
+        &frame.renderFinished,                          // const VkSemaphore*             pSignalSemaphores;
+    };
+
+    _vk.vkQueueSubmit(_queue, 1, &submitInfo, frame.fence);
+
+    if (presentSwapChain) {
+        const VkPresentInfoKHR presentInfo = {
+            VK_STRUCTURE_TYPE_PRESENT_INFO_KHR, // VkStructureType          sType;
+            nullptr,                            // const void*              pNext;
+            1u,                                 // uint32_t                 waitSemaphoreCount;
+            &frame.renderFinished,              // const VkSemaphore*       pWaitSemaphores;
+            1u,                                 // uint32_t                 swapchainCount;
+            &_wsiSwapChain,                     // const VkSwapchainKHR*    pSwapchains;
+            &imageIndex,                        // const uint32_t*          pImageIndices;
+            nullptr,                            // VkResult*                pResults;
+        };
 
-    const VkPipelineVertexInputStateCreateInfo vertexInputState = {
-        VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,  // VkStructureType                             sType;
-        nullptr,                                                    // const void*                                 pNext;
-        0,                                                          // VkPipelineVertexInputStateCreateFlags       flags;
-        1u,                                                         // uint32_t                                    vertexBindingDescriptionCount;
-        &bindingDescription,                                        // const VkVertexInputBindingDescription*      pVertexBindingDescriptions;
-        2u,                                                         // uint32_t                                    vertexAttributeDescriptionCount;
-        vertexAttributeDescriptions,                                // const VkVertexInputAttributeDescription*    pVertexAttributeDescriptions;
-    };
+        _vk.vkQueuePresentKHR(_queue, &presentInfo);
+        _context.surface->frameReady(_context.frameCount);
+    } else if (readBuffer) {
+        frame.readbackFrame = _context.frameCount;
+    }
 
-    const VkPipelineInputAssemblyStateCreateInfo inputAssemblyState = {
-        VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,    // VkStructureType                          sType
-        nullptr,                                                        // const void*                              pNext
-        0,                                                              // VkPipelineInputAssemblyStateCreateFlags  flags
-        VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,                            // VkPrimitiveTopology                      topology
-        VK_FALSE,                                                       // VkBool32                                 primitiveRestartEnable
-    };
+    frame.isRecording = false;
+    _currentFrame = (_currentFrame + 1) % kFramesInFlight;
 
-    const uint32_t width = _context.surface->width();
-    const uint32_t height = _context.surface->height();
-    const VkViewport viewports[] = {
-        {
-            0.0f,           // float    x;
-            0.0f,           // float    y;
-            (float)width,   // float    width;
-            (float)height,  // float    height;
-            0.0f,           // float    minDepth;
-            1.0f,           // float    maxDepth;
-        }
-    };
+    if (readBuffer) {
+        completeReadbacks(false);
+    }
+}
 
-    const VkRect2D scissors[] = {
-        {
-            {
-                0,      // int32_t x
-                0,      // int32_t y
-            },  // VkOffset2D    offset;
-            {
-                width,  // uint32_t    width
-                height, // uint32_t    height
-            }, // VkExtent2D    extent;
-        }
-    };
+void GepardVulkan::createDefaultInstance()
+{
+    GD_ASSERT(!_instance);
 
-    const VkPipelineViewportStateCreateInfo viewportState = {
-        VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,  // VkStructureType                       sType;
-        nullptr,                                                // const void*                           pNext;
-        0,                                                      // VkPipelineViewportStateCreateFlags    flags;
-        1u,                                                     // uint32_t                              viewportCount;
-        viewports,                                              // const VkViewport*                     pViewports;
-        1u,                                                     // uint32_t                              scissorCount;
-        scissors,                                               // const VkRect2D*                       pScissors;
-    };
+    // The headless surfaces are read back, they don't need the WSI extensions,
+    // which are not supported by every driver.
+    std::vector<const char*> enabledExtensions;
+    if (_context.surface->getDisplay()) {
+        enabledExtensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+#ifdef VK_USE_PLATFORM_XLIB_KHR
+        enabledExtensions.push_back(VK_KHR_XLIB_SURFACE_EXTENSION_NAME);
+#endif // VK_USE_PLATFORM_XLIB_KHR
+    }
 
-    const VkPipelineRasterizationStateCreateInfo rasterizationState = {
-        VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO, // VkStructureType                            sType;
-        nullptr,                                                    // const void*                                pNext;
-        0,                                                          // VkPipelineRasterizationStateCreateFlags    flags;
-        VK_FALSE,                                                   // VkBool32                                   depthClampEnable;
-        VK_FALSE,                                                   // VkBool32                                   rasterizerDiscardEnable;
-        VK_POLYGON_MODE_FILL,                                       // VkPolygonMode                              polygonMode;
-        VK_CULL_MODE_NONE,                                          // VkCullModeFlags                            cullMode;
-        VK_FRONT_FACE_COUNTER_CLOCKWISE,                            // VkFrontFace                                frontFace;
-        VK_FALSE,                                                   // VkBool32                                   depthBiasEnable;
-        0.0f,                                                       // float                                      depthBiasConstantFactor;
-        0.0f,                                                       // float                                      depthBiasClamp;
-        0.0f,                                                       // float                                      depthBiasSlopeFactor;
-        1.0f,                                                       // float                                      lineWidth;
-    };
+    std::vector<const char*> enabledLayers;
 
-    const VkPipelineMultisampleStateCreateInfo multisampleState = {
-        VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,   // VkStructureType                          sType;
-        nullptr,                                                    // const void*                              pNext;
-        0,                                                          // VkPipelineMultisampleStateCreateFlags    flags;
-        VK_SAMPLE_COUNT_1_BIT,                                      // VkSampleCountFlagBits                    rasterizationSamples;
-        VK_FALSE,                                                   // VkBool32                                 sampleShadingEnable;
-        0.0,                                                        // float                                    minSampleShading;
-        nullptr,                                                    // const VkSampleMask*                      pSampleMask;
-        VK_FALSE,                                                   // VkBool32                                 alphaToCoverageEnable;
-        VK_FALSE,                                                   // VkBool32                                 alphaToOneEnable;
-    };
+#ifdef GD_ENABLE_VULKAN_VALIDATION
+    // The loaders ignore the device layers, the validation is enabled here.
+    enabledLayers.push_back("VK_LAYER_KHRONOS_validation");
+#endif
 
-    const VkPipelineColorBlendAttachmentState colorBlendAttachmentState = {
-        VK_TRUE,                                                                                                    // VkBool32                 blendEnable;
-        VK_BLEND_FACTOR_SRC_ALPHA,                                                                                  // VkBlendFactor            srcColorBlendFactor;
-        VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,                                                                        // VkBlendFactor            dstColorBlendFactor;
-        VK_BLEND_OP_ADD,                                                                                            // VkBlendOp                colorBlendOp;
-        VK_BLEND_FACTOR_SRC_ALPHA,                                                                                  // VkBlendFactor            srcAlphaBlendFactor;
-        VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,                                                                        // VkBlendFactor            dstAlphaBlendFactor;
-        VK_BLEND_OP_ADD,                                                                                            // VkBlendOp                alphaBlendOp;
-        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT   // VkColorComponentFlags    colorWriteMask;
-    };
+    const char* const* enabledExtensionNames = enabledExtensions.empty() ? nullptr : enabledExtensions.data();
+    const char* const* enabledLayerNames = enabledLayers.empty() ? nullptr : enabledLayers.data();
 
-    const VkPipelineColorBlendStateCreateInfo colorBlendState = {
-        VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,   // VkStructureType                               sType;
-        nullptr,                                                    // const void*                                   pNext;
-        0,                                                          // VkPipelineColorBlendStateCreateFlags          flags;
-        VK_FALSE,                                                   // VkBool32                                      logicOpEnable;
-        VK_LOGIC_OP_COPY,                                           // VkLogicOp                                     logicOp;
-        1u,                                                         // uint32_t                                      attachmentCount;
-        &colorBlendAttachmentState,                                 // const VkPipelineColorBlendAttachmentState*    pAttachments;
-        {
-            0.0f,   // float R
-            0.0f,   // float G
-            0.0f,   // float B
-            0.0f,   // float A
-        },                                                          // float                                         blendConstants[4];
+    //! \todo (kkristof) find better default arguments
+    const VkInstanceCreateInfo instanceCreateInfo = {
+        VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO, // VkStructureType             sType;
+        nullptr,                                // const void*                 pNext;
+        0u,                                     // VkInstanceCreateFlags       flags;
+        nullptr,                                // const VkApplicationInfo*    pApplicationInfo;
+        (uint32_t)enabledLayers.size(),         // uint32_t                    enabledLayerCount;
+        enabledLayerNames,                      // const char* const*          ppEnabledLayerNames;
+        (uint32_t)enabledExtensions.size(),     // uint32_t                    enabledExtensionCount;
+        enabledExtensionNames,                  // const char* const*          ppEnabledExtensionNames;
     };
 
-    VkPipelineLayout layout;
-    const VkPipelineLayoutCreateInfo layoutCreateInfo = {
-          VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,  // VkStructureType                sType
-          nullptr,                                        // const void                    *pNext
-          0,                                              // VkPipelineLayoutCreateFlags    flags
-          0u,                                             // uint32_t                       setLayoutCount
-          nullptr,                                        // const VkDescriptorSetLayout   *pSetLayouts
-          0u,                                             // uint32_t                       pushConstantRangeCount
-          nullptr                                         // const VkPushConstantRange     *pPushConstantRanges
-    };
-
-    _vk.vkCreatePipelineLayout(_device, &layoutCreateInfo, _allocator, &layout);
-
-    const VkGraphicsPipelineCreateInfo pipelineCreateInfo = {
-        VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,    // VkStructureType                                  sType;
-        nullptr,                                            // const void*                                      pNext;
-        0,                                                  // VkPipelineCreateFlags                            flags;
-        2u,                                                 // uint32_t                                         stageCount;
-        stages,                                             // const VkPipelineShaderStageCreateInfo*           pStages;
-        &vertexInputState,                                  // const VkPipelineVertexInputStateCreateInfo*      pVertexInputState;
-        &inputAssemblyState,                                // const VkPipelineInputAssemblyStateCreateInfo*    pInputAssemblyState;
-        nullptr,                                            // const VkPipelineTessellationStateCreateInfo*     pTessellationState;
-        &viewportState,                                     // const VkPipelineViewportStateCreateInfo*         pViewportState;
-        &rasterizationState,                                // const VkPipelineRasterizationStateCreateInfo*    pRasterizationState;
-        &multisampleState,                                  // const VkPipelineMultisampleStateCreateInfo*      pMultisampleState;
-        nullptr,                                            // const VkPipelineDepthStencilStateCreateInfo*     pDepthStencilState;
-        &colorBlendState,                                   // const VkPipelineColorBlendStateCreateInfo*       pColorBlendState;
-        nullptr,                                            // const VkPipelineDynamicStateCreateInfo*          pDynamicState;
-        layout,                                             // VkPipelineLayout                                 layout;
-        _renderPass,                                        // VkRenderPass                                     renderPass;
-        0u,                                                 // uint32_t                                         subpass;
-        VK_NULL_HANDLE,                                     // VkPipeline                                       basePipelineHandle;
-        0,                                                  // int32_t                                          basePipelineIndex;
-    };
-
-    VkPipeline pipeline;
-
-    _vk.vkCreateGraphicsPipelines(_device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, _allocator, &pipeline);
-
-    // Drawing
-
-    const VkCommandBuffer commandBuffer = _primaryCommandBuffers[0];
-
-    const VkCommandBufferBeginInfo commandBufferBeginInfo = {
-       VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, // VkStructureType                          sType;
-       nullptr,                                     // const void*                              pNext;
-       VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, // VkCommandBufferUsageFlags                flags;
-       nullptr,                                     // const VkCommandBufferInheritanceInfo*    pInheritanceInfo;
-    };
-
-    _vk.vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo);
-
-    const VkClearValue clearValue = { 0.0, 0.0, 0.0, 0.0 };
-
-    const VkRenderPassBeginInfo renderPassInfo = {
-        VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,   // VkStructureType        sType;
-        nullptr,                                    // const void*            pNext;
-        _renderPass,                                // VkRenderPass           renderPass;
-        _frameBuffer,                               // VkFramebuffer          framebuffer;
-        scissors[0],                                // VkRect2D               renderArea;
-        1u,                                         // uint32_t               clearValueCount;
-        &clearValue,                                // const VkClearValue*    pClearValues;
-    };
-
-    _vk.vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-    _vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
-
-    _vk.vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &vertexBufferOffset);
-    _vk.vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-
-    const uint32_t indexCount = sizeof(rectIndicies) / sizeof(uint32_t);
-    _vk.vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, 0, 0);
-
-    _vk.vkCmdEndRenderPass(commandBuffer);
-
-    _vk.vkEndCommandBuffer(commandBuffer);
-
-    const VkSubmitInfo submitInfo = {
-        VK_STRUCTURE_TYPE_SUBMIT_INFO,  // VkStructureType                sType;
-        nullptr,                        // const void*                    pNext;
-        0u,                             // uint32_t                       waitSemaphoreCount;
-        nullptr,                        // const VkSemaphore*             pWaitSemaphores;
-        nullptr,                        // const VkPipelineStageFlags*    pWaitDstStageMask;
-        1u,                             // uint32_t                       commandBufferCount;
-        &commandBuffer,                 // const VkCommandBuffer*         pCommandBuffers;
-        0u,                             // uint32_t                       signalSemaphoreCount;
-        nullptr,                        // const VkSemaphore*             pSignalSemaphores;
-    };
-
-    VkQueue queue;
-    _vk.vkGetDeviceQueue(_device, _queueFamilyIndex, 0, &queue);
-
-    const VkFenceCreateInfo fenceInfo = {
-        VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,    // VkStructureType       sType;
-        nullptr,                                // const void*           pNext;
-        0,                                      // VkFenceCreateFlags    flags;
-    };
-
-    VkFence fence;
-    _vk.vkCreateFence(_device, &fenceInfo, _allocator, &fence);
-    _vk.vkQueueSubmit(queue, 1, &submitInfo, fence);
-    _vk.vkWaitForFences(_device, 1, &fence, VK_TRUE, timeout);
-
-    if(_context.surface->getDisplay()) {
-        presentImage();
-    } else if(_context.surface->getBuffer()) {
-        readImage();
-    }
-
-    // Clean up
-    _vk.vkDestroyFence(_device, fence, _allocator);
-
-    _vk.vkDestroyPipeline(_device, pipeline, _allocator);
-    _vk.vkDestroyPipelineLayout(_device, layout, _allocator);
-
-    _vk.vkDestroyShaderModule(_device, vertex, _allocator);
-    _vk.vkDestroyShaderModule(_device, fragment, _allocator);
-
-    _vk.vkDestroyBuffer(_device, vertexBuffer, _allocator);
-    _vk.vkDestroyBuffer(_device, indexBuffer, _allocator);
-
-    _vk.vkFreeMemory(_device, vertexBufferMemory, _allocator);
-    _vk.vkFreeMemory(_device, indexBufferMemory, _allocator);
-}
-
-void GepardVulkan::fill()
-{
-    GD_NOT_IMPLEMENTED();
-}
-
-void GepardVulkan::stroke()
-{
-    GD_NOT_IMPLEMENTED();
-}
-
-void GepardVulkan::createDefaultInstance()
-{
-    GD_ASSERT(!_instance);
-
-    const std::vector<const char*> enabledExtensions = {
-        VK_KHR_SURFACE_EXTENSION_NAME,
-#ifdef VK_USE_PLATFORM_XLIB_KHR
-        VK_KHR_XLIB_SURFACE_EXTENSION_NAME,
-#endif // VK_USE_PLATFORM_XLIB_KHR
-    };
-
-    const char* const* enabledExtensionNames = enabledExtensions.empty() ? nullptr : enabledExtensions.data();
-
-    //! \todo (kkristof) find better default arguments
-    const VkInstanceCreateInfo instanceCreateInfo = {
-        VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO, // VkStructureType             sType;
-        nullptr,                                // const void*                 pNext;
-        0u,                                     // VkInstanceCreateFlags       flags;
-        nullptr,                                // const VkApplicationInfo*    pApplicationInfo;
-        0u,                                     // uint32_t                    enabledLayerCount;
-        nullptr,                                // const char* const*          ppEnabledLayerNames;
-        (uint32_t)enabledExtensions.size(),     // uint32_t                    enabledExtensionCount;
-        enabledExtensionNames,                  // const char* const*          ppEnabledExtensionNames;
-    };
-
-    _vk.vkCreateInstance(&instanceCreateInfo, _allocator, &_instance);
-    GD_ASSERT(_instance);
-}
+    _vk.vkCreateInstance(&instanceCreateInfo, _allocator, &_instance);
+    GD_ASSERT(_instance);
+}
 
 void GepardVulkan::chooseDefaultPhysicalDevice()
 {
@@ -646,6 +560,10 @@ void GepardVulkan::chooseDefaultDevice()
     _vk.vkGetPhysicalDeviceMemoryProperties(_physicalDevice, &_physicalDeviceMemoryProperties);
     _vk.vkGetPhysicalDeviceFeatures(_physicalDevice, &_physicalDeviceFeatures);
 
+    VkPhysicalDeviceProperties deviceProperties;
+    _vk.vkGetPhysicalDeviceProperties(_physicalDevice, &deviceProperties);
+    _bufferImageGranularity = deviceProperties.limits.bufferImageGranularity;
+
     VkResult vkResult;
     const float queuePriorities[] = { 1.0f };
 
@@ -662,7 +580,8 @@ void GepardVulkan::chooseDefaultDevice()
     std::vector<const char*> enabledInstanceExtensions;
 
 #ifdef GD_ENABLE_VULKAN_VALIDATION
-    enabledInstanceLayers.push_back("VK_LAYER_LUNARG_standard_validation");
+    // For the older loaders, see createDefaultInstance().
+    enabledInstanceLayers.push_back("VK_LAYER_KHRONOS_validation");
 #endif
 
     if (_context.surface->getDisplay()) {
@@ -704,22 +623,60 @@ void GepardVulkan::createCommandPool()
     GD_ASSERT(vkResult == VK_SUCCESS && "Command pool creation failed!");
 }
 
-void GepardVulkan::allocatePrimaryCommandBuffer()
+void GepardVulkan::allocatePrimaryCommandBuffers()
 {
     const VkCommandBufferAllocateInfo commandBufferAllocateInfo = {
         VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO, // VkStructureType         sType;
         nullptr,                                        // const void*             pNext;
         _commandPool,                                   // VkCommandPool           commandPool;
         VK_COMMAND_BUFFER_LEVEL_PRIMARY,                // VkCommandBufferLevel    level;
-        1u,                                             // uint32_t                commandBufferCount;
+        kFramesInFlight,                                // uint32_t                commandBufferCount;
     };
 
     VkResult vkResult;
-    VkCommandBuffer commandBuffer;
-    vkResult = _vk.vkAllocateCommandBuffers(_device, &commandBufferAllocateInfo, &commandBuffer);
+    _primaryCommandBuffers.resize(kFramesInFlight);
+    vkResult = _vk.vkAllocateCommandBuffers(_device, &commandBufferAllocateInfo, _primaryCommandBuffers.data());
 
     GD_ASSERT(vkResult == VK_SUCCESS && "Command buffer allocation failed!");
-    _primaryCommandBuffers.push_back(commandBuffer);
+}
+
+/*!
+ * \brief Create the synchronization objects of the frames in flight.
+ *
+ * \internal
+ */
+void GepardVulkan::createFrames()
+{
+    _vk.vkGetDeviceQueue(_device, _queueFamilyIndex, 0, &_queue);
+
+    // The fences are signaled, so the first use of a frame does not wait.
+    const VkFenceCreateInfo fenceInfo = {
+        VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,    // VkStructureType       sType;
+        nullptr,                                // const void*           pNext;
+        VK_FENCE_CREATE_SIGNALED_BIT,           // VkFenceCreateFlags    flags;
+    };
+
+    const VkSemaphoreCreateInfo semaphoreInfo = {
+        VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,    // VkStructureType           sType;
+        nullptr,                                    // const void*               pNext;
+        0,                                          // VkSemaphoreCreateFlags    flags;
+    };
+
+    _frames.resize(kFramesInFlight);
+    for (uint32_t i = 0; i < kFramesInFlight; ++i) {
+        Frame& frame = _frames[i];
+        frame.commandBuffer = _primaryCommandBuffers[i];
+        frame.readbackFrame = 0u;
+        frame.isRecording = false;
+
+        VkResult vkResult;
+        vkResult = _vk.vkCreateFence(_device, &fenceInfo, _allocator, &frame.fence);
+        GD_ASSERT(vkResult == VK_SUCCESS && "Creating the frame fence failed!");
+        vkResult = _vk.vkCreateSemaphore(_device, &semaphoreInfo, _allocator, &frame.imageAcquired);
+        GD_ASSERT(vkResult == VK_SUCCESS && "Creating the frame semaphore failed!");
+        vkResult = _vk.vkCreateSemaphore(_device, &semaphoreInfo, _allocator, &frame.renderFinished);
+        GD_ASSERT(vkResult == VK_SUCCESS && "Creating the frame semaphore failed!");
+    }
 }
 
 void GepardVulkan::createDefaultRenderPass()
@@ -734,7 +691,7 @@ void GepardVulkan::createDefaultRenderPass()
         VK_ATTACHMENT_STORE_OP_STORE,               // VkAttachmentStoreOp          storeOp;
         VK_ATTACHMENT_LOAD_OP_DONT_CARE,            // VkAttachmentLoadOp           stencilLoadOp;
         VK_ATTACHMENT_STORE_OP_DONT_CARE,           // VkAttachmentStoreOp          stencilStoreOp;
-        VK_IMAGE_LAYOUT_UNDEFINED,                  // VkImageLayout                initialLayout;
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,   // VkImageLayout                initialLayout;
         VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,   // VkImageLayout                finalLayout;
     };
 
@@ -756,6 +713,22 @@ void GepardVulkan::createDefaultRenderPass()
         nullptr,                            // const uint32_t*                 pPreserveAttachments;
     };
 
+    // The surface render pass is ended and restarted around the coverage
+    // passes of fillPath() and at the frame boundaries, so its drawings
+    // must wait for the drawings and the copies of the previous instances.
+    const VkSubpassDependency dependency = {
+        VK_SUBPASS_EXTERNAL,                            // uint32_t                srcSubpass;
+        0u,                                             // uint32_t                dstSubpass;
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+            | VK_PIPELINE_STAGE_TRANSFER_BIT,           // VkPipelineStageFlags    srcStageMask;
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,  // VkPipelineStageFlags    dstStageMask;
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+            | VK_ACCESS_TRANSFER_WRITE_BIT,             // VkAccessFlags           srcAccessMask;
+        VK_ACCESS_COLOR_ATTACHMENT_READ_BIT
+            | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,     // VkAccessFlags           dstAccessMask;
+        0,                                              // VkDependencyFlags       dependencyFlags;
+    };
+
     const VkRenderPassCreateInfo renderPassCreateInfo = {
         VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,  // VkStructureType                   sType;
         nullptr,                                    // const void*                       pNext;
@@ -764,8 +737,8 @@ void GepardVulkan::createDefaultRenderPass()
         &attachmentDescription,                     // const VkAttachmentDescription*    pAttachments;
         1u,                                         // uint32_t                          subpassCount;
         &subpassDescription,                        // const VkSubpassDescription*       pSubpasses;
-        0u,                                         // uint32_t                          dependencyCount;
-        nullptr,                                    // const VkSubpassDependency*        pDependencies;
+        1u,                                         // uint32_t                          dependencyCount;
+        &dependency,                                // const VkSubpassDependency*        pDependencies;
     };
 
     vkResult = _vk.vkCreateRenderPass(_device, &renderPassCreateInfo, _allocator, &_renderPass);
@@ -808,25 +781,14 @@ void GepardVulkan::createSurfaceImage()
     VkMemoryRequirements memoryRequirements;
     _vk.vkGetImageMemoryRequirements(_device, _surfaceImage, &memoryRequirements);
 
-    const VkMemoryAllocateInfo memoryAllocateInfo = {
-        VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,                                         // VkStructureType    sType;
-        nullptr,                                                                        // const void*        pNext;
-        memoryRequirements.size,                                                        // VkDeviceSize       allocationSize;
-        getMemoryTypeIndex(memoryRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),    // uint32_t           memoryTypeIndex;
-    };
-
-    VkDeviceMemory deviceMemory;
-    vkResult = _vk.vkAllocateMemory(_device, &memoryAllocateInfo, _allocator, &deviceMemory);
-    GD_ASSERT(vkResult == VK_SUCCESS && "Memory allocation failed!");
+    const MemoryAllocation allocation = allocateMemory(memoryRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true);
 
-    _memoryAllocations.push_back(deviceMemory);
-
-    vkResult = _vk.vkBindImageMemory(_device, _surfaceImage, deviceMemory, static_cast<VkDeviceSize>(0u));
+    vkResult = _vk.vkBindImageMemory(_device, _surfaceImage, allocation.memory, allocation.offset);
     GD_ASSERT(vkResult == VK_SUCCESS && "Memory bind failed!");
 
     // Clear the surface image
 
-    const VkCommandBuffer commandBuffer = _primaryCommandBuffers[0];
+    const VkCommandBuffer commandBuffer = _frames[0].commandBuffer;
 
     const VkCommandBufferBeginInfo commandBufferBeginInfo = {
        VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, // VkStructureType                          sType;
@@ -847,9 +809,39 @@ void GepardVulkan::createSurfaceImage()
         1u,                         // uint32_t              layerCount;
     };
 
+    const VkImageMemoryBarrier preClearBarrier = {
+        VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,     // VkStructureType            sType;
+        nullptr,                                    // const void*                pNext;
+        0,                                          // VkAccessFlags              srcAccessMask;
+        VK_ACCESS_TRANSFER_WRITE_BIT,               // VkAccessFlags              dstAccessMask;
+        VK_IMAGE_LAYOUT_UNDEFINED,                  // VkImageLayout              oldLayout;
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,       // VkImageLayout              newLayout;
+        VK_QUEUE_FAMILY_IGNORED,                    // uint32_t                   srcQueueFamilyIndex;
+        VK_QUEUE_FAMILY_IGNORED,                    // uint32_t                   dstQueueFamilyIndex;
+        _surfaceImage,                              // VkImage                    image;
+        range,                                      // VkImageSubresourceRange    subresourceRange;
+    };
+
+    // The render pass expects the image in the color attachment layout.
+    const VkImageMemoryBarrier postClearBarrier = {
+        VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,     // VkStructureType            sType;
+        nullptr,                                    // const void*                pNext;
+        VK_ACCESS_TRANSFER_WRITE_BIT,               // VkAccessFlags              srcAccessMask;
+        VK_ACCESS_COLOR_ATTACHMENT_READ_BIT
+            | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, // VkAccessFlags              dstAccessMask;
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,       // VkImageLayout              oldLayout;
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,   // VkImageLayout              newLayout;
+        VK_QUEUE_FAMILY_IGNORED,                    // uint32_t                   srcQueueFamilyIndex;
+        VK_QUEUE_FAMILY_IGNORED,                    // uint32_t                   dstQueueFamilyIndex;
+        _surfaceImage,                              // VkImage                    image;
+        range,                                      // VkImageSubresourceRange    subresourceRange;
+    };
+
     _vk.vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo);
 
+    _vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, (VkDependencyFlags)0, 0, (const VkMemoryBarrier*)nullptr, 0, (const VkBufferMemoryBarrier*)nullptr, 1, &preClearBarrier);
     _vk.vkCmdClearColorImage(commandBuffer, _surfaceImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clearColor, 1, &range);
+    _vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, (VkDependencyFlags)0, 0, (const VkMemoryBarrier*)nullptr, 0, (const VkBufferMemoryBarrier*)nullptr, 1, &postClearBarrier);
 
     _vk.vkEndCommandBuffer(commandBuffer);
 
@@ -865,80 +857,988 @@ void GepardVulkan::createSurfaceImage()
         nullptr,                        // const VkSemaphore*             pSignalSemaphores;
     };
 
-    VkQueue queue;
-    _vk.vkGetDeviceQueue(_device, _queueFamilyIndex, 0, &queue);
-
-    const VkFenceCreateInfo fenceInfo = {
-        VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,    // VkStructureType       sType;
-        nullptr,                                // const void*           pNext;
-        0,                                      // VkFenceCreateFlags    flags;
+    // The first frame is not in use yet, so its signaled fence can be reused.
+    Frame& frame = _frames[0];
+    _vk.vkResetFences(_device, 1, &frame.fence);
+    _vk.vkQueueSubmit(_queue, 1, &submitInfo, frame.fence);
+    _vk.vkWaitForFences(_device, 1, &frame.fence, VK_TRUE, UINT64_MAX);
+}
+
+void GepardVulkan::createDefaultFrameBuffer()
+{
+    VkResult vkResult;
+
+    const VkImageViewCreateInfo imageViewCreateInfo = {
+        VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,   // VkStructureType            sType;
+        nullptr,                                    // const void*                pNext;
+        0,                                          // VkImageViewCreateFlags     flags;
+        _surfaceImage,                              // VkImage                    image;
+        VK_IMAGE_VIEW_TYPE_2D,                      // VkImageViewType            viewType;
+        _imageFormat,                               // VkFormat                   format;
+        {
+            VK_COMPONENT_SWIZZLE_IDENTITY, // swizzle r
+            VK_COMPONENT_SWIZZLE_IDENTITY, // swizzle g
+            VK_COMPONENT_SWIZZLE_IDENTITY, // swizzle b
+            VK_COMPONENT_SWIZZLE_IDENTITY, // swizzle a
+        },                                          // VkComponentMapping         components;
+        {
+            VK_IMAGE_ASPECT_COLOR_BIT,  // VkImageAspectFlags    aspectMask;
+            0u,                         // uint32_t              baseMipLevel;
+            1u,                         // uint32_t              levelCount;
+            0u,                         // uint32_t              baseArrayLayer;
+            1u,                         // uint32_t              layerCount;
+        },                                          // VkImageSubresourceRange    subresourceRange;
+    };
+
+    vkResult = _vk.vkCreateImageView(_device, &imageViewCreateInfo, _allocator, &_frameBufferColorAttachmentImageView);
+    GD_ASSERT(vkResult == VK_SUCCESS && "Creating the default frame buffer failed!");
+
+    std::vector<VkImageView> attachments;
+    attachments.push_back(_frameBufferColorAttachmentImageView);
+
+    const VkFramebufferCreateInfo frameBufferCreateInfo = {
+        VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,  // VkStructureType             sType;
+        nullptr,                                    // const void*                 pNext;
+        0u,                                         // VkFramebufferCreateFlags    flags;
+        _renderPass,                                // VkRenderPass                renderPass;
+        static_cast<uint32_t>(attachments.size()),  // uint32_t                    attachmentCount;
+        attachments.data(),                         // const VkImageView*          pAttachments;
+        _context.surface->width(),                  // uint32_t                    width;
+        _context.surface->height(),                 // uint32_t                    height;
+        1u,                                         // uint32_t                    layers;
+    };
+
+    vkResult = _vk.vkCreateFramebuffer(_device, &frameBufferCreateInfo, _allocator, &_frameBuffer);
+    GD_ASSERT(vkResult == VK_SUCCESS && "Creating the default frame buffer failed!");
+}
+
+/*!
+ * \brief Create the render target of the path coverage and its render pass.
+ *
+ * The coverage of a path is accumulated in the single channel _coverageImage,
+ * which is sampled by the copy path pipeline, see fillPath().  The image stays
+ * in the shader read only layout between the coverage passes.
+ *
+ * \internal
+ */
+void GepardVulkan::createCoverageTarget()
+{
+    VkResult vkResult;
+    const VkFormat coverageFormat = VK_FORMAT_R8_UNORM;
+
+    const VkAttachmentDescription attachmentDescription = {
+        0u,                                         // VkAttachmentDescriptionFlags flags;
+        coverageFormat,                             // VkFormat                     format;
+        VK_SAMPLE_COUNT_1_BIT,                      // VkSampleCountFlagBits        samples;
+        VK_ATTACHMENT_LOAD_OP_LOAD,                 // VkAttachmentLoadOp           loadOp;
+        VK_ATTACHMENT_STORE_OP_STORE,               // VkAttachmentStoreOp          storeOp;
+        VK_ATTACHMENT_LOAD_OP_DONT_CARE,            // VkAttachmentLoadOp           stencilLoadOp;
+        VK_ATTACHMENT_STORE_OP_DONT_CARE,           // VkAttachmentStoreOp          stencilStoreOp;
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,   // VkImageLayout                initialLayout;
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,   // VkImageLayout                finalLayout;
+    };
+
+    const VkAttachmentReference colorAttachment = {
+        0u,                                         // uint32_t         attachment;
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,   // VkImageLayout    layout;
+    };
+
+    const VkSubpassDescription subpassDescription = {
+        0u,                                 // VkSubpassDescriptionFlags       flags;
+        VK_PIPELINE_BIND_POINT_GRAPHICS,    // VkPipelineBindPoint             pipelineBindPoint;
+        0u,                                 // uint32_t                        inputAttachmentCount;
+        nullptr,                            // const VkAttachmentReference*    pInputAttachments;
+        1u,                                 // uint32_t                        colorAttachmentCount;
+        &colorAttachment,                   // const VkAttachmentReference*    pColorAttachments;
+        nullptr,                            // const VkAttachmentReference*    pResolveAttachments;
+        nullptr,                            // const VkAttachmentReference*    pDepthStencilAttachment;
+        0u,                                 // uint32_t                        preserveAttachmentCount;
+        nullptr,                            // const uint32_t*                 pPreserveAttachments;
+    };
+
+    // The coverage is written after the previous copy has read it, and it is
+    // read by the next copy.
+    const VkSubpassDependency dependencies[] = {
+        {
+            VK_SUBPASS_EXTERNAL,                            // uint32_t                srcSubpass;
+            0u,                                             // uint32_t                dstSubpass;
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,          // VkPipelineStageFlags    srcStageMask;
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,  // VkPipelineStageFlags    dstStageMask;
+            0,                                              // VkAccessFlags           srcAccessMask;
+            VK_ACCESS_COLOR_ATTACHMENT_READ_BIT
+                | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,     // VkAccessFlags           dstAccessMask;
+            0,                                              // VkDependencyFlags       dependencyFlags;
+        },
+        {
+            0u,                                             // uint32_t                srcSubpass;
+            VK_SUBPASS_EXTERNAL,                            // uint32_t                dstSubpass;
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,  // VkPipelineStageFlags    srcStageMask;
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,          // VkPipelineStageFlags    dstStageMask;
+            VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,           // VkAccessFlags           srcAccessMask;
+            VK_ACCESS_SHADER_READ_BIT,                      // VkAccessFlags           dstAccessMask;
+            0,                                              // VkDependencyFlags       dependencyFlags;
+        },
+    };
+
+    const VkRenderPassCreateInfo renderPassCreateInfo = {
+        VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,  // VkStructureType                   sType;
+        nullptr,                                    // const void*                       pNext;
+        0u,                                         // VkRenderPassCreateFlags           flags;
+        1u,                                         // uint32_t                          attachmentCount;
+        &attachmentDescription,                     // const VkAttachmentDescription*    pAttachments;
+        1u,                                         // uint32_t                          subpassCount;
+        &subpassDescription,                        // const VkSubpassDescription*       pSubpasses;
+        2u,                                         // uint32_t                          dependencyCount;
+        dependencies,                               // const VkSubpassDependency*        pDependencies;
+    };
+
+    vkResult = _vk.vkCreateRenderPass(_device, &renderPassCreateInfo, _allocator, &_coverageRenderPass);
+    GD_ASSERT(vkResult == VK_SUCCESS && "Creating the coverage render pass failed!");
+
+    const VkExtent3D imageSize = {
+        _context.surface->width(),  // uint32_t    width;
+        _context.surface->height(), // uint32_t    height;
+        1u,                         // uint32_t    depth;
+    };
+
+    const VkImageCreateInfo imageCreateInfo = {
+        VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,        // VkStructureType          sType;
+        nullptr,                                    // const void*              pNext;
+        0u,                                         // VkImageCreateFlags       flags;
+        VK_IMAGE_TYPE_2D,                           // VkImageType              imageType;
+        coverageFormat,                             // VkFormat                 format;
+        imageSize,                                  // VkExtent3D               extent;
+        1u,                                         // uint32_t                 mipLevels;
+        1u,                                         // uint32_t                 arrayLayers;
+        VK_SAMPLE_COUNT_1_BIT,                      // VkSampleCountFlagBits    samples;
+        VK_IMAGE_TILING_OPTIMAL,                    // VkImageTiling            tiling;
+        VK_IMAGE_USAGE_SAMPLED_BIT
+            | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,  // VkImageUsageFlags        usage;
+        VK_SHARING_MODE_EXCLUSIVE,                  // VkSharingMode            sharingMode;
+        1u,                                         // uint32_t                 queueFamilyIndexCount;
+        &_queueFamilyIndex,                         // const uint32_t*          pQueueFamilyIndices;
+        VK_IMAGE_LAYOUT_UNDEFINED,                  // VkImageLayout            initialLayout;
+    };
+
+    vkResult = _vk.vkCreateImage(_device, &imageCreateInfo, _allocator, &_coverageImage);
+    GD_ASSERT(vkResult == VK_SUCCESS && "Creating the coverage image failed!");
+
+    VkMemoryRequirements memoryRequirements;
+    _vk.vkGetImageMemoryRequirements(_device, _coverageImage, &memoryRequirements);
+
+    const MemoryAllocation allocation = allocateMemory(memoryRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true);
+
+    vkResult = _vk.vkBindImageMemory(_device, _coverageImage, allocation.memory, allocation.offset);
+    GD_ASSERT(vkResult == VK_SUCCESS && "Memory bind failed!");
+
+    const VkImageSubresourceRange range = {
+        VK_IMAGE_ASPECT_COLOR_BIT,  // VkImageAspectFlags    aspectMask;
+        0u,                         // uint32_t              baseMipLevel;
+        1u,                         // uint32_t              levelCount;
+        0u,                         // uint32_t              baseArrayLayer;
+        1u,                         // uint32_t              layerCount;
+    };
+
+    const VkImageViewCreateInfo imageViewCreateInfo = {
+        VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,   // VkStructureType            sType;
+        nullptr,                                    // const void*                pNext;
+        0,                                          // VkImageViewCreateFlags     flags;
+        _coverageImage,                             // VkImage                    image;
+        VK_IMAGE_VIEW_TYPE_2D,                      // VkImageViewType            viewType;
+        coverageFormat,                             // VkFormat                   format;
+        {
+            VK_COMPONENT_SWIZZLE_IDENTITY, // swizzle r
+            VK_COMPONENT_SWIZZLE_IDENTITY, // swizzle g
+            VK_COMPONENT_SWIZZLE_IDENTITY, // swizzle b
+            VK_COMPONENT_SWIZZLE_IDENTITY, // swizzle a
+        },                                          // VkComponentMapping         components;
+        range,                                      // VkImageSubresourceRange    subresourceRange;
+    };
+
+    vkResult = _vk.vkCreateImageView(_device, &imageViewCreateInfo, _allocator, &_coverageImageView);
+    GD_ASSERT(vkResult == VK_SUCCESS && "Creating the coverage image view failed!");
+
+    const VkFramebufferCreateInfo frameBufferCreateInfo = {
+        VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,  // VkStructureType             sType;
+        nullptr,                                    // const void*                 pNext;
+        0u,                                         // VkFramebufferCreateFlags    flags;
+        _coverageRenderPass,                        // VkRenderPass                renderPass;
+        1u,                                         // uint32_t                    attachmentCount;
+        &_coverageImageView,                        // const VkImageView*          pAttachments;
+        _context.surface->width(),                  // uint32_t                    width;
+        _context.surface->height(),                 // uint32_t                    height;
+        1u,                                         // uint32_t                    layers;
+    };
+
+    vkResult = _vk.vkCreateFramebuffer(_device, &frameBufferCreateInfo, _allocator, &_coverageFrameBuffer);
+    GD_ASSERT(vkResult == VK_SUCCESS && "Creating the coverage frame buffer failed!");
+
+    // Move the image into the layout which is expected by the render pass.
+    // The content is undefined: fillPath() clears the area of each path.
+
+    const VkCommandBuffer commandBuffer = _frames[0].commandBuffer;
+
+    const VkCommandBufferBeginInfo commandBufferBeginInfo = {
+       VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, // VkStructureType                          sType;
+       nullptr,                                     // const void*                              pNext;
+       VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, // VkCommandBufferUsageFlags                flags;
+       nullptr,                                     // const VkCommandBufferInheritanceInfo*    pInheritanceInfo;
+    };
+
+    const VkImageMemoryBarrier layoutBarrier = {
+        VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,     // VkStructureType            sType;
+        nullptr,                                    // const void*                pNext;
+        0,                                          // VkAccessFlags              srcAccessMask;
+        VK_ACCESS_SHADER_READ_BIT,                  // VkAccessFlags              dstAccessMask;
+        VK_IMAGE_LAYOUT_UNDEFINED,                  // VkImageLayout              oldLayout;
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,   // VkImageLayout              newLayout;
+        VK_QUEUE_FAMILY_IGNORED,                    // uint32_t                   srcQueueFamilyIndex;
+        VK_QUEUE_FAMILY_IGNORED,                    // uint32_t                   dstQueueFamilyIndex;
+        _coverageImage,                             // VkImage                    image;
+        range,                                      // VkImageSubresourceRange    subresourceRange;
+    };
+
+    _vk.vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo);
+    _vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, (VkDependencyFlags)0, 0, (const VkMemoryBarrier*)nullptr, 0, (const VkBufferMemoryBarrier*)nullptr, 1, &layoutBarrier);
+    _vk.vkEndCommandBuffer(commandBuffer);
+
+    const VkSubmitInfo submitInfo = {
+        VK_STRUCTURE_TYPE_SUBMIT_INFO,  // VkStructureType                sType;
+        nullptr,                        // const void*                    pNext;
+        0u,                             // uint32_t                       waitSemaphoreCount;
+        nullptr,                        // const VkSemaphore*             pWaitSemaphores;
+        nullptr,                        // const VkPipelineStageFlags*    pWaitDstStageMask;
+        1u,                             // uint32_t                       commandBufferCount;
+        &commandBuffer,                 // const VkCommandBuffer*         pCommandBuffers;
+        0u,                             // uint32_t                       signalSemaphoreCount;
+        nullptr,                        // const VkSemaphore*             pSignalSemaphores;
+    };
+
+    Frame& frame = _frames[0];
+    _vk.vkResetFences(_device, 1, &frame.fence);
+    _vk.vkQueueSubmit(_queue, 1, &submitInfo, frame.fence);
+    _vk.vkWaitForFences(_device, 1, &frame.fence, VK_TRUE, UINT64_MAX);
+
+    createCoverageDescriptorSet();
+}
+
+/*!
+ * \brief Create the descriptor set of the copy path pipeline, which binds
+ * the _coverageImage.
+ *
+ * \internal
+ */
+void GepardVulkan::createCoverageDescriptorSet()
+{
+    VkResult vkResult;
+
+    const VkSamplerCreateInfo samplerCreateInfo = {
+        VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,      // VkStructureType         sType;
+        nullptr,                                    // const void*             pNext;
+        0u,                                         // VkSamplerCreateFlags    flags;
+        VK_FILTER_NEAREST,                          // VkFilter                magFilter;
+        VK_FILTER_NEAREST,                          // VkFilter                minFilter;
+        VK_SAMPLER_MIPMAP_MODE_NEAREST,             // VkSamplerMipmapMode     mipmapMode;
+        VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,      // VkSamplerAddressMode    addressModeU;
+        VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,      // VkSamplerAddressMode    addressModeV;
+        VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,      // VkSamplerAddressMode    addressModeW;
+        0.0f,                                       // float                   mipLodBias;
+        VK_FALSE,                                   // VkBool32                anisotropyEnable;
+        1.0f,                                       // float                   maxAnisotropy;
+        VK_FALSE,                                   // VkBool32                compareEnable;
+        VK_COMPARE_OP_NEVER,                        // VkCompareOp             compareOp;
+        0.0f,                                       // float                   minLod;
+        0.0f,                                       // float                   maxLod;
+        VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK,    // VkBorderColor           borderColor;
+        VK_FALSE,                                   // VkBool32                unnormalizedCoordinates;
+    };
+
+    vkResult = _vk.vkCreateSampler(_device, &samplerCreateInfo, _allocator, &_coverageSampler);
+    GD_ASSERT(vkResult == VK_SUCCESS && "Creating the coverage sampler failed!");
+
+    const VkDescriptorSetLayoutBinding binding = {
+        0u,                                         // uint32_t              binding;
+        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,  // VkDescriptorType      descriptorType;
+        1u,                                         // uint32_t              descriptorCount;
+        VK_SHADER_STAGE_FRAGMENT_BIT,               // VkShaderStageFlags    stageFlags;
+        nullptr,                                    // const VkSampler*      pImmutableSamplers;
+    };
+
+    const VkDescriptorSetLayoutCreateInfo layoutCreateInfo = {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,    // VkStructureType                        sType;
+        nullptr,                                                // const void*                            pNext;
+        0u,                                                     // VkDescriptorSetLayoutCreateFlags       flags;
+        1u,                                                     // uint32_t                               bindingCount;
+        &binding,                                               // const VkDescriptorSetLayoutBinding*    pBindings;
+    };
+
+    vkResult = _vk.vkCreateDescriptorSetLayout(_device, &layoutCreateInfo, _allocator, &_descriptorSetLayout);
+    GD_ASSERT(vkResult == VK_SUCCESS && "Creating the descriptor set layout failed!");
+
+    const VkDescriptorPoolSize poolSize = {
+        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,  // VkDescriptorType    type;
+        1u,                                         // uint32_t            descriptorCount;
+    };
+
+    const VkDescriptorPoolCreateInfo poolCreateInfo = {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,  // VkStructureType                sType;
+        nullptr,                                        // const void*                    pNext;
+        0u,                                             // VkDescriptorPoolCreateFlags    flags;
+        1u,                                             // uint32_t                       maxSets;
+        1u,                                             // uint32_t                       poolSizeCount;
+        &poolSize,                                      // const VkDescriptorPoolSize*    pPoolSizes;
+    };
+
+    vkResult = _vk.vkCreateDescriptorPool(_device, &poolCreateInfo, _allocator, &_descriptorPool);
+    GD_ASSERT(vkResult == VK_SUCCESS && "Creating the descriptor pool failed!");
+
+    const VkDescriptorSetAllocateInfo allocateInfo = {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO, // VkStructureType                 sType;
+        nullptr,                                        // const void*                     pNext;
+        _descriptorPool,                                // VkDescriptorPool                descriptorPool;
+        1u,                                             // uint32_t                        descriptorSetCount;
+        &_descriptorSetLayout,                          // const VkDescriptorSetLayout*    pSetLayouts;
+    };
+
+    vkResult = _vk.vkAllocateDescriptorSets(_device, &allocateInfo, &_coverageDescriptorSet);
+    GD_ASSERT(vkResult == VK_SUCCESS && "Allocating the descriptor set failed!");
+
+    const VkDescriptorImageInfo imageInfo = {
+        _coverageSampler,                           // VkSampler        sampler;
+        _coverageImageView,                         // VkImageView      imageView;
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,   // VkImageLayout    imageLayout;
+    };
+
+    const VkWriteDescriptorSet descriptorWrite = {
+        VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,     // VkStructureType                  sType;
+        nullptr,                                    // const void*                      pNext;
+        _coverageDescriptorSet,                     // VkDescriptorSet                  dstSet;
+        0u,                                         // uint32_t                         dstBinding;
+        0u,                                         // uint32_t                         dstArrayElement;
+        1u,                                         // uint32_t                         descriptorCount;
+        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,  // VkDescriptorType                 descriptorType;
+        &imageInfo,                                 // const VkDescriptorImageInfo*     pImageInfo;
+        nullptr,                                    // const VkDescriptorBufferInfo*    pBufferInfo;
+        nullptr,                                    // const VkBufferView*              pTexelBufferView;
+    };
+
+    _vk.vkUpdateDescriptorSets(_device, 1, &descriptorWrite, 0, nullptr);
+}
+
+uint32_t GepardVulkan::getMemoryTypeIndex(const VkMemoryRequirements memoryRequirements, const VkMemoryPropertyFlags properties)
+{
+    /* Algorithm copied from Vulkan specification */
+    for (uint32_t i = 0; i < _physicalDeviceMemoryProperties.memoryTypeCount; ++i) {
+        if ((memoryRequirements.memoryTypeBits & (1 << i)) &&
+            ((_physicalDeviceMemoryProperties.memoryTypes[i].propertyFlags & properties) == properties))
+            return i;
+    }
+
+    GD_CRASH("No feasible memory type index!");
+}
+
+/*!
+ * \brief Sub-allocate memory from the blocks of the memory type.
+ * \param isImage  the memory is bound to an optimal tiling image
+ *
+ * The new blocks are allocated with vkAllocateMemory() and the host visible
+ * ones are mapped persistently.  The images are aligned and padded to the
+ * bufferImageGranularity, so they never share a page with a buffer.
+ *
+ * \internal
+ */
+GepardVulkan::MemoryAllocation GepardVulkan::allocateMemory(const VkMemoryRequirements memoryRequirements, const VkMemoryPropertyFlags properties, const bool isImage)
+{
+    const uint32_t memoryTypeIndex = getMemoryTypeIndex(memoryRequirements, properties);
+
+    VkDeviceSize size = memoryRequirements.size;
+    VkDeviceSize alignment = memoryRequirements.alignment;
+    if (isImage) {
+        alignment = std::max(alignment, _bufferImageGranularity);
+        size = (size + _bufferImageGranularity - 1) / _bufferImageGranularity * _bufferImageGranularity;
+    }
+
+    auto it = _memoryPools.find(memoryTypeIndex);
+    if (it == _memoryPools.end()) {
+        it = _memoryPools.emplace(memoryTypeIndex, MemoryPool(kMemoryBlockSize)).first;
+    }
+    MemoryPool& pool = it->second;
+
+    const BlockAllocator::Allocation range = pool.allocator.allocate(size, alignment);
+
+    if (range.block == pool.blocks.size()) {
+        const VkMemoryAllocateInfo allocationInfo = {
+            VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,     // VkStructureType    sType;
+            nullptr,                                    // const void*        pNext;
+            pool.allocator.blockSize(range.block),      // VkDeviceSize       allocationSize;
+            memoryTypeIndex,                            // uint32_t           memoryTypeIndex;
+        };
+
+        VkDeviceMemory block;
+        VkResult vkResult;
+        vkResult = _vk.vkAllocateMemory(_device, &allocationInfo, _allocator, &block);
+        GD_ASSERT(vkResult == VK_SUCCESS && "Memory allocation failed!");
+
+        void* data = nullptr;
+        if (_physicalDeviceMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+            vkResult = _vk.vkMapMemory(_device, block, 0, VK_WHOLE_SIZE, 0, &data);
+            GD_ASSERT(vkResult == VK_SUCCESS && "Memory mapping failed!");
+        }
+
+        GD_LOG2("New device memory block of type " << memoryTypeIndex << " with " << allocationInfo.allocationSize << " bytes");
+        pool.blocks.push_back(block);
+        pool.mappedBlocks.push_back(reinterpret_cast<uint8_t*>(data));
+    }
+
+    uint8_t* mappedBlock = pool.mappedBlocks[range.block];
+    const MemoryAllocation allocation = {
+        memoryTypeIndex,
+        range,
+        pool.blocks[range.block],
+        range.offset,
+        mappedBlock ? mappedBlock + range.offset : nullptr,
+    };
+    return allocation;
+}
+
+/*!
+ * \brief Give back the range to its block, the block itself is kept.
+ *
+ * \internal
+ */
+void GepardVulkan::freeMemory(const MemoryAllocation& allocation)
+{
+    auto it = _memoryPools.find(allocation.memoryTypeIndex);
+    GD_ASSERT(it != _memoryPools.end());
+    it->second.allocator.free(allocation.range);
+}
+
+/*!
+ * \brief Usage of the device memory blocks of all memory types.
+ */
+const BlockAllocator::Statistics GepardVulkan::memoryStatistics() const
+{
+    BlockAllocator::Statistics statistics = { 0, 0, 0, 0, 0 };
+    for (const auto& pool : _memoryPools) {
+        const BlockAllocator::Statistics poolStatistics = pool.second.allocator.statistics();
+        statistics.reservedBytes += poolStatistics.reservedBytes;
+        statistics.usedBytes += poolStatistics.usedBytes;
+        statistics.fragmentedBytes += poolStatistics.fragmentedBytes;
+        statistics.blockCount += poolStatistics.blockCount;
+        statistics.allocationCount += poolStatistics.allocationCount;
+    }
+    return statistics;
+}
+
+/*!
+ * \brief Create a buffer which lives until the end of the GepardVulkan.
+ *
+ * \internal
+ */
+void GepardVulkan::createBuffer(VkBuffer& buffer, MemoryAllocation& allocation, const VkDeviceSize size, const VkBufferUsageFlags usage, const VkMemoryPropertyFlags properties)
+{
+    VkResult vkResult;
+
+    const VkBufferCreateInfo bufferInfo = {
+        VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,   // VkStructureType        sType;
+        nullptr,                                // const void*            pNext;
+        0,                                      // VkBufferCreateFlags    flags;
+        size,                                   // VkDeviceSize           size;
+        usage,                                  // VkBufferUsageFlags     usage;
+        VK_SHARING_MODE_EXCLUSIVE,              // VkSharingMode          sharingMode;
+        1u,                                     // uint32_t               queueFamilyIndexCount;
+        &_queueFamilyIndex,                     // const uint32_t*        pQueueFamilyIndices;
+    };
+
+    vkResult = _vk.vkCreateBuffer(_device, &bufferInfo, _allocator, &buffer);
+    GD_ASSERT(vkResult == VK_SUCCESS && "Creating the buffer failed!");
+    _buffers.push_back(buffer);
+
+    VkMemoryRequirements memoryRequirements;
+    _vk.vkGetBufferMemoryRequirements(_device, buffer, &memoryRequirements);
+
+    allocation = allocateMemory(memoryRequirements, properties, false);
+
+    vkResult = _vk.vkBindBufferMemory(_device, buffer, allocation.memory, allocation.offset);
+    GD_ASSERT(vkResult == VK_SUCCESS && "Memory binding failed!");
+}
+
+/*!
+ * \brief Create the default buffers: the persistently mapped vertex ring,
+ * the index buffer of the rectangles, the device local trapezoid buffer and
+ * the readback buffer of the surface.
+ *
+ * The vertex ring and the index buffer are host coherent, so the writes need
+ * no explicit flush.  The vertex ring is also the staging ring of the
+ * trapezoid buffer.
+ *
+ * \internal
+ */
+void GepardVulkan::createDefaultBuffers()
+{
+    const VkMemoryPropertyFlags hostMemory = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    _vertexRing.size = kVertexRingSize;
+    _vertexRing.offset = 0u;
+    createBuffer(_vertexRing.buffer, _vertexRing.allocation, _vertexRing.size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, hostMemory);
+    _vertexRing.data = _vertexRing.allocation.data;
+
+    const uint32_t rectIndicies[] = {0, 1, 2, 2, 1, 3};
+
+    MemoryAllocation indexBufferAllocation;
+    createBuffer(_rectIndexBuffer, indexBufferAllocation, (VkDeviceSize)sizeof(rectIndicies), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, hostMemory);
+    std::memcpy(indexBufferAllocation.data, rectIndicies, sizeof(rectIndicies));
+
+    // The ring stages the trapezoids, which must fit into a segment.
+    GD_ASSERT(kTrapezoidBufferSize <= _vertexRing.size / kFramesInFlight);
+    MemoryAllocation trapezoidBufferAllocation;
+    createBuffer(_trapezoidBuffer, trapezoidBufferAllocation, kTrapezoidBufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    if (!_context.surface->getDisplay() && _context.surface->getBuffer()) {
+        // Each frame in flight reads back into its own buffer, so the GPU
+        // does not have to wait for the CPU to copy the previous one.
+        for (auto& frame: _frames) {
+            MappedBuffer& readbackBuffer = frame.readbackBuffer;
+            readbackBuffer.size = (VkDeviceSize)_context.surface->width() * _context.surface->height() * 4;
+            readbackBuffer.offset = 0u;
+            createBuffer(readbackBuffer.buffer, readbackBuffer.allocation, readbackBuffer.size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+            readbackBuffer.data = readbackBuffer.allocation.data;
+        }
+    }
+}
+
+/*!
+ * \brief Copy the vertex data into the segment of the current frame in the
+ * vertex ring.
+ * \return the offset of the data in the _vertexRing.buffer
+ *
+ * If the segment is full, the frame is submitted without presenting it and
+ * the data goes to the next frame.
+ *
+ * \internal
+ */
+VkDeviceSize GepardVulkan::uploadVertexData(const void* vertexData, const VkDeviceSize size)
+{
+    const VkDeviceSize segmentSize = _vertexRing.size / kFramesInFlight;
+    GD_ASSERT(size <= segmentSize);
+
+    beginFrame();
+    if (_vertexRing.offset + size > (_currentFrame + 1) * segmentSize) {
+        submitFrame(false);
+        beginFrame();
+    }
+
+    const VkDeviceSize offset = _vertexRing.offset;
+    std::memcpy(_vertexRing.data + offset, vertexData, size);
+    _vertexRing.offset += size;
+
+    return offset;
+}
+
+/*!
+ * \brief Create the shader module of the embedded SPIR-V code only at the
+ * first request.
+ *
+ * \internal
+ */
+VkShaderModule GepardVulkan::getShaderModule(const uint32_t* code, const size_t codeSize)
+{
+    auto it = _shaderModules.find(code);
+    if (it != _shaderModules.end()) {
+        return it->second;
+    }
+
+    const VkShaderModuleCreateInfo modulInfo = {
+        VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,    // VkStructureType              sType;
+        nullptr,                                        // const void*                  pNext;
+        0,                                              // VkShaderModuleCreateFlags    flags;
+        codeSize,                                       // size_t                       codeSize;
+        code,                                           // const uint32_t*              pCode;
+    };
+
+    VkShaderModule shaderModule;
+    VkResult vkResult;
+    vkResult = _vk.vkCreateShaderModule(_device, &modulInfo, _allocator, &shaderModule);
+    GD_ASSERT(vkResult == VK_SUCCESS && "Creating the shader module failed!");
+
+    _shaderModules[code] = shaderModule;
+    return shaderModule;
+}
+
+/*!
+ * \brief Create the pipeline cache.
+ *
+ * If the GD_VULKAN_PIPELINE_CACHE environment variable names a file, the
+ * cache is initialized from it and it is written back at destruction, so
+ * the pipelines need not be compiled again at the next start. Data saved
+ * by an other driver or device is ignored.
+ *
+ * \internal
+ */
+void GepardVulkan::createPipelineCache()
+{
+    const char* fileName = std::getenv("GD_VULKAN_PIPELINE_CACHE");
+    std::vector<char> initialData;
+
+    if (fileName) {
+        _pipelineCacheFile = fileName;
+        std::ifstream input(_pipelineCacheFile, std::ios::binary);
+        initialData.assign((std::istreambuf_iterator<char>(input)), (std::istreambuf_iterator<char>()));
+    }
+
+    // The header of the cache data is described in the specification of vkGetPipelineCacheData.
+    const size_t headerSize = 4 * sizeof(uint32_t) + VK_UUID_SIZE;
+    if (initialData.size() >= headerSize) {
+        VkPhysicalDeviceProperties deviceProperties;
+        _vk.vkGetPhysicalDeviceProperties(_physicalDevice, &deviceProperties);
+
+        uint32_t header[4];
+        std::memcpy(header, initialData.data(), sizeof(header));
+        const bool isCompatible = header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+            && header[2] == deviceProperties.vendorID
+            && header[3] == deviceProperties.deviceID
+            && !std::memcmp(initialData.data() + sizeof(header), deviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
+
+        if (!isCompatible) {
+            GD_LOG1("Ignore the incompatible pipeline cache: " << _pipelineCacheFile);
+            initialData.clear();
+        }
+    } else {
+        initialData.clear();
+    }
+
+    const void* initialDataPointer = initialData.empty() ? nullptr : initialData.data();
+    const VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {
+        VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,   // VkStructureType               sType;
+        nullptr,                                        // const void*                   pNext;
+        0,                                              // VkPipelineCacheCreateFlags    flags;
+        initialData.size(),                             // size_t                        initialDataSize;
+        initialDataPointer,                             // const void*                   pInitialData;
+    };
+
+    VkResult vkResult;
+    vkResult = _vk.vkCreatePipelineCache(_device, &pipelineCacheCreateInfo, _allocator, &_pipelineCache);
+    GD_ASSERT(vkResult == VK_SUCCESS && "Creating the pipeline cache failed!");
+}
+
+/*!
+ * \brief Write the pipeline cache into the file given at createPipelineCache().
+ *
+ * \internal
+ */
+void GepardVulkan::savePipelineCache()
+{
+    if (_pipelineCacheFile.empty()) {
+        return;
+    }
+
+    size_t dataSize = 0;
+    _vk.vkGetPipelineCacheData(_device, _pipelineCache, &dataSize, nullptr);
+
+    std::vector<char> data(dataSize);
+    if (!dataSize || _vk.vkGetPipelineCacheData(_device, _pipelineCache, &dataSize, data.data()) != VK_SUCCESS) {
+        return;
+    }
+
+    std::ofstream output(_pipelineCacheFile, std::ios::binary | std::ios::trunc);
+    output.write(data.data(), dataSize);
+    GD_LOG1("Pipeline cache (" << dataSize << " bytes) is saved into " << _pipelineCacheFile);
+}
+
+/*!
+ * \brief Return the pipeline of the type, which is created at the first
+ * request.
+ *
+ * \internal
+ */
+VkPipeline GepardVulkan::getPipeline(const PipelineType type)
+{
+    auto it = _pipelines.find(type);
+    if (it != _pipelines.end()) {
+        return it->second;
+    }
+
+    const VkPipeline pipeline = createPipeline(type);
+    _pipelines[type] = pipeline;
+    return pipeline;
+}
+
+VkPipeline GepardVulkan::createPipeline(const PipelineType type)
+{
+    VkShaderModule vertexShader;
+    VkShaderModule fragmentShader;
+    VkRenderPass renderPass = _renderPass;
+    VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    VkBlendFactor srcBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    VkBlendFactor dstBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+
+    VkVertexInputBindingDescription bindingDescription = {
+        0u,                             // uint32_t             binding;
+        2 * (4 * sizeof(float)),        // uint32_t             stride;
+        VK_VERTEX_INPUT_RATE_VERTEX,    // VkVertexInputRate    inputRate;
+    };
+
+    std::vector<VkVertexInputAttributeDescription> vertexAttributeDescriptions;
+
+    switch (type) {
+    case FillRectPipeline:
+        vertexShader = getShaderModule(fillRectVert, sizeof(fillRectVert));
+        fragmentShader = getShaderModule(fillRectFrag, sizeof(fillRectFrag));
+        vertexAttributeDescriptions = {
+            {
+                0u,                             // uint32_t location
+                0u,                             // uint32_t binding
+                VK_FORMAT_R32G32B32A32_SFLOAT,  // VkFormat format
+                0u,                             // uint32_t offset
+            },
+            {
+                1u,                             // uint32_t location
+                0u,                             // uint32_t binding
+                VK_FORMAT_R32G32B32A32_SFLOAT,  // VkFormat format
+                sizeof(float) * 4,              // uint32_t offset
+            },
+        };
+        break;
+    case FillPathPipeline:
+        // One instance for each trapezoid: Xs and Ys, see fillPath().
+        vertexShader = getShaderModule(fillPathVert, sizeof(fillPathVert));
+        fragmentShader = getShaderModule(fillPathFrag, sizeof(fillPathFrag));
+        renderPass = _coverageRenderPass;
+        topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+        // Accumulate the coverage.
+        srcBlendFactor = VK_BLEND_FACTOR_ONE;
+        dstBlendFactor = VK_BLEND_FACTOR_ONE;
+        bindingDescription.stride = 6 * sizeof(float);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+        vertexAttributeDescriptions = {
+            {
+                0u,                             // uint32_t location
+                0u,                             // uint32_t binding
+                VK_FORMAT_R32G32B32A32_SFLOAT,  // VkFormat format
+                0u,                             // uint32_t offset
+            },
+            {
+                1u,                             // uint32_t location
+                0u,                             // uint32_t binding
+                VK_FORMAT_R32G32_SFLOAT,        // VkFormat format
+                sizeof(float) * 4,              // uint32_t offset
+            },
+        };
+        break;
+    case CopyPathPipeline:
+        vertexShader = getShaderModule(copyPathVert, sizeof(copyPathVert));
+        fragmentShader = getShaderModule(copyPathFrag, sizeof(copyPathFrag));
+        bindingDescription.stride = 2 * sizeof(float);
+        vertexAttributeDescriptions = {
+            {
+                0u,                             // uint32_t location
+                0u,                             // uint32_t binding
+                VK_FORMAT_R32G32_SFLOAT,        // VkFormat format
+                0u,                             // uint32_t offset
+            },
+        };
+        break;
+    default:
+        GD_CRASH("Unknown pipeline type!");
+    }
+
+    // The path shaders are specialized to the anti-aliasing level of the tessellator.
+    const int32_t antiAliasLevel = GD_ANTIALIAS_LEVEL;
+
+    const VkSpecializationMapEntry specializationMapEntry = {
+        0u,                     // uint32_t    constantID;
+        0u,                     // uint32_t    offset;
+        sizeof(int32_t),        // size_t      size;
+    };
+
+    const VkSpecializationInfo specializationInfo = {
+        1u,                         // uint32_t                           mapEntryCount;
+        &specializationMapEntry,    // const VkSpecializationMapEntry*    pMapEntries;
+        sizeof(antiAliasLevel),     // size_t                             dataSize;
+        &antiAliasLevel,            // const void*                        pData;
+    };
+
+    const VkPipelineShaderStageCreateInfo stages[] = {
+        {
+            VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,    // VkStructureType                     sType;
+            nullptr,                                                // const void*                         pNext;
+            0,                                                      // VkPipelineShaderStageCreateFlags    flags;
+            VK_SHADER_STAGE_VERTEX_BIT,                             // VkShaderStageFlagBits               stage;
+            vertexShader,                                           // VkShaderModule                      module;
+            "main",                                                 // const char*                         pName;
+            &specializationInfo,                                    // const VkSpecializationInfo*         pSpecializationInfo;
+        },
+        {
+            VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,    // VkStructureType                     sType;
+            nullptr,                                                // const void*                         pNext;
+            0,                                                      // VkPipelineShaderStageCreateFlags    flags;
+            VK_SHADER_STAGE_FRAGMENT_BIT,                           // VkShaderStageFlagBits               stage;
+            fragmentShader,                                         // VkShaderModule                      module;
+            "main",                                                 // const char*                         pName;
+            &specializationInfo,                                    // const VkSpecializationInfo*         pSpecializationInfo;
+        }
+    };
+
+    const VkPipelineVertexInputStateCreateInfo vertexInputState = {
+        VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,  // VkStructureType                             sType;
+        nullptr,                                                    // const void*                                 pNext;
+        0,                                                          // VkPipelineVertexInputStateCreateFlags       flags;
+        1u,                                                         // uint32_t                                    vertexBindingDescriptionCount;
+        &bindingDescription,                                        // const VkVertexInputBindingDescription*      pVertexBindingDescriptions;
+        (uint32_t)vertexAttributeDescriptions.size(),               // uint32_t                                    vertexAttributeDescriptionCount;
+        vertexAttributeDescriptions.data(),                         // const VkVertexInputAttributeDescription*    pVertexAttributeDescriptions;
+    };
+
+    const VkPipelineInputAssemblyStateCreateInfo inputAssemblyState = {
+        VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,    // VkStructureType                          sType
+        nullptr,                                                        // const void*                              pNext
+        0,                                                              // VkPipelineInputAssemblyStateCreateFlags  flags
+        topology,                                                       // VkPrimitiveTopology                      topology
+        VK_FALSE,                                                       // VkBool32                                 primitiveRestartEnable
+    };
+
+    const uint32_t width = _context.surface->width();
+    const uint32_t height = _context.surface->height();
+    const VkViewport viewports[] = {
+        {
+            0.0f,           // float    x;
+            0.0f,           // float    y;
+            (float)width,   // float    width;
+            (float)height,  // float    height;
+            0.0f,           // float    minDepth;
+            1.0f,           // float    maxDepth;
+        }
+    };
+
+    const VkRect2D scissors[] = {
+        {
+            {
+                0,      // int32_t x
+                0,      // int32_t y
+            },  // VkOffset2D    offset;
+            {
+                width,  // uint32_t    width
+                height, // uint32_t    height
+            }, // VkExtent2D    extent;
+        }
+    };
+
+    const VkPipelineViewportStateCreateInfo viewportState = {
+        VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,  // VkStructureType                       sType;
+        nullptr,                                                // const void*                           pNext;
+        0,                                                      // VkPipelineViewportStateCreateFlags    flags;
+        1u,                                                     // uint32_t                              viewportCount;
+        viewports,                                              // const VkViewport*                     pViewports;
+        1u,                                                     // uint32_t                              scissorCount;
+        scissors,                                               // const VkRect2D*                       pScissors;
+    };
+
+    const VkPipelineRasterizationStateCreateInfo rasterizationState = {
+        VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO, // VkStructureType                            sType;
+        nullptr,                                                    // const void*                                pNext;
+        0,                                                          // VkPipelineRasterizationStateCreateFlags    flags;
+        VK_FALSE,                                                   // VkBool32                                   depthClampEnable;
+        VK_FALSE,                                                   // VkBool32                                   rasterizerDiscardEnable;
+        VK_POLYGON_MODE_FILL,                                       // VkPolygonMode                              polygonMode;
+        VK_CULL_MODE_NONE,                                          // VkCullModeFlags                            cullMode;
+        VK_FRONT_FACE_COUNTER_CLOCKWISE,                            // VkFrontFace                                frontFace;
+        VK_FALSE,                                                   // VkBool32                                   depthBiasEnable;
+        0.0f,                                                       // float                                      depthBiasConstantFactor;
+        0.0f,                                                       // float                                      depthBiasClamp;
+        0.0f,                                                       // float                                      depthBiasSlopeFactor;
+        1.0f,                                                       // float                                      lineWidth;
     };
 
-    VkFence fence;
-    _vk.vkCreateFence(_device, &fenceInfo, _allocator, &fence);
-    _vk.vkQueueSubmit(queue, 1, &submitInfo, fence);
-    _vk.vkWaitForFences(_device, 1, &fence, VK_TRUE, timeout);
-    _vk.vkDestroyFence(_device, fence, _allocator);
-}
+    const VkPipelineMultisampleStateCreateInfo multisampleState = {
+        VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,   // VkStructureType                          sType;
+        nullptr,                                                    // const void*                              pNext;
+        0,                                                          // VkPipelineMultisampleStateCreateFlags    flags;
+        VK_SAMPLE_COUNT_1_BIT,                                      // VkSampleCountFlagBits                    rasterizationSamples;
+        VK_FALSE,                                                   // VkBool32                                 sampleShadingEnable;
+        0.0,                                                        // float                                    minSampleShading;
+        nullptr,                                                    // const VkSampleMask*                      pSampleMask;
+        VK_FALSE,                                                   // VkBool32                                 alphaToCoverageEnable;
+        VK_FALSE,                                                   // VkBool32                                 alphaToOneEnable;
+    };
 
-void GepardVulkan::createDefaultFrameBuffer()
-{
-    VkResult vkResult;
+    const VkPipelineColorBlendAttachmentState colorBlendAttachmentState = {
+        VK_TRUE,                                                                                                    // VkBool32                 blendEnable;
+        srcBlendFactor,                                                                                             // VkBlendFactor            srcColorBlendFactor;
+        dstBlendFactor,                                                                                             // VkBlendFactor            dstColorBlendFactor;
+        VK_BLEND_OP_ADD,                                                                                            // VkBlendOp                colorBlendOp;
+        srcBlendFactor,                                                                                             // VkBlendFactor            srcAlphaBlendFactor;
+        dstBlendFactor,                                                                                             // VkBlendFactor            dstAlphaBlendFactor;
+        VK_BLEND_OP_ADD,                                                                                            // VkBlendOp                alphaBlendOp;
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT   // VkColorComponentFlags    colorWriteMask;
+    };
 
-    const VkImageViewCreateInfo imageViewCreateInfo = {
-        VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,   // VkStructureType            sType;
-        nullptr,                                    // const void*                pNext;
-        0,                                          // VkImageViewCreateFlags     flags;
-        _surfaceImage,                              // VkImage                    image;
-        VK_IMAGE_VIEW_TYPE_2D,                      // VkImageViewType            viewType;
-        _imageFormat,                               // VkFormat                   format;
-        {
-            VK_COMPONENT_SWIZZLE_IDENTITY, // swizzle r
-            VK_COMPONENT_SWIZZLE_IDENTITY, // swizzle g
-            VK_COMPONENT_SWIZZLE_IDENTITY, // swizzle b
-            VK_COMPONENT_SWIZZLE_IDENTITY, // swizzle a
-        },                                          // VkComponentMapping         components;
+    const VkPipelineColorBlendStateCreateInfo colorBlendState = {
+        VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,   // VkStructureType                               sType;
+        nullptr,                                                    // const void*                                   pNext;
+        0,                                                          // VkPipelineColorBlendStateCreateFlags          flags;
+        VK_FALSE,                                                   // VkBool32                                      logicOpEnable;
+        VK_LOGIC_OP_COPY,                                           // VkLogicOp                                     logicOp;
+        1u,                                                         // uint32_t                                      attachmentCount;
+        &colorBlendAttachmentState,                                 // const VkPipelineColorBlendAttachmentState*    pAttachments;
         {
-            VK_IMAGE_ASPECT_COLOR_BIT,  // VkImageAspectFlags    aspectMask;
-            0u,                         // uint32_t              baseMipLevel;
-            1u,                         // uint32_t              levelCount;
-            0u,                         // uint32_t              baseArrayLayer;
-            1u,                         // uint32_t              layerCount;
-        },                                          // VkImageSubresourceRange    subresourceRange;
+            0.0f,   // float R
+            0.0f,   // float G
+            0.0f,   // float B
+            0.0f,   // float A
+        },                                                          // float                                         blendConstants[4];
     };
 
-    vkResult = _vk.vkCreateImageView(_device, &imageViewCreateInfo, _allocator, &_frameBufferColorAttachmentImageView);
-    GD_ASSERT(vkResult == VK_SUCCESS && "Creating the default frame buffer failed!");
+    // All pipelines share the layout, the fill rect pipeline just ignores the
+    // coverage descriptor set and the push constants.
+    const VkPushConstantRange pushConstantRange = {
+        VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,  // VkShaderStageFlags    stageFlags;
+        0u,                                                         // uint32_t              offset;
+        sizeof(PathPushConstants),                                  // uint32_t              size;
+    };
 
-    std::vector<VkImageView> attachments;
-    attachments.push_back(_frameBufferColorAttachmentImageView);
+    const VkPipelineLayoutCreateInfo layoutCreateInfo = {
+          VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,  // VkStructureType                sType
+          nullptr,                                        // const void                    *pNext
+          0,                                              // VkPipelineLayoutCreateFlags    flags
+          1u,                                             // uint32_t                       setLayoutCount
+          &_descriptorSetLayout,                          // const VkDescriptorSetLayout   *pSetLayouts
+          1u,                                             // uint32_t                       pushConstantRangeCount
+          &pushConstantRange                              // const VkPushConstantRange     *pPushConstantRanges
+    };
 
-    const VkFramebufferCreateInfo frameBufferCreateInfo = {
-        VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,  // VkStructureType             sType;
-        nullptr,                                    // const void*                 pNext;
-        0u,                                         // VkFramebufferCreateFlags    flags;
-        _renderPass,                                // VkRenderPass                renderPass;
-        static_cast<uint32_t>(attachments.size()),  // uint32_t                    attachmentCount;
-        attachments.data(),                         // const VkImageView*          pAttachments;
-        _context.surface->width(),                  // uint32_t                    width;
-        _context.surface->height(),                 // uint32_t                    height;
-        1u,                                         // uint32_t                    layers;
+    if (!_pipelineLayout) {
+        _vk.vkCreatePipelineLayout(_device, &layoutCreateInfo, _allocator, &_pipelineLayout);
+    }
+
+    const VkGraphicsPipelineCreateInfo pipelineCreateInfo = {
+        VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,    // VkStructureType                                  sType;
+        nullptr,                                            // const void*                                      pNext;
+        0,                                                  // VkPipelineCreateFlags                            flags;
+        2u,                                                 // uint32_t                                         stageCount;
+        stages,                                             // const VkPipelineShaderStageCreateInfo*           pStages;
+        &vertexInputState,                                  // const VkPipelineVertexInputStateCreateInfo*      pVertexInputState;
+        &inputAssemblyState,                                // const VkPipelineInputAssemblyStateCreateInfo*    pInputAssemblyState;
+        nullptr,                                            // const VkPipelineTessellationStateCreateInfo*     pTessellationState;
+        &viewportState,                                     // const VkPipelineViewportStateCreateInfo*         pViewportState;
+        &rasterizationState,                                // const VkPipelineRasterizationStateCreateInfo*    pRasterizationState;
+        &multisampleState,                                  // const VkPipelineMultisampleStateCreateInfo*      pMultisampleState;
+        nullptr,                                            // const VkPipelineDepthStencilStateCreateInfo*     pDepthStencilState;
+        &colorBlendState,                                   // const VkPipelineColorBlendStateCreateInfo*       pColorBlendState;
+        nullptr,                                            // const VkPipelineDynamicStateCreateInfo*          pDynamicState;
+        _pipelineLayout,                                    // VkPipelineLayout                                 layout;
+        renderPass,                                         // VkRenderPass                                     renderPass;
+        0u,                                                 // uint32_t                                         subpass;
+        VK_NULL_HANDLE,                                     // VkPipeline                                       basePipelineHandle;
+        0,                                                  // int32_t                                          basePipelineIndex;
     };
 
-    vkResult = _vk.vkCreateFramebuffer(_device, &frameBufferCreateInfo, _allocator, &_frameBuffer);
-    GD_ASSERT(vkResult == VK_SUCCESS && "Creating the default frame buffer failed!");
-}
+    VkPipeline pipeline;
 
-uint32_t GepardVulkan::getMemoryTypeIndex(const VkMemoryRequirements memoryRequirements, const VkMemoryPropertyFlags properties)
-{
-    /* Algorithm copied from Vulkan specification */
-    for (uint32_t i = 0; i < _physicalDeviceMemoryProperties.memoryTypeCount; ++i) {
-        if ((memoryRequirements.memoryTypeBits & (1 << i)) &&
-            ((_physicalDeviceMemoryProperties.memoryTypes[i].propertyFlags & properties) == properties))
-            return i;
-    }
+    VkResult vkResult;
+    vkResult = _vk.vkCreateGraphicsPipelines(_device, _pipelineCache, 1, &pipelineCreateInfo, _allocator, &pipeline);
+    GD_ASSERT(vkResult == VK_SUCCESS && "Creating the graphics pipeline failed!");
 
-    GD_CRASH("No feasible memory type index!");
+    return pipeline;
 }
 
 void GepardVulkan::createSwapChain()
@@ -1034,31 +1934,13 @@ void GepardVulkan::createSwapChain()
     _vk.vkGetSwapchainImagesKHR(_device, _wsiSwapChain, &swapchainImagesCount, _wsiSwapChainImages.data());
 }
 
-void GepardVulkan::presentImage()
+/*!
+ * \brief Record the copy of the surface image to the swap chain image.
+ *
+ * \internal
+ */
+void GepardVulkan::recordPresentImage(const VkCommandBuffer commandBuffer, const uint32_t imageIndex)
 {
-    const VkFenceCreateInfo fenceInfo = {
-        VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,    // VkStructureType       sType;
-        nullptr,                                // const void*           pNext;
-        0,                                      // VkFenceCreateFlags    flags;
-    };
-    VkFence fence;
-    _vk.vkCreateFence(_device, &fenceInfo, _allocator, &fence);
-
-    uint32_t imageIndex;
-    _vk.vkAcquireNextImageKHR(_device, _wsiSwapChain, timeout, VK_NULL_HANDLE, fence, &imageIndex);
-
-    VkQueue queue;
-    _vk.vkGetDeviceQueue(_device, _queueFamilyIndex, 0, &queue);
-
-    const VkCommandBuffer commandBuffer = _primaryCommandBuffers[0];
-
-    const VkCommandBufferBeginInfo commandBufferBeginInfo = {
-       VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, // VkStructureType                          sType;
-       nullptr,                                     // const void*                              pNext;
-       VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, // VkCommandBufferUsageFlags                flags;
-       nullptr,                                     // const VkCommandBufferInheritanceInfo*    pInheritanceInfo;
-    };
-
     const VkImageSubresourceLayers subresource = {
         VK_IMAGE_ASPECT_COLOR_BIT,  // VkImageAspectFlags    aspectMask;
         0u,                         // uint32_t              mipLevel;
@@ -1074,16 +1956,16 @@ void GepardVulkan::presentImage()
     };
 
     const VkImageBlit imageCopy = {
-        subresource,    // VkImageSubresourceLayers    srcSubresource;
+        subresource,        // VkImageSubresourceLayers    srcSubresource;
         {
             topLeftCorner,
             bottomRightCorner,
-        },              // VkOffset3D                  srcOffsets[2];
-        subresource,    // VkImageSubresourceLayers    dstSubresource;
+        },                  // VkOffset3D                  srcOffsets[2];
+        subresource,        // VkImageSubresourceLayers    dstSubresource;
         {
             topLeftCorner,
             bottomRightCorner,
-        },              // VkOffset3D                  dstOffsets[2];
+        },                  // VkOffset3D                  dstOffsets[2];
     };
 
     const VkImageSubresourceRange subresourceRange = {
@@ -1094,140 +1976,76 @@ void GepardVulkan::presentImage()
         1u,                         // uint32_t              layerCount;
     };
 
-    const VkImageMemoryBarrier preCopyBarrierFBO = {
-        VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,     // VkStructureType            sType;
-        nullptr,                                    // const void*                pNext;
-        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,       // VkAccessFlags              srcAccessMask;
-        VK_ACCESS_TRANSFER_READ_BIT,                // VkAccessFlags              dstAccessMask;
-        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,   // VkImageLayout              oldLayout;
-        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,       // VkImageLayout              newLayout;
-        _queueFamilyIndex,                          // uint32_t                   srcQueueFamilyIndex;
-        _queueFamilyIndex,                          // uint32_t                   dstQueueFamilyIndex;
-        _surfaceImage,                              // VkImage                    image;
-        subresourceRange,                           // VkImageSubresourceRange    subresourceRange;
-    };
-
-    const VkImageMemoryBarrier postCopyBarrierFBO = {
-        VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,     // VkStructureType            sType;
-        nullptr,                                    // const void*                pNext;
-        VK_ACCESS_TRANSFER_READ_BIT,                // VkAccessFlags              srcAccessMask;
-        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,       // VkAccessFlags              dstAccessMask;
-        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,       // VkImageLayout              oldLayout;
-        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,   // VkImageLayout              newLayout;
-        _queueFamilyIndex,                          // uint32_t                   srcQueueFamilyIndex;
-        _queueFamilyIndex,                          // uint32_t                   dstQueueFamilyIndex;
-        _surfaceImage,                              // VkImage                    image;
-        subresourceRange,                           // VkImageSubresourceRange    subresourceRange;
-    };
-
-    const VkImageMemoryBarrier preCopyBarrierWSI = {
-        VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER, // VkStructureType            sType;
-        nullptr,                                // const void*                pNext;
-        VK_ACCESS_MEMORY_READ_BIT,              // VkAccessFlags              srcAccessMask;
-        VK_ACCESS_TRANSFER_WRITE_BIT,           // VkAccessFlags              dstAccessMask;
-        VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,        // VkImageLayout              oldLayout;
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,   // VkImageLayout              newLayout;
-        _queueFamilyIndex,                      // uint32_t                   srcQueueFamilyIndex;
-        _queueFamilyIndex,                      // uint32_t                   dstQueueFamilyIndex;
-        _surfaceImage,                          // VkImage                    image;
-        subresourceRange,                       // VkImageSubresourceRange    subresourceRange;
-    };
-
-    const VkImageMemoryBarrier postCopyBarrierWSI = {
-        VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER, // VkStructureType            sType;
-        nullptr,                                // const void*                pNext;
-        VK_ACCESS_TRANSFER_WRITE_BIT,           // VkAccessFlags              srcAccessMask;
-        VK_ACCESS_MEMORY_READ_BIT,              // VkAccessFlags              dstAccessMask;
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,   // VkImageLayout              oldLayout;
-        VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,        // VkImageLayout              newLayout;
-        _queueFamilyIndex,                      // uint32_t                   srcQueueFamilyIndex;
-        _queueFamilyIndex,                      // uint32_t                   dstQueueFamilyIndex;
-        _wsiSwapChainImages[imageIndex],        // VkImage                    image;
-        subresourceRange,                       // VkImageSubresourceRange    subresourceRange;
-    };
-
     const VkImageMemoryBarrier preCopyBarriers[] = {
-        preCopyBarrierFBO,
-        preCopyBarrierWSI,
+        {
+            VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,     // VkStructureType            sType;
+            nullptr,                                    // const void*                pNext;
+            VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,       // VkAccessFlags              srcAccessMask;
+            VK_ACCESS_TRANSFER_READ_BIT,                // VkAccessFlags              dstAccessMask;
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,   // VkImageLayout              oldLayout;
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,       // VkImageLayout              newLayout;
+            VK_QUEUE_FAMILY_IGNORED,                    // uint32_t                   srcQueueFamilyIndex;
+            VK_QUEUE_FAMILY_IGNORED,                    // uint32_t                   dstQueueFamilyIndex;
+            _surfaceImage,                              // VkImage                    image;
+            subresourceRange,                           // VkImageSubresourceRange    subresourceRange;
+        },
+        {
+            // The whole swap chain image is overwritten, so its old content is dropped.
+            VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,     // VkStructureType            sType;
+            nullptr,                                    // const void*                pNext;
+            0,                                          // VkAccessFlags              srcAccessMask;
+            VK_ACCESS_TRANSFER_WRITE_BIT,               // VkAccessFlags              dstAccessMask;
+            VK_IMAGE_LAYOUT_UNDEFINED,                  // VkImageLayout              oldLayout;
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,       // VkImageLayout              newLayout;
+            VK_QUEUE_FAMILY_IGNORED,                    // uint32_t                   srcQueueFamilyIndex;
+            VK_QUEUE_FAMILY_IGNORED,                    // uint32_t                   dstQueueFamilyIndex;
+            _wsiSwapChainImages[imageIndex],            // VkImage                    image;
+            subresourceRange,                           // VkImageSubresourceRange    subresourceRange;
+        },
     };
 
     const VkImageMemoryBarrier postCopyBarriers[] = {
-        postCopyBarrierFBO,
-        postCopyBarrierWSI,
+        {
+            VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,     // VkStructureType            sType;
+            nullptr,                                    // const void*                pNext;
+            VK_ACCESS_TRANSFER_READ_BIT,                // VkAccessFlags              srcAccessMask;
+            VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,       // VkAccessFlags              dstAccessMask;
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,       // VkImageLayout              oldLayout;
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,   // VkImageLayout              newLayout;
+            VK_QUEUE_FAMILY_IGNORED,                    // uint32_t                   srcQueueFamilyIndex;
+            VK_QUEUE_FAMILY_IGNORED,                    // uint32_t                   dstQueueFamilyIndex;
+            _surfaceImage,                              // VkImage                    image;
+            subresourceRange,                           // VkImageSubresourceRange    subresourceRange;
+        },
+        {
+            VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,     // VkStructureType            sType;
+            nullptr,                                    // const void*                pNext;
+            VK_ACCESS_TRANSFER_WRITE_BIT,               // VkAccessFlags              srcAccessMask;
+            VK_ACCESS_MEMORY_READ_BIT,                  // VkAccessFlags              dstAccessMask;
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,       // VkImageLayout              oldLayout;
+            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,            // VkImageLayout              newLayout;
+            VK_QUEUE_FAMILY_IGNORED,                    // uint32_t                   srcQueueFamilyIndex;
+            VK_QUEUE_FAMILY_IGNORED,                    // uint32_t                   dstQueueFamilyIndex;
+            _wsiSwapChainImages[imageIndex],            // VkImage                    image;
+            subresourceRange,                           // VkImageSubresourceRange    subresourceRange;
+        },
     };
 
-    _vk.vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo);
-    _vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_HOST_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, (VkDependencyFlags)0, 0, (const VkMemoryBarrier*)nullptr, 0, (const VkBufferMemoryBarrier*)nullptr, 2, preCopyBarriers);
+    _vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, (VkDependencyFlags)0, 0, (const VkMemoryBarrier*)nullptr, 0, (const VkBufferMemoryBarrier*)nullptr, 2, preCopyBarriers);
     _vk.vkCmdBlitImage(commandBuffer, _surfaceImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, _wsiSwapChainImages[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageCopy, VK_FILTER_NEAREST);
-    _vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, (VkDependencyFlags)0, 0, (const VkMemoryBarrier*)nullptr, 0, (const VkBufferMemoryBarrier*)nullptr, 2, postCopyBarriers);
-    _vk.vkEndCommandBuffer(commandBuffer);
-
-    const VkSubmitInfo submitInfo = {
-        VK_STRUCTURE_TYPE_SUBMIT_INFO,  // VkStructureType                sType;
-        nullptr,                        // const void*                    pNext;
-        0u,                             // uint32_t                       waitSemaphoreCount;
-        nullptr,                        // const VkSemaphore*             pWaitSemaphores;
-        nullptr,                        // const VkPipelineStageFlags*    pWaitDstStageMask;
-        1u,                             // uint32_t                       commandBufferCount;
-        &commandBuffer,                 // const VkCommandBuffer*         pCommandBuffers;
-        0u,                             // uint32_t                       signalSemaphoreCount;
-        nullptr,                        // const VkSemaphore*             pSignalSemaphores;
-    };
-
-    _vk.vkQueueSubmit(queue, 1, &submitInfo, fence);
-    _vk.vkWaitForFences(_device, 1, &fence, VK_TRUE, timeout);
-
-    const VkPresentInfoKHR presentInfo = {
-        VK_STRUCTURE_TYPE_PRESENT_INFO_KHR, // VkStructureType          sType;
-        nullptr,                            // const void*              pNext;
-        0u,                                 // uint32_t                 waitSemaphoreCount;
-        VK_NULL_HANDLE,                     // const VkSemaphore*       pWaitSemaphores;
-        1u,                                 // uint32_t                 swapchainCount;
-        &_wsiSwapChain,                     // const VkSwapchainKHR*    pSwapchains;
-        &imageIndex,                        // const uint32_t*          pImageIndices;
-        nullptr,                            // VkResult*                pResults;
-    };
-
-    _vk.vkQueuePresentKHR(queue, &presentInfo);
-
-    // Clean up
-    _vk.vkDestroyFence(_device, fence, _allocator);
+    _vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, (VkDependencyFlags)0, 0, (const VkMemoryBarrier*)nullptr, 0, (const VkBufferMemoryBarrier*)nullptr, 2, postCopyBarriers);
 }
 
-void GepardVulkan::readImage()
+/*!
+ * \brief Record the copy of the surface image to the readback buffer of
+ * the frame.
+ *
+ * \internal
+ */
+void GepardVulkan::recordReadImage(const VkCommandBuffer commandBuffer, const MappedBuffer& readbackBuffer)
 {
-    VkBuffer buffer;
-    VkDeviceMemory bufferAlloc;
-    const VkCommandBuffer commandBuffer = _primaryCommandBuffers[0];
     const uint32_t width = _context.surface->width();
-    const uint32_t height = _context.surface->width();
-    const VkDeviceSize dataSize = width * height * 4; // r8g8b8a8 format
-
-    // Create destination buffer
-    const VkBufferCreateInfo bufferInfo = {
-        VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,   // VkStructureType        sType;
-        nullptr,                                // const void*            pNext;
-        0u,                                     // VkBufferCreateFlags    flags;
-        dataSize,                               // VkDeviceSize           size;
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT,       // VkBufferUsageFlags     usage;
-        VK_SHARING_MODE_EXCLUSIVE,              // VkSharingMode          sharingMode;
-        1u,                                     // uint32_t               queueFamilyIndexCount;
-        &_queueFamilyIndex,                     // const uint32_t*        pQueueFamilyIndices;
-    };
-
-    _vk.vkCreateBuffer(_device, &bufferInfo, _allocator, &buffer);
-
-    VkMemoryRequirements memoryRequirements;
-    _vk.vkGetBufferMemoryRequirements(_device, buffer, &memoryRequirements);
-    const VkMemoryAllocateInfo allocationInfo = {
-        VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,                                         // VkStructureType    sType;
-        nullptr,                                                                        // const void*        pNext;
-        memoryRequirements.size,                                                        // VkDeviceSize       allocationSize;
-        getMemoryTypeIndex(memoryRequirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT),    // uint32_t           memoryTypeIndex;
-    };
-
-    _vk.vkAllocateMemory(_device, &allocationInfo, _allocator, &bufferAlloc);
-    _vk.vkBindBufferMemory(_device, buffer, bufferAlloc, 0);
+    const uint32_t height = _context.surface->height();
 
     const VkImageSubresourceRange subresourceRange = {
         VK_IMAGE_ASPECT_COLOR_BIT,  // VkImageAspectFlags    aspectMask;
@@ -1257,8 +2075,8 @@ void GepardVulkan::readImage()
         VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,       // VkAccessFlags              dstAccessMask;
         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,       // VkImageLayout              oldLayout;
         VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,   // VkImageLayout              newLayout;
-        _queueFamilyIndex,                          // uint32_t                   srcQueueFamilyIndex;
-        _queueFamilyIndex,                          // uint32_t                   dstQueueFamilyIndex;
+        VK_QUEUE_FAMILY_IGNORED,                    // uint32_t                   srcQueueFamilyIndex;
+        VK_QUEUE_FAMILY_IGNORED,                    // uint32_t                   dstQueueFamilyIndex;
         _surfaceImage,                              // VkImage                    image;
         subresourceRange,                           // VkImageSubresourceRange    subresourceRange;
     };
@@ -1270,16 +2088,16 @@ void GepardVulkan::readImage()
         VK_ACCESS_HOST_READ_BIT,                    // VkAccessFlags      dstAccessMask;
         VK_QUEUE_FAMILY_IGNORED,                    // uint32_t           srcQueueFamilyIndex;
         VK_QUEUE_FAMILY_IGNORED,                    // uint32_t           dstQueueFamilyIndex;
-        buffer,                                     // VkBuffer           buffer;
+        readbackBuffer.buffer,                      // VkBuffer           buffer;
         0u,                                         // VkDeviceSize       offset;
-        dataSize,                                   // VkDeviceSize       size;
+        readbackBuffer.size,                        // VkDeviceSize       size;
     };
 
     const VkImageSubresourceLayers imageSubresource = {
         VK_IMAGE_ASPECT_COLOR_BIT,  // VkImageAspectFlags    aspectMask;
         0u,                         // uint32_t              mipLevel;
         0u,                         // uint32_t              baseArrayLayer;
-        1u,                         // uint32_t              baseArrayLayer;
+        1u,                         // uint32_t              layerCount;
     };
 
     const VkBufferImageCopy copyRegion = {
@@ -1289,72 +2107,73 @@ void GepardVulkan::readImage()
         imageSubresource,   // VkImageSubresourceLayers    imageSubresource;
         { 0, 0, 0 },        // VkOffset3D                  imageOffset;
         {
-            width,
-            height,
-            1u,
+            width,          // uint32_t    width;
+            height,         // uint32_t    height;
+            1u,             // uint32_t    depth;
         },                  // VkExtent3D                  imageExtent;
     };
 
-    const VkCommandBufferBeginInfo commandBufferBeginInfo = {
-       VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, // VkStructureType                          sType;
-       nullptr,                                     // const void*                              pNext;
-       VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, // VkCommandBufferUsageFlags                flags;
-       nullptr,                                     // const VkCommandBufferInheritanceInfo*    pInheritanceInfo;
-    };
-
-    _vk.vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo);
-
     _vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, (VkDependencyFlags)0, 0, (const VkMemoryBarrier*)nullptr, 0, (const VkBufferMemoryBarrier*)nullptr, 1, &preImageBarrier);
-    _vk.vkCmdCopyImageToBuffer(commandBuffer, _surfaceImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &copyRegion);
-    _vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, (VkDependencyFlags)0, 0, (const VkMemoryBarrier*)nullptr, 1, &bufferBarrier, 1, &postImageBarrier);
-    _vk.vkEndCommandBuffer(commandBuffer);
-
-    const VkSubmitInfo submitInfo = {
-        VK_STRUCTURE_TYPE_SUBMIT_INFO,  // VkStructureType                sType;
-        nullptr,                        // const void*                    pNext;
-        0u,                             // uint32_t                       waitSemaphoreCount;
-        nullptr,                        // const VkSemaphore*             pWaitSemaphores;
-        nullptr,                        // const VkPipelineStageFlags*    pWaitDstStageMask;
-        1u,                             // uint32_t                       commandBufferCount;
-        &commandBuffer,                 // const VkCommandBuffer*         pCommandBuffers;
-        0u,                             // uint32_t                       signalSemaphoreCount;
-        nullptr,                        // const VkSemaphore*             pSignalSemaphores;
-    };
-
-    VkQueue queque;
-    _vk.vkGetDeviceQueue(_device, _queueFamilyIndex, 0, &queque);
+    _vk.vkCmdCopyImageToBuffer(commandBuffer, _surfaceImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readbackBuffer.buffer, 1, &copyRegion);
+    _vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, (VkDependencyFlags)0, 0, (const VkMemoryBarrier*)nullptr, 1, &bufferBarrier, 1, &postImageBarrier);
+}
 
-    const VkFenceCreateInfo fenceInfo = {
-        VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,    // VkStructureType       sType;
-        nullptr,                                // const void*           pNext;
-        0,                                      // VkFenceCreateFlags    flags;
-    };
+/*!
+ * \brief Copy the finished readbacks into the buffer of the surface.
+ * \param wait  wait for the GPU to finish every pending readback
+ *
+ * The frames are visited from the oldest one, so the surface receives them
+ * in the order of the flushes, together with the empty frames between them.
+ * Without waiting, it stops at the first frame which is still in flight.
+ *
+ * \internal
+ */
+void GepardVulkan::completeReadbacks(const bool wait)
+{
+    for (uint32_t i = 0; i < kFramesInFlight; ++i) {
+        Frame& frame = _frames[(_currentFrame + i) % kFramesInFlight];
 
-    VkFence fence;
-    _vk.vkCreateFence(_device, &fenceInfo, _allocator, &fence);
-    _vk.vkQueueSubmit(queque, 1, &submitInfo, fence);
-    _vk.vkWaitForFences(_device, 1, &fence, VK_TRUE, timeout);
+        if (!frame.readbackFrame) {
+            continue;
+        }
 
-    void* data;
-    _vk.vkMapMemory(_device, bufferAlloc, 0, dataSize, 0, &data);
+        if (wait) {
+            _vk.vkWaitForFences(_device, 1, &frame.fence, VK_TRUE, UINT64_MAX);
+        } else if (_vk.vkGetFenceStatus(_device, frame.fence) != VK_SUCCESS) {
+            return;
+        }
 
-    const VkMappedMemoryRange range = {
-        VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,  // VkStructureType    sType;
-        nullptr,                                // const void*        pNext;
-        bufferAlloc,                            // VkDeviceMemory     memory;
-        0,                                      // VkDeviceSize       offset;
-        dataSize,                               // VkDeviceSize       size;
-    };
+        const VkMappedMemoryRange range = {
+            VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,          // VkStructureType    sType;
+            nullptr,                                        // const void*        pNext;
+            frame.readbackBuffer.allocation.memory,         // VkDeviceMemory     memory;
+            0,                                              // VkDeviceSize       offset;
+            VK_WHOLE_SIZE,                                  // VkDeviceSize       size;
+        };
 
-    _vk.vkInvalidateMappedMemoryRanges(_device, 1, &range);
-    std::memcpy(_context.surface->getBuffer(), data, dataSize);
+        // The whole block is invalidated, which is always aligned to the
+        // nonCoherentAtomSize.
+        _vk.vkInvalidateMappedMemoryRanges(_device, 1, &range);
+        completeEmptyFrames(frame.readbackFrame);
+        std::memcpy(_context.surface->getBuffer(), frame.readbackBuffer.data, frame.readbackBuffer.size);
+        _context.surface->frameReady(frame.readbackFrame);
+        frame.readbackFrame = 0u;
+    }
 
-    // Clean up
-    _vk.vkUnmapMemory(_device, bufferAlloc);
+    completeEmptyFrames(UINT64_MAX);
+}
 
-    _vk.vkFreeMemory(_device, bufferAlloc, _allocator);
-    _vk.vkDestroyFence(_device, fence, _allocator);
-    _vk.vkDestroyBuffer(_device, buffer, _allocator);
+/*!
+ * \brief Notify the surface about the empty frames before the _frame_.
+ *
+ * \internal
+ */
+void GepardVulkan::completeEmptyFrames(const uint64_t frame)
+{
+    while (!_emptyFrames.empty() && _emptyFrames.front() < frame) {
+        _context.surface->frameReady(_emptyFrames.front());
+        _emptyFrames.pop_front();
+    }
 }
 
 } // namespace vulkan
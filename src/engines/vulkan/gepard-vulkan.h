@@ -30,11 +30,19 @@
 
 #include "gepard-defs.h"
 
+#include "gepard-block-allocator.h"
+#include "gepard-color.h"
 #include "gepard-context.h"
+#include "gepard-engine-backend.h"
 #include "gepard-float.h"
 #include "gepard-image.h"
+#include "gepard-state.h"
+#include "gepard-trapezoid-tessellator.h"
 #include "gepard-vulkan-interface.h"
 #include "gepard.h"
+#include <deque>
+#include <map>
+#include <string>
 #include <vector>
 
 namespace gepard {
@@ -44,16 +52,100 @@ class Surface;
 
 namespace vulkan {
 
-class GepardVulkan {
+class GepardVulkan : public GepardEngineBackend {
 public:
+    static const uint32_t kFramesInFlight;
+    static const VkDeviceSize kVertexRingSize;
+    static const VkDeviceSize kTrapezoidBufferSize;
+    static const VkDeviceSize kMemoryBlockSize;
+
+    static const bool isAvailable(Surface*);
+
     explicit GepardVulkan(GepardContext&);
-    ~GepardVulkan();
+    virtual ~GepardVulkan();
+
+    virtual const Gepard::Backend type() const { return Gepard::VulkanBackend; }
 
-    void fillRect(const Float x, const Float y, const Float w, const Float h);
-    void fill();
-    void stroke();
+    virtual void fillRect(const Float x, const Float y, const Float w, const Float h, const Color& fillColor);
+    virtual void fillPath(PathData*, const GepardState&, const TrapezoidTessellator::FillRule = TrapezoidTessellator::NonZero);
+    virtual void strokePath(PathData*, const GepardState&);
+    virtual void flush();
+    virtual void finish();
+
+    const BlockAllocator::Statistics memoryStatistics() const;
 
 private:
+    enum PipelineType {
+        FillRectPipeline,
+        FillPathPipeline,
+        CopyPathPipeline,
+    };
+
+    /*!
+     * \brief The push constants of the path pipelines, see the shaders.
+     *
+     * \internal
+     */
+    struct PathPushConstants {
+        float size[2];
+        float padding[2];
+        float color[4];
+    };
+
+    /*!
+     * \brief A range of a device memory block, see allocateMemory().
+     *
+     * \internal
+     */
+    struct MemoryAllocation {
+        uint32_t memoryTypeIndex;
+        BlockAllocator::Allocation range;
+        VkDeviceMemory memory; //!< The block.
+        VkDeviceSize offset;
+        uint8_t* data; //!< Mapped pointer of host visible memory, otherwise nullptr.
+    };
+
+    /*!
+     * \brief The device memory blocks of a memory type.
+     *
+     * \internal
+     */
+    struct MemoryPool {
+        explicit MemoryPool(const VkDeviceSize blockSize) : allocator(blockSize) {}
+
+        BlockAllocator allocator;
+        std::vector<VkDeviceMemory> blocks;
+        std::vector<uint8_t*> mappedBlocks;
+    };
+
+    /*!
+     * \brief Persistently mapped host buffer.
+     *
+     * \internal
+     */
+    struct MappedBuffer {
+        VkBuffer buffer;
+        MemoryAllocation allocation;
+        VkDeviceSize size;
+        VkDeviceSize offset; //!< The first free byte.
+        uint8_t* data;
+    };
+
+    /*!
+     * \brief The recording and synchronization objects of a frame in flight.
+     *
+     * \internal
+     */
+    struct Frame {
+        VkCommandBuffer commandBuffer;
+        VkFence fence; //!< Signaled when the GPU has finished the frame.
+        VkSemaphore imageAcquired;
+        VkSemaphore renderFinished;
+        MappedBuffer readbackBuffer; //!< Only for the memory buffer surfaces.
+        uint64_t readbackFrame; //!< The pending readback of the frame, 0 if there is none.
+        bool isRecording;
+    };
+
     GepardContext& _context;
     GepardVulkanInterface _vk;
     VkAllocationCallbacks* _allocator;
@@ -61,10 +153,12 @@ private:
     VkPhysicalDevice _physicalDevice;
     VkDevice _device;
     uint32_t _queueFamilyIndex;
+    VkQueue _queue;
     VkCommandPool _commandPool;
     std::vector<VkCommandBuffer> _primaryCommandBuffers;
     std::vector<VkCommandBuffer> _secondaryCommandBuffers;
-    std::vector<VkDeviceMemory> _memoryAllocations;
+    std::map<uint32_t, MemoryPool> _memoryPools; //!< Keyed by the memory type index.
+    VkDeviceSize _bufferImageGranularity;
     VkRenderPass _renderPass;
     VkFormat _imageFormat;
     VkImage _surfaceImage;
@@ -75,26 +169,63 @@ private:
     VkSurfaceKHR _wsiSurface;
     VkSwapchainKHR _wsiSwapChain;
     std::vector<VkImage> _wsiSwapChainImages;
+    std::vector<VkBuffer> _buffers;
+    std::map<const uint32_t*, VkShaderModule> _shaderModules;
+    VkPipelineCache _pipelineCache;
+    std::string _pipelineCacheFile;
+    std::map<PipelineType, VkPipeline> _pipelines;
+    VkPipelineLayout _pipelineLayout;
+    std::vector<Frame> _frames;
+    uint32_t _currentFrame;
+    std::deque<uint64_t> _emptyFrames; //!< The flushes without drawings, which wait for the earlier readbacks.
+    MappedBuffer _vertexRing; //!< Each frame in flight owns an equal segment.
+    VkBuffer _rectIndexBuffer;
+    VkBuffer _trapezoidBuffer; //!< Device local, filled from the _vertexRing.
+    VkRenderPass _coverageRenderPass;
+    VkImage _coverageImage; //!< Render target of the path coverage, see fillPath().
+    VkImageView _coverageImageView;
+    VkFramebuffer _coverageFrameBuffer;
+    VkSampler _coverageSampler;
+    VkDescriptorSetLayout _descriptorSetLayout;
+    VkDescriptorPool _descriptorPool;
+    VkDescriptorSet _coverageDescriptorSet;
 
     void createDefaultInstance();
     void chooseDefaultPhysicalDevice();
     void chooseDefaultDevice();
     bool chooseGraphicsQueue(const std::vector<VkPhysicalDevice> &devices);
     void createCommandPool();
-    void allocatePrimaryCommandBuffer();
+    void allocatePrimaryCommandBuffers();
+    void createFrames();
+    void beginFrame();
+    void submitFrame(const bool present);
+    void beginSurfaceRenderPass(const VkCommandBuffer commandBuffer);
     void createDefaultRenderPass();
     void createSurfaceImage();
     void createDefaultFrameBuffer();
+    void createCoverageTarget();
+    void createCoverageDescriptorSet();
     uint32_t getMemoryTypeIndex(const VkMemoryRequirements memoryRequirements, const VkMemoryPropertyFlags properties);
+    MemoryAllocation allocateMemory(const VkMemoryRequirements memoryRequirements, const VkMemoryPropertyFlags properties, const bool isImage);
+    void freeMemory(const MemoryAllocation& allocation);
+    void createBuffer(VkBuffer& buffer, MemoryAllocation& allocation, const VkDeviceSize size, const VkBufferUsageFlags usage, const VkMemoryPropertyFlags properties);
+    void createDefaultBuffers();
+    VkDeviceSize uploadVertexData(const void* vertexData, const VkDeviceSize size);
+    void drawTrapezoidCoverage(const float* trapezoids, const uint32_t trapezoidCount, const PathPushConstants& pushConstants, const VkClearRect* clearRect);
+    VkShaderModule getShaderModule(const uint32_t* code, const size_t codeSize);
+    void createPipelineCache();
+    void savePipelineCache();
+    VkPipeline getPipeline(const PipelineType type);
+    VkPipeline createPipeline(const PipelineType type);
     void createSwapChain();
-    void presentImage();
-    void readImage();
+    void recordPresentImage(const VkCommandBuffer commandBuffer, const uint32_t imageIndex);
+    void recordReadImage(const VkCommandBuffer commandBuffer, const MappedBuffer& readbackBuffer);
+    void completeReadbacks(const bool wait);
+    void completeEmptyFrames(const uint64_t frame);
 };
 
 } // namespace vulkan
 
-typedef vulkan::GepardVulkan GepardEngineBackend;
-
 } // namespace gepard
 
 #endif // GEPARD_VULKAN_H
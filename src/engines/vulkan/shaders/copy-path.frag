@@ -0,0 +1,16 @@
+# version 450
+
+layout(set = 0, binding = 0) uniform sampler2D coverageTexture;
+
+layout(push_constant) uniform PushConstants {
+    vec2 size;
+    vec4 color;
+} pushConstants;
+
+layout(location = 0) out vec4 fragColor;
+
+void main()
+{
+    float coverage = texelFetch(coverageTexture, ivec2(gl_FragCoord.xy), 0).r;
+    fragColor = vec4(pushConstants.color.rgb, pushConstants.color.a * coverage);
+}
@@ -0,0 +1,13 @@
+# version 450
+
+layout(push_constant) uniform PushConstants {
+    vec2 size;
+    vec4 color;
+} pushConstants;
+
+layout(location = 0) in vec2 position;
+
+void main()
+{
+    gl_Position = vec4((2.0 * position / pushConstants.size) - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,50 @@
+# version 450
+
+layout(constant_id = 0) const int antiAliasLevel = 16;
+
+layout(location = 0) in vec4 y1y2;
+layout(location = 1) in vec4 x1x2;
+layout(location = 2) in vec2 dx1dx2;
+
+layout(location = 0) out vec4 coverage;
+
+void main()
+{
+    const float step = 1.0 / float(antiAliasLevel);
+    const float rounding = 0.5 / float(antiAliasLevel);
+
+    float y = floor(y1y2[0]);
+    float from = max(-y + y1y2[2], 0.0);
+    float to = min(y1y2[1] - y + y1y2[3], 1.0) - from;
+
+    vec2 xs = (y + from) * (dx1dx2 * float(antiAliasLevel));
+
+    float x = floor(x1x2[0]);
+    xs[0] = (-x) + (xs[0] + x1x2[2]);
+    xs[1] = (x1x2[1] - x) + (xs[1] + x1x2[3]);
+
+    // Alpha value to must be > 0.
+    float alpha = 1.0;
+
+    float sum = (clamp(xs[1], 0.0, 1.0) - clamp(xs[0], 0.0, 1.0));
+    if (to > 1.0 - rounding) {
+        vec2 last = xs + dx1dx2 * (float(antiAliasLevel) - 1.0);
+        sum += (clamp(last[1], 0.0, 1.0) - clamp(last[0], 0.0, 1.0));
+        to -= step;
+    }
+
+    if (sum <= 2.0 - rounding) {
+        xs += dx1dx2;
+
+        while (to >= rounding) {
+            sum += (clamp(xs[1], 0.0, 1.0) - clamp(xs[0], 0.0, 1.0));
+            xs += dx1dx2;
+            to -= step;
+        }
+
+        alpha = sum * step;
+    }
+
+    // The coverage is accumulated by additive blending.
+    coverage = vec4(alpha);
+}
@@ -0,0 +1,89 @@
+# version 450
+
+// The trapezoids are drawn instanced, one triangle strip for each trapezoid.
+// The data is the same as the attributes of the GLES2 fill path shader.
+
+layout(constant_id = 0) const int antiAliasLevel = 16;
+
+layout(push_constant) uniform PushConstants {
+    vec2 size;
+    vec4 color;
+} pushConstants;
+
+layout(location = 0) in vec4 trapezoidXs;
+layout(location = 1) in vec2 trapezoidYs;
+
+layout(location = 0) out vec4 y1y2;
+layout(location = 1) out vec4 x1x2;
+layout(location = 2) out vec2 dx1dx2;
+
+void main()
+{
+    float topLeftX = trapezoidXs[0];
+    float topRightX = trapezoidXs[1];
+    float bottomLeftX = trapezoidXs[2];
+    float bottomRightX = trapezoidXs[3];
+    float topY = trapezoidYs[0];
+    float bottomY = trapezoidYs[1];
+
+    // Strip order: bottom left, top left, bottom right, top right.
+    bool isLeft = gl_VertexIndex < 2;
+    bool isBottom = (gl_VertexIndex & 1) == 0;
+
+    float height = topY - bottomY;
+    float dx1 = (topLeftX - bottomLeftX) / height;
+    float dx2 = (topRightX - bottomRightX) / height;
+
+    float distance = fract(bottomY);
+    float x1 = bottomLeftX - distance * dx1;
+    float x2 = bottomRightX - distance * dx2;
+
+    vec2 position = vec2(0.0, 0.0);
+    float floorBottomY = floor(bottomY);
+    const float minHeight = 3.0;
+
+    if (isBottom) {
+        if (isLeft) {
+            if (height <= minHeight || abs(bottomLeftX - topLeftX) >= (abs(dx1) * 2.0))
+                position.x = floor(min(bottomLeftX, topLeftX));
+            else
+                position.x = floor(x1 - abs(dx1));
+        } else {
+            if (height <= minHeight || abs(bottomRightX - topRightX) >= (abs(dx2) * 2.0))
+                position.x = ceil(max(bottomRightX, topRightX));
+            else
+                position.x = ceil(x2 + abs(dx2));
+        }
+        position.y = floorBottomY;
+        y1y2[0] = 0.0;
+    } else {
+        distance = 1.0 - fract(topY);
+        if (isLeft) {
+            if (height <= minHeight || abs(bottomLeftX - topLeftX) >= (abs(dx1) * 2.0))
+                position.x = floor(min(bottomLeftX, topLeftX));
+            else
+                position.x = floor((topLeftX - distance * dx1) - abs(dx1));
+        } else {
+            if (height <= minHeight || abs(bottomRightX - topRightX) >= (abs(dx2) * 2.0))
+                position.x = ceil(max(bottomRightX, topRightX));
+            else
+                position.x = ceil((topRightX - distance * dx2) + abs(dx2));
+        }
+        position.y = ceil(topY);
+        y1y2[0] = position.y - floorBottomY;
+    }
+
+    y1y2[1] = floor(topY) - floorBottomY;
+    y1y2[2] = fract(bottomY);
+    y1y2[3] = fract(topY);
+
+    float floorX1 = floor(x1);
+    x1x2[0] = position.x - floorX1;
+    x1x2[1] = floor(x2) - floorX1;
+    x1x2[2] = fract(x1);
+    x1x2[3] = fract(x2);
+
+    dx1dx2[0] = dx1 * (1.0 / float(antiAliasLevel));
+    dx1dx2[1] = dx2 * (1.0 / float(antiAliasLevel));
+    gl_Position = vec4((2.0 * position.xy / pushConstants.size) - 1.0, 0.0, 1.0);
+}
@@ -29,6 +29,8 @@
 #include "gepard-float-point.h"
 #include "gepard-float.h"
 #include "gepard-transform.h"
+#include "gepard-trapezoid-tessellator.h"
+#include <memory>
 
 namespace gepard {
 
@@ -64,7 +66,7 @@ void GepardEngine::restore()
  */
 void GepardEngine::closePath()
 {
-    _context.path.pathData()->addCloseSubpathElement();
+    pathData()->addCloseSubpathElement();
 }
 
 /*!
@@ -77,7 +79,7 @@ void GepardEngine::closePath()
  */
 void GepardEngine::moveTo(Float x, Float y)
 {
-    _context.path.pathData()->addMoveToElement(FloatPoint(x, y));
+    pathData()->addMoveToElement(FloatPoint(x, y));
 }
 
 /*!
@@ -90,7 +92,7 @@ void GepardEngine::moveTo(Float x, Float y)
  */
 void GepardEngine::lineTo(Float x, Float y)
 {
-    _context.path.pathData()->addLineToElement(FloatPoint(x, y));
+    pathData()->addLineToElement(FloatPoint(x, y));
 }
 
 /*!
@@ -105,7 +107,7 @@ void GepardEngine::lineTo(Float x, Float y)
  */
 void GepardEngine::quadraticCurveTo(Float cpx, Float cpy, Float x, Float y)
 {
-    _context.path.pathData()->addQuadaraticCurveToElement(FloatPoint(cpx, cpy), FloatPoint(x, y));
+    pathData()->addQuadaraticCurveToElement(FloatPoint(cpx, cpy), FloatPoint(x, y));
 }
 
 /*!
@@ -122,7 +124,7 @@ void GepardEngine::quadraticCurveTo(Float cpx, Float cpy, Float x, Float y)
  */
 void GepardEngine::bezierCurveTo(Float cp1x, Float cp1y, Float cp2x, Float cp2y, Float x, Float y)
 {
-    _context.path.pathData()->addBezierCurveToElement(FloatPoint(cp1x, cp1y), FloatPoint(cp2x, cp2y), FloatPoint(x, y));
+    pathData()->addBezierCurveToElement(FloatPoint(cp1x, cp1y), FloatPoint(cp2x, cp2y), FloatPoint(x, y));
 }
 
 /*!
@@ -138,7 +140,7 @@ void GepardEngine::bezierCurveTo(Float cp1x, Float cp1y, Float cp2x, Float cp2y,
  */
 void GepardEngine::arcTo(Float x1, Float y1, Float x2, Float y2, Float radius)
 {
-    _context.path.pathData()->addArcToElement(FloatPoint(x1, y1), FloatPoint(x2, y2), radius);
+    pathData()->addArcToElement(FloatPoint(x1, y1), FloatPoint(x2, y2), radius);
 }
 
 /*!
@@ -174,38 +176,32 @@ void GepardEngine::rect(Float x, Float y, Float w, Float h)
  */
 void GepardEngine::arc(Float x, Float y, Float radius, Float startAngle, Float endAngle, bool counterclockwise)
 {
-    _context.path.pathData()->addArcElement(FloatPoint(x, y), FloatPoint(radius, radius), startAngle, endAngle, counterclockwise);
+    pathData()->addArcElement(FloatPoint(x, y), FloatPoint(radius, radius), startAngle, endAngle, counterclockwise);
 }
 
 void GepardEngine::scale(Float x, Float y)
 {
     state().transform.scale(x, y);
-    _context.path.pathData()->applyTransform(Transform(1, 0, 0, 1, 0, 0).scale(x, y).inverse());
 }
 
 void GepardEngine::rotate(Float angle)
 {
     state().transform.rotate(angle);
-    _context.path.pathData()->applyTransform(Transform(1, 0, 0, 1, 0, 0).rotate(angle).inverse());
 }
 
 void GepardEngine::translate(Float x, Float y)
 {
     state().transform.translate(x, y);
-    _context.path.pathData()->applyTransform(Transform(1, 0, 0, 1, 0, 0).translate(x, y).inverse());
 }
 
 void GepardEngine::transform(Float a, Float b, Float c, Float d, Float e, Float f)
 {
-    Transform t = Transform(a, b, c, d, e, f);
-    state().transform.multiply(t);
-    _context.path.pathData()->applyTransform(t.inverse());
+    state().transform.multiply(Transform(a, b, c, d, e, f));
 }
 
 void GepardEngine::setTransform(Float a, Float b, Float c, Float d, Float e, Float f)
 {
     state().transform = Transform(a, b, c, d, e, f);
-    _context.path.pathData()->applyTransform(state().transform.inverse());
 }
 
 /*!
@@ -225,18 +221,22 @@ void GepardEngine::beginPath()
 
 /*!
  * \brief GepardEngine::fill
+ * \param fillRule  "nonzero" or "evenodd", other values fall back to "nonzero"
  *
  * \internal
  * \todo unit tests missing
  */
-void GepardEngine::fill()
+void GepardEngine::fill(const std::string& fillRule)
 {
-    GD_ASSERT(_engineBackend);
-#ifdef GD_USE_GLES2
-    _engineBackend->fillPath(context().path.pathData(), state());
-#else // !GD_USE_GLES2
-    _engineBackend->fill();
-#endif // GD_USE_GLES2
+    std::shared_ptr<PathData> pathData = _context.path.snapshot();
+    if (pathData->isEmpty()) {
+        return;
+    }
+
+    DrawCommand command(DrawCommand::FillPath, state());
+    command.pathData = pathData;
+    command.fillRule = (fillRule == "evenodd") ? TrapezoidTessellator::EvenOdd : TrapezoidTessellator::NonZero;
+    recordCommand(command);
 }
 
 /*!
@@ -247,12 +247,14 @@ void GepardEngine::fill()
  */
 void GepardEngine::stroke()
 {
-    GD_ASSERT(_engineBackend);
-#ifdef GD_USE_GLES2
-    _engineBackend->strokePath();
-#else // !GD_USE_GLES2
-    _engineBackend->stroke();
-#endif // GD_USE_GLES2
+    std::shared_ptr<PathData> pathData = _context.path.snapshot();
+    if (pathData->isEmpty()) {
+        return;
+    }
+
+    DrawCommand command(DrawCommand::StrokePath, state());
+    command.pathData = pathData;
+    recordCommand(command);
 }
 
 /*!
@@ -299,13 +301,88 @@ bool GepardEngine::isPointInPath(Float x, Float y)
  * \todo documentation is missing
  */
 void GepardEngine::fillRect(Float x, Float y, Float w, Float h)
+{
+    DrawCommand command(DrawCommand::FillRect, state());
+    command.x = x;
+    command.y = y;
+    command.w = w;
+    command.h = h;
+    recordCommand(command);
+}
+
+/*!
+ * \brief GepardEngine::draw
+ * \return  the number of the primitives which were executed by this call
+ *
+ * Execute the recorded drawing commands and present the drawings since
+ * the last draw on the surface.
+ */
+const unsigned GepardEngine::draw()
+{
+    GD_ASSERT(_engineBackend);
+    const unsigned count = executeCommands();
+    _context.frameCount++;
+    _engineBackend->flush();
+    return count;
+}
+
+/*!
+ * \brief GepardEngine::finish
+ *
+ * Draw the recorded commands and wait until the surface has received every
+ * flushed frame.
+ */
+void GepardEngine::finish()
+{
+    draw();
+    _engineBackend->finish();
+}
+
+/*!
+ * \brief GepardEngine::recordCommand
+ *
+ * The command list is executed, but not presented, if it is full.
+ *
+ * \internal
+ */
+void GepardEngine::recordCommand(const DrawCommand& command)
+{
+    _context.commands.push_back(command);
+
+    if (_context.commands.size() >= GepardContext::kMaximumNumberOfCommands) {
+        GD_LOG2("The command list is full.");
+        executeCommands();
+    }
+}
+
+/*!
+ * \brief GepardEngine::executeCommands
+ * \return  the number of the executed commands
+ *
+ * \internal
+ */
+const unsigned GepardEngine::executeCommands()
 {
     GD_ASSERT(_engineBackend);
-#ifdef GD_USE_GLES2
-    _engineBackend->fillRect(x, y, w, h, state().fillColor);
-#else // !GD_USE_GLES2
-    _engineBackend->fillRect(x, y, w, h);
-#endif // GD_USE_GLES2
+    GD_LOG1("Execute " << _context.commands.size() << " commands.");
+
+    for (const DrawCommand& command : _context.commands) {
+        switch (command.type) {
+        case DrawCommand::FillRect:
+            _engineBackend->fillRect(command.x, command.y, command.w, command.h, command.state.fillColor);
+            break;
+        case DrawCommand::FillPath:
+            _engineBackend->fillPath(command.pathData.get(), command.state, command.fillRule);
+            break;
+        case DrawCommand::StrokePath:
+            _engineBackend->strokePath(command.pathData.get(), command.state);
+            break;
+        }
+    }
+
+    const unsigned count = _context.commands.size();
+    _context.commands.clear();
+    return count;
 }
 
 void GepardEngine::setFillColor(const Color& color)
@@ -330,6 +407,22 @@ GepardState&GepardEngine::state()
     return _context.currentState();
 }
 
+/*!
+ * \brief GepardEngine::pathData
+ * \return  the current path data, which adds the elements with the current transform
+ *
+ * The transformation calls only change the state, the path data is updated
+ * lazily here.
+ *
+ * \internal
+ */
+PathData* GepardEngine::pathData()
+{
+    PathData* pathData = _context.path.pathData();
+    pathData->setTransform(state().transform);
+    return pathData;
+}
+
 void GepardEngine::setFillStyle(const std::string& color)
 {
     state().fillColor = Color(color);
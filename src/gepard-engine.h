@@ -30,22 +30,13 @@
 
 #include "gepard-color.h"
 #include "gepard-context.h"
+#include "gepard-engine-backend.h"
 #include "gepard-float.h"
 #include "gepard-float-point.h"
 #include "gepard-image.h"
 #include "gepard-state.h"
-
-
-// Include engine backend.
-#if defined(GD_USE_GLES2)
-#include "gepard-gles2.h"
-#elif defined(GD_USE_SOFTWARE)
-#include "gepard-software.h"
-#elif defined(GD_USE_VULKAN)
-#include "gepard-vulkan.h"
-#else
-#error "No engine backend defined!"
-#endif // Include engine backend.
+#include "gepard.h"
+#include <string>
 
 namespace gepard {
 
@@ -54,14 +45,19 @@ class Surface;
 
 class GepardEngine {
 public:
-    explicit GepardEngine(Surface* surface)
-        : _context(surface)
-        , _engineBackend(new GepardEngineBackend(_context))
+    explicit GepardEngine(Surface* surface, const unsigned threadCount = 1, const Gepard::Backend backend = Gepard::AutoBackend)
+        : _context(surface, threadCount)
+        , _engineBackend(GepardEngineBackend::create(_context, backend))
     {
     }
     ~GepardEngine()
     {
         if (_engineBackend) {
+            // Don't lose the drawings which were recorded after the last draw().
+            if (!_context.commands.empty()) {
+                GD_LOG1("Draw the " << _context.commands.size() << " pending commands before the destruction.");
+                draw();
+            }
             delete _engineBackend;
         }
     }
@@ -89,7 +85,7 @@ public:
 
     /* 11. Drawing paths to the canvas */
     void beginPath();
-    void fill();
+    void fill(const std::string& fillRule = "nonzero");
     void stroke();
     void drawFocusIfNeeded(/*Element element*/);
     void clip();
@@ -97,6 +93,9 @@ public:
 
     void fillRect(Float x, Float y, Float w, Float h);
 
+    const unsigned draw();
+    void finish();
+
     void setFillColor(const Color& color);
     void setFillColor(const Float red, const Float green, const Float blue, const Float alpha = 1.0f);
 
@@ -110,9 +109,14 @@ public:
     void setMiterLimit(const std::string&);
 
     GepardContext& context() { return _context; }
+    const Gepard::Backend backend() const { return _engineBackend->type(); }
 
 private:
     GepardState& state();
+    PathData* pathData();
+
+    void recordCommand(const DrawCommand&);
+    const unsigned executeCommands();
 
     GepardContext _context;
     GepardEngineBackend* _engineBackend;
@@ -98,8 +98,8 @@ void Gepard::Attribute::setCallBack(GepardEngine* eng, void(*func)(GepardEngine*
     callBackFunction = func;
 }
 
-Gepard::Gepard(Surface* surface)
-    : _engine(new GepardEngine(surface))
+Gepard::Gepard(Surface* surface, const unsigned threadCount, const Backend backend)
+    : _engine(new GepardEngine(surface, threadCount, backend))
 {
     fillStyle.setCallBack(_engine, [](GepardEngine* engine, const std::string& color){ engine->setFillStyle(color); });
     strokeStyle.setCallBack(_engine, [](GepardEngine* engine, const std::string& color){ engine->setStrokeStyle(color); });
@@ -116,6 +116,11 @@ Gepard::~Gepard()
     }
 }
 
+const Gepard::Backend Gepard::backend() const
+{
+    return _engine->backend();
+}
+
 /*! \todo missing docs */
 void Gepard::save()
 {
@@ -418,6 +423,7 @@ void Gepard::beginPath()
 
 /*!
  * \brief Gepard::fill
+ * \param fillRule  "nonzero" or "evenodd", see the description
  *
  *   <blockquote cite="https://www.w3.org/TR/2dcontext/">
  *
@@ -436,12 +442,18 @@ void Gepard::beginPath()
  * -- <a href="https://www.w3.org/TR/2dcontext/#dom-context-2d-fill">[W3C-2DContext]</a>
  *   </blockquote>
  *
- * \todo unimplemented function
+ *   <blockquote cite="https://html.spec.whatwg.org/multipage/canvas.html">
+ *
+ * The fillRule argument indicates the algorithm to use to determine if a
+ * point is inside or outside the path: "nonzero" (the default) or "evenodd".
+ *
+ * -- <a href="https://html.spec.whatwg.org/multipage/canvas.html#dom-context-2d-fill">[HTML-Canvas]</a>
+ *   </blockquote>
  */
-void Gepard::fill()
+void Gepard::fill(const std::string& fillRule)
 {
     GD_ASSERT(_engine);
-    _engine->fill();
+    _engine->fill(fillRule);
 }
 
 /*!
@@ -649,6 +661,23 @@ void Gepard::setStrokeColor(const int red, const int green, const int blue, cons
     _engine->setStrokeColor(Color(ratio * float(red), ratio * float(green), ratio * float(blue), float(alpha)));
 }
 
+const unsigned Gepard::draw()
+{
+    GD_ASSERT(_engine);
+    return _engine->draw();
+}
+
+void Gepard::flush()
+{
+    draw();
+}
+
+void Gepard::finish()
+{
+    GD_ASSERT(_engine);
+    _engine->finish();
+}
+
 // Virtual destructor definition for the abstract Surface class.
 Surface::~Surface()
 {
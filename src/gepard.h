@@ -27,7 +27,9 @@
 #ifndef GEPARD_H
 #define GEPARD_H
 
+#include <stdint.h>
 #include <string>
+#include <vector>
 
 namespace gepard {
 
@@ -62,9 +64,40 @@ class Gepard {
     };
 
 public:
-    explicit Gepard(Surface* surface);
+    /*!
+     * \brief The rendering backends
+     *
+     * Every backend whose dependencies were found at build time is part of
+     * the library.
+     */
+    enum Backend {
+        AutoBackend, //!< The first available one of GLES2, Vulkan and software.
+        GLES2Backend,
+        VulkanBackend,
+        SoftwareBackend,
+    };
+
+    /*!
+     * \brief Creates a drawing context which draws onto the _surface_.
+     * \param surface  the target surface
+     * \param threadCount  number of the rendering threads, 0 means one thread
+     * per CPU core. Only the software backend uses more than one thread.
+     * \param backend  the rendering backend. AutoBackend can be overridden by
+     * the GD_BACKEND environment variable ("gles2", "vulkan" or "software"),
+     * which falls back to the automatic choice if it is not available.  It is
+     * a fatal error if an explicitly requested backend is not available.
+     */
+    explicit Gepard(Surface* surface, const unsigned threadCount = 1, const Backend backend = AutoBackend);
+    /*!
+     * \brief Draw the pending recorded drawings, see draw(), and destroy the context
+     */
     ~Gepard();
 
+    /*!
+     * \brief The backend which was chosen at construction
+     */
+    const Backend backend() const;
+
     /*! \name 2. CanvasAPI State
      *
      * \cond
@@ -364,8 +397,11 @@ public:
      * \brief Fills the subpaths of the current path or the given path with the
      * current fill style.
      * -- <a href="https://www.w3.org/TR/2dcontext/#dom-context-2d-fill">[W3C-2DContext]</a>
+     *
+     * The _fillRule_ is "nonzero" or "evenodd".
+     * -- <a href="https://html.spec.whatwg.org/multipage/canvas.html#dom-context-2d-fill">[HTML-Canvas]</a>
      */
-    void fill();
+    void fill(const std::string& fillRule = "nonzero");
     /*!
      * \brief Strokes the subpaths of the current path or the given path with
      * the current stroke style.
@@ -450,6 +486,31 @@ public:
      */
     void setStrokeColor(const int red, const int green, const int blue, const float alpha = 1.0f);
 
+    /*!
+     * \brief Execute the recorded drawings and present them on the surface
+     * \return  the number of the primitives executed by this call
+     *
+     * The drawing functions only record the operations with a snapshot of
+     * the current state.  The recorded list is executed when draw() or
+     * flush() is called, or when the list is full; the surface receives
+     * the changed areas only on draw() and flush().
+     */
+    const unsigned draw();
+    /*!
+     * \brief Same as draw(), but drops the number of the primitives
+     */
+    void flush();
+    /*!
+     * \brief Same as flush(), but returns only when the surface has received
+     * every flushed frame
+     *
+     * The offscreen surfaces of the Vulkan backend receive the pixels of a
+     * frame asynchronously, while the next frame renders, see
+     * Surface::frameReady().  The other backends update the surface in
+     * flush() already.
+     */
+    void finish();
+
     /// \} A. NonCanvasAPI Functions
 
 private:
@@ -463,6 +524,13 @@ private:
  */
 class Surface {
 public:
+    /*!
+     * \brief A damaged area of the surface in pixels
+     */
+    struct Rect {
+        uint32_t x, y, width, height;
+    };
+
     Surface(uint32_t width = 0, uint32_t height = 0)
         : _width(width)
         , _height(height)
@@ -474,6 +542,22 @@ public:
     virtual unsigned long getWindow() = 0;
     virtual void* getBuffer() = 0;
     virtual void drawBuffer(void*) = 0;
+    /*!
+     * \brief Receives the damaged areas of the whole frame buffer
+     * \param buffer  the whole frame buffer in RGBA format
+     * \param rects  the changed areas since the last flush
+     *
+     * The default implementation redraws the whole buffer with drawBuffer().
+     */
+    virtual void drawBufferRects(void* buffer, const std::vector<Rect>& /*rects*/) { drawBuffer(buffer); }
+    /*!
+     * \brief Called when the surface has received a flushed frame
+     * \param frame  the number of the flush, counted from 1
+     *
+     * The frames arrive in the order of the flushes.  The default
+     * implementation does nothing.
+     */
+    virtual void frameReady(const uint64_t /*frame*/) {}
 
     const uint32_t width() const { return _width; }
     const uint32_t height() const { return _height; }
@@ -30,6 +30,8 @@
 #include "gepard.h"
 
 #include <cstdlib>
+#include <cstring>
+#include <vector>
 
 namespace gepard {
 
@@ -41,7 +43,7 @@ namespace gepard {
 class MemoryBufferSurface : public Surface {
 public:
     MemoryBufferSurface(uint32_t width = 0, uint32_t height = 0)
-        : Surface(width, height, true)
+        : Surface(width, height)
     {
         _buffer = std::malloc(width * height * 4);
     }
@@ -56,6 +58,19 @@ public:
     virtual void* getDisplay() { return nullptr; }
     virtual unsigned long getWindow() { return 0; }
     virtual void* getBuffer() { return _buffer; }
+    virtual void drawBuffer(void* rgba)
+    {
+        std::memcpy(_buffer, rgba, 4 * width() * height());
+    }
+    virtual void drawBufferRects(void* rgba, const std::vector<Rect>& rects)
+    {
+        for (const Rect& rect : rects) {
+            for (uint32_t j = rect.y; j < rect.y + rect.height; ++j) {
+                const uint32_t offset = j * width() + rect.x;
+                std::memcpy((uint32_t*)_buffer + offset, (uint32_t*)rgba + offset, 4 * rect.width);
+            }
+        }
+    }
 
 private:
     void* _buffer;
@@ -32,6 +32,7 @@
 #include <cstring>
 #include <png.h>
 #include <string>
+#include <vector>
 
 namespace gepard {
 
@@ -63,6 +64,15 @@ public:
     {
         std::memcpy(_buffer, rgba, 4 * width() * height());
     }
+    virtual void drawBufferRects(void* rgba, const std::vector<Rect>& rects)
+    {
+        for (const Rect& rect : rects) {
+            for (uint32_t j = rect.y; j < rect.y + rect.height; ++j) {
+                const uint32_t offset = j * width() + rect.x;
+                std::memcpy((uint32_t*)_buffer + offset, (uint32_t*)rgba + offset, 4 * rect.width);
+            }
+        }
+    }
 
     /*!
      * \todo doc is missing
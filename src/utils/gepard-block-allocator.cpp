@@ -0,0 +1,150 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gepard-block-allocator.h"
+
+#include "gepard-defs.h"
+#include <algorithm>
+#include <iterator>
+
+namespace gepard {
+
+static inline const uint64_t alignUp(const uint64_t value, const uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+BlockAllocator::BlockAllocator(const uint64_t blockSize)
+    : _blockSize(blockSize)
+    , _allocationCount(0)
+{
+    GD_ASSERT(blockSize);
+}
+
+/*!
+ * \brief Allocate an aligned range.
+ *
+ * If the range does not fit into the existing blocks, a new block is added,
+ * which is the last one.
+ */
+const BlockAllocator::Allocation BlockAllocator::allocate(const uint64_t size, const uint64_t alignment)
+{
+    GD_ASSERT(size && alignment);
+
+    Allocation allocation;
+    for (size_t block = 0; block < _blocks.size(); ++block) {
+        if (allocateFromBlock(block, size, alignment, &allocation))
+            return allocation;
+    }
+
+    // Every block starts at an offset which satisfies any alignment.
+    Block block;
+    block.size = std::max(_blockSize, size);
+    block.usedBytes = 0;
+    block.freeRanges[0] = block.size;
+    _blocks.push_back(block);
+
+    if (!allocateFromBlock(_blocks.size() - 1, size, alignment, &allocation)) {
+        GD_CRASH("The new block is too small!");
+    }
+    return allocation;
+}
+
+bool BlockAllocator::allocateFromBlock(const size_t index, const uint64_t size, const uint64_t alignment, Allocation* allocation)
+{
+    Block& block = _blocks[index];
+    if (block.size - block.usedBytes < size)
+        return false;
+
+    for (auto it = block.freeRanges.begin(); it != block.freeRanges.end(); ++it) {
+        const uint64_t rangeOffset = it->first;
+        const uint64_t rangeEnd = it->first + it->second;
+        const uint64_t offset = alignUp(rangeOffset, alignment);
+        if (offset + size > rangeEnd)
+            continue;
+
+        // The padding before and the rest after the allocation stay free.
+        block.freeRanges.erase(it);
+        if (offset > rangeOffset)
+            block.freeRanges[rangeOffset] = offset - rangeOffset;
+        if (offset + size < rangeEnd)
+            block.freeRanges[offset + size] = rangeEnd - (offset + size);
+
+        block.usedBytes += size;
+        _allocationCount++;
+        *allocation = { index, offset, size };
+        return true;
+    }
+
+    return false;
+}
+
+void BlockAllocator::free(const Allocation& allocation)
+{
+    GD_ASSERT(allocation.block < _blocks.size());
+    Block& block = _blocks[allocation.block];
+
+    uint64_t offset = allocation.offset;
+    uint64_t size = allocation.size;
+
+    auto next = block.freeRanges.lower_bound(offset);
+    GD_ASSERT(next == block.freeRanges.end() || next->first >= offset + size);
+    if (next != block.freeRanges.end() && next->first == offset + size) {
+        size += next->second;
+        next = block.freeRanges.erase(next);
+    }
+
+    if (next != block.freeRanges.begin()) {
+        auto previous = std::prev(next);
+        GD_ASSERT(previous->first + previous->second <= offset);
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            block.freeRanges.erase(previous);
+        }
+    }
+
+    block.freeRanges[offset] = size;
+    block.usedBytes -= allocation.size;
+    _allocationCount--;
+}
+
+const BlockAllocator::Statistics BlockAllocator::statistics() const
+{
+    Statistics statistics = { 0, 0, 0, _blocks.size(), _allocationCount };
+    for (const Block& block : _blocks) {
+        uint64_t largestFreeRange = 0;
+        for (const auto& range : block.freeRanges) {
+            largestFreeRange = std::max(largestFreeRange, range.second);
+        }
+
+        statistics.reservedBytes += block.size;
+        statistics.usedBytes += block.usedBytes;
+        statistics.fragmentedBytes += block.size - block.usedBytes - largestFreeRange;
+    }
+    return statistics;
+}
+
+} // namespace gepard
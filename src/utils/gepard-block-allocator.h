@@ -0,0 +1,96 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GEPARD_BLOCK_ALLOCATOR_H
+#define GEPARD_BLOCK_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace gepard {
+
+/*!
+ * \brief The BlockAllocator class
+ *
+ * Carves aligned ranges out of large blocks.  It only does the bookkeeping:
+ * the owner creates the backing storage (e.g. a VkDeviceMemory) whenever
+ * allocate() returns a range in a new block, see blockCount() and
+ * blockSize().  Every block keeps its free ranges ordered by offset, the
+ * first fitting range is used and the freed ranges are merged with their
+ * neighbours.  A request larger than the default block size gets a
+ * dedicated block.  The blocks are kept until the allocator is destroyed.
+ *
+ * \internal
+ */
+class BlockAllocator {
+public:
+    struct Allocation {
+        size_t block;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    /*!
+     * \brief Usage of the blocks in bytes.
+     *
+     * The fragmented bytes are the free bytes which are not in the largest
+     * free range of their block.
+     */
+    struct Statistics {
+        uint64_t reservedBytes;
+        uint64_t usedBytes;
+        uint64_t fragmentedBytes;
+        size_t blockCount;
+        size_t allocationCount;
+    };
+
+    explicit BlockAllocator(const uint64_t blockSize);
+
+    const Allocation allocate(const uint64_t size, const uint64_t alignment);
+    void free(const Allocation& allocation);
+
+    const size_t blockCount() const { return _blocks.size(); }
+    const uint64_t blockSize(const size_t block) const { return _blocks[block].size; }
+    const Statistics statistics() const;
+
+private:
+    struct Block {
+        uint64_t size;
+        uint64_t usedBytes;
+        std::map<uint64_t, uint64_t> freeRanges; //!< Offset to size.
+    };
+
+    bool allocateFromBlock(const size_t block, const uint64_t size, const uint64_t alignment, Allocation* allocation);
+
+    const uint64_t _blockSize;
+    std::vector<Block> _blocks;
+    size_t _allocationCount;
+};
+
+} // namespace gepard
+
+#endif // GEPARD_BLOCK_ALLOCATOR_H
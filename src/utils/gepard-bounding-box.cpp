@@ -64,4 +64,31 @@ void BoundingBox::stretch(const FloatPoint& p)
     stretchY(p.y);
 }
 
+void BoundingBox::stretch(const BoundingBox& bb)
+{
+    if (bb.isEmpty()) {
+        return;
+    }
+    stretchX(bb.minX);
+    stretchX(bb.maxX);
+    stretchY(bb.minY);
+    stretchY(bb.maxY);
+}
+
+const bool BoundingBox::isEmpty() const
+{
+    return !(minX < maxX) || !(minY < maxY);
+}
+
+/*!
+ * \brief Returns true if the boxes overlap or touch each other.
+ */
+const bool BoundingBox::intersects(const BoundingBox& bb) const
+{
+    if (isEmpty() || bb.isEmpty()) {
+        return false;
+    }
+    return minX <= bb.maxX && bb.minX <= maxX && minY <= bb.maxY && bb.minY <= maxY;
+}
+
 } // namespace gepard
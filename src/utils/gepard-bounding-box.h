@@ -47,6 +47,10 @@ struct BoundingBox {
     void stretchX(const Float x);
     void stretchY(const Float y);
     void stretch(const FloatPoint& p);
+    void stretch(const BoundingBox& bb);
+
+    const bool isEmpty() const;
+    const bool intersects(const BoundingBox& bb) const;
 
     Float minX, minY, maxX, maxY;
 };
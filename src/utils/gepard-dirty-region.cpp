@@ -0,0 +1,71 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gepard-dirty-region.h"
+
+#include "gepard-bounding-box.h"
+
+namespace gepard {
+
+void DirtyRegion::add(const BoundingBox& bb)
+{
+    if (bb.isEmpty()) {
+        return;
+    }
+
+    BoundingBox box = bb;
+    // Merging may grow the box over further ones, so repeat until it is
+    // disjoint from every stored box.
+    size_t i = 0;
+    while (i < _boxes.size()) {
+        if (box.intersects(_boxes[i])) {
+            box.stretch(_boxes[i]);
+            _boxes[i] = _boxes.back();
+            _boxes.pop_back();
+            i = 0;
+        } else {
+            i++;
+        }
+    }
+
+    _boxes.push_back(box);
+
+    if (_boxes.size() > kMaximumNumberOfBoxes) {
+        const BoundingBox all = bounds();
+        _boxes.clear();
+        _boxes.push_back(all);
+    }
+}
+
+const BoundingBox DirtyRegion::bounds() const
+{
+    BoundingBox all;
+    for (const BoundingBox& box : _boxes) {
+        all.stretch(box);
+    }
+    return all;
+}
+
+} // namespace gepard
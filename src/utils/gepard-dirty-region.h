@@ -0,0 +1,62 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GEPARD_DIRTY_REGION_H
+#define GEPARD_DIRTY_REGION_H
+
+#include "gepard-bounding-box.h"
+#include <vector>
+
+namespace gepard {
+
+/*!
+ * \brief The DirtyRegion class
+ *
+ * Collects the areas of a surface which were modified since the last
+ * presentation.  The region is stored as a small set of disjoint boxes:
+ * a new box absorbs every box which it touches or overlaps.  If the
+ * number of boxes exceeds kMaximumNumberOfBoxes, the region collapses
+ * into its bounding box.
+ *
+ * \internal
+ */
+class DirtyRegion {
+public:
+    static const size_t kMaximumNumberOfBoxes = 16;
+
+    void add(const BoundingBox& bb);
+    void clear() { _boxes.clear(); }
+
+    const bool isEmpty() const { return _boxes.empty(); }
+    const std::vector<BoundingBox>& boxes() const { return _boxes; }
+    const BoundingBox bounds() const;
+
+private:
+    std::vector<BoundingBox> _boxes;
+};
+
+} // namespace gepard
+
+#endif // GEPARD_DIRTY_REGION_H
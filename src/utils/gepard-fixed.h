@@ -0,0 +1,76 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GEPARD_FIXED_H
+#define GEPARD_FIXED_H
+
+#include "gepard-float.h"
+#include <cmath>
+#include <ostream>
+#include <stdint.h>
+
+namespace gepard {
+
+/*!
+ * \brief The Fixed struct
+ *
+ * A 24.8 fixed point number.  It is a storage type: it converts to Float
+ * implicitly, so the arithmetic is done in Float, and the results are
+ * rounded to the nearest 1/256 when they are stored.  The values outside
+ * of the [-2^23, 2^23) range are saturated.
+ *
+ * \internal
+ */
+struct Fixed {
+    static const int kFractionBits = 8;
+    static const int32_t kOne = 1 << kFractionBits;
+
+    Fixed() : value(0) {}
+    Fixed(const Float f) : value(fromFloat(f)) {}
+
+    static const int32_t fromFloat(const Float f)
+    {
+        const Float scaled = std::round(f * kOne);
+        if (scaled >= Float(INT32_MAX))
+            return INT32_MAX;
+        // The NaN is saturated as well.
+        if (!(scaled > Float(INT32_MIN)))
+            return INT32_MIN;
+        return static_cast<int32_t>(scaled);
+    }
+
+    operator Float() const { return static_cast<Float>(value) / kOne; }
+
+    int32_t value;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const Fixed& f)
+{
+    return os << static_cast<Float>(f);
+}
+
+} // namespace gepard
+
+#endif // GEPARD_FIXED_H
@@ -32,7 +32,7 @@
 namespace gepard {
 
 typedef double Float;
-const double precisionOfFloat = 0x1L << 50;
+const double precisionOfFloat = 0x1LL << 50;
 
 inline const Float strToFloat(const std::string& str) { return std::stod(str); }
 inline Float fixPrecision(Float f) { return std::floor(f * precisionOfFloat) / precisionOfFloat; }
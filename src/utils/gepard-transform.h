@@ -50,6 +50,17 @@ struct Transform {
 
 Transform operator*(const Transform& lhs , const Transform& rhs);
 
+inline bool operator==(const Transform& lhs, const Transform& rhs)
+{
+    return lhs.data[0] == rhs.data[0] && lhs.data[1] == rhs.data[1] && lhs.data[2] == rhs.data[2]
+        && lhs.data[3] == rhs.data[3] && lhs.data[4] == rhs.data[4] && lhs.data[5] == rhs.data[5];
+}
+
+inline bool operator!=(const Transform& lhs, const Transform& rhs)
+{
+    return !(lhs == rhs);
+}
+
 } // namespace gepard
 
 #endif // GEPARD_TRANSFORM_H
@@ -0,0 +1,78 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GEPARD_BENCHMARK_H
+#define GEPARD_BENCHMARK_H
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace gepard {
+namespace benchmark {
+
+/*!
+ * \brief Run the _function_ _iterations_ times and return the elapsed seconds.
+ */
+template<typename Function>
+double measure(const int iterations, Function function)
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        function();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+inline void printHeader(const std::string& title, const std::string& unit)
+{
+    std::cout << title << std::endl;
+    std::cout << "  " << std::left << std::setw(40) << "case" << std::right << std::setw(16) << unit << std::endl;
+}
+
+/*!
+ * \brief Print the throughput of a case in millions of items per second.
+ */
+inline void printResult(const std::string& name, const double items, const double seconds)
+{
+    std::cout << "  " << std::left << std::setw(40) << name << std::right << std::setw(16)
+              << std::fixed << std::setprecision(2) << (items / seconds / 1000000.0) << std::endl;
+}
+
+/*!
+ * \brief Print the cost of an item of a case in microseconds.
+ */
+inline void printCost(const std::string& name, const double items, const double seconds)
+{
+    std::cout << "  " << std::left << std::setw(40) << name << std::right << std::setw(16)
+              << std::fixed << std::setprecision(2) << (seconds / items * 1000000.0) << std::endl;
+}
+
+} // namespace benchmark
+} // namespace gepard
+
+#endif // GEPARD_BENCHMARK_H
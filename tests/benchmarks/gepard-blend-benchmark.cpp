@@ -0,0 +1,100 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gepard-benchmark.h"
+#include "gepard-color.h"
+#include "gepard-software-blend.h"
+#include <stdint.h>
+#include <vector>
+
+namespace {
+
+using namespace gepard;
+using namespace gepard::software;
+
+const int kWidth = 1024;
+const int kHeight = 256;
+const int kIterations = 20;
+
+/*!
+ * \brief The per-pixel Color blending of the former GepardSoftware::fillRect
+ */
+void fillSpanWithColor(uint32_t* dst, const int count, const Color& fillColor)
+{
+    for (int i = 0; i < count; ++i) {
+        uint32_t& dstRaw = dst[i];
+        Color dst = Color::fromRawDataABGR(dstRaw);
+        Color src = fillColor;
+
+        dst *= (1.0f - src.a);
+        src *= src.a;
+
+        dstRaw = Color::toRawDataABGR(src + dst);
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    const double pixels = double(kWidth) * kHeight * kIterations;
+    const Color color(0.8, 0.4, 0.2, 0.6);
+    const uint32_t premultipliedColor = premultiply(color);
+    std::vector<uint32_t> buffer(kWidth * kHeight, 0xff808080);
+
+    std::vector<uint8_t> mask(kWidth);
+    for (int i = 0; i < kWidth; ++i) {
+        mask[i] = (i * 7) & 0xff;
+    }
+
+    benchmark::printHeader("Span blending of a " + std::to_string(kWidth) + "x" + std::to_string(kHeight) + " buffer", "Mpixels/s");
+
+    double seconds = benchmark::measure(kIterations, [&] {
+        for (int j = 0; j < kHeight; ++j)
+            fillSpanWithColor(buffer.data() + j * kWidth, kWidth, color);
+    });
+    benchmark::printResult("Color (former fillRect)", pixels, seconds);
+
+    for (const SpanBlender* blender : supportedSpanBlenders()) {
+        seconds = benchmark::measure(kIterations, [&] {
+            for (int j = 0; j < kHeight; ++j)
+                blender->fillSpan(buffer.data() + j * kWidth, kWidth, premultipliedColor);
+        });
+        benchmark::printResult(std::string("fillSpan ") + blender->name, pixels, seconds);
+
+        seconds = benchmark::measure(kIterations, [&] {
+            for (int j = 0; j < kHeight; ++j)
+                blender->fillMaskedSpan(buffer.data() + j * kWidth, kWidth, premultipliedColor, mask.data());
+        });
+        benchmark::printResult(std::string("fillMaskedSpan ") + blender->name, pixels, seconds);
+
+        seconds = benchmark::measure(kIterations, [&] {
+            blender->fillOpaqueSpan(buffer.data(), kWidth * kHeight, 0xff336699);
+        });
+        benchmark::printResult(std::string("fillOpaqueSpan ") + blender->name, pixels, seconds);
+    }
+
+    return 0;
+}
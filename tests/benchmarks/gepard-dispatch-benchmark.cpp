@@ -0,0 +1,133 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gepard-benchmark.h"
+#include "gepard-color.h"
+#include "gepard-engine-backend.h"
+#include "gepard-float.h"
+#include <vector>
+
+namespace {
+
+using namespace gepard;
+
+const int kCommands = 1000000;
+const int kIterations = 20;
+
+/*!
+ * \brief The fillRect commands, which are replayed like in
+ * GepardEngine::executeCommands().
+ */
+struct Rect {
+    Float x, y, w, h;
+    Color color;
+};
+
+/*!
+ * \brief A backend with non-virtual functions, like the backends which were
+ * selected by a typedef at build time.
+ *
+ * The functions are not inlined: the real backends are called from
+ * another translation unit.
+ */
+class StaticBackend {
+public:
+    void fillRect(const Float x, const Float y, const Float w, const Float h, const Color& fillColor) __attribute__((noinline));
+
+    Float area = 0;
+};
+
+void StaticBackend::fillRect(const Float x, const Float y, const Float w, const Float h, const Color& fillColor)
+{
+    area += (w - x) * (h - y) * fillColor.a;
+}
+
+/*!
+ * \brief The same backend behind the GepardEngineBackend interface.
+ */
+class VirtualBackend : public GepardEngineBackend {
+public:
+    virtual const Gepard::Backend type() const { return Gepard::SoftwareBackend; }
+
+    virtual void fillRect(const Float x, const Float y, const Float w, const Float h, const Color& fillColor) __attribute__((noinline));
+    virtual void fillPath(PathData*, const GepardState&, const TrapezoidTessellator::FillRule) {}
+    virtual void strokePath(PathData*, const GepardState&) {}
+    virtual void flush() {}
+    virtual void finish() {}
+
+    Float area = 0;
+};
+
+void VirtualBackend::fillRect(const Float x, const Float y, const Float w, const Float h, const Color& fillColor)
+{
+    area += (w - x) * (h - y) * fillColor.a;
+}
+
+/*!
+ * \brief Hide the dynamic type of the backend from the compiler, like
+ * GepardEngineBackend::create() does.
+ */
+GepardEngineBackend* createBackend() __attribute__((noinline));
+
+GepardEngineBackend* createBackend()
+{
+    return new VirtualBackend();
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    std::vector<Rect> commands(kCommands);
+    for (int i = 0; i < kCommands; ++i) {
+        commands[i] = { Float(i % 512), Float(i % 256), Float(i % 512 + 16), Float(i % 256 + 16), Color(0.8, 0.4, 0.2, (i % 256) / 255.0) };
+    }
+
+    const double calls = double(kCommands) * kIterations;
+
+    benchmark::printHeader("Backend dispatch of " + std::to_string(kCommands) + " fillRect commands", "Mcalls/s");
+
+    StaticBackend staticBackend;
+    double seconds = benchmark::measure(kIterations, [&] {
+        for (const Rect& rect : commands)
+            staticBackend.fillRect(rect.x, rect.y, rect.w, rect.h, rect.color);
+    });
+    benchmark::printResult("static (former typedef)", calls, seconds);
+
+    GepardEngineBackend* virtualBackend = createBackend();
+    seconds = benchmark::measure(kIterations, [&] {
+        for (const Rect& rect : commands)
+            virtualBackend->fillRect(rect.x, rect.y, rect.w, rect.h, rect.color);
+    });
+    benchmark::printResult("virtual (GepardEngineBackend)", calls, seconds);
+
+    // Keep the results alive.
+    if (staticBackend.area != static_cast<VirtualBackend*>(virtualBackend)->area) {
+        std::cout << "The backends computed different results!" << std::endl;
+    }
+    delete virtualBackend;
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "gepard-benchmark.h"
+#include "gepard-float-point.h"
+#include "gepard-path.h"
+#include "gepard-region.h"
+#include "gepard-transform.h"
+#include <new>
+
+namespace {
+
+using namespace gepard;
+
+const int kElements = 1000000;
+const int kIterations = 10;
+
+/*!
+ * \brief The former linked path elements, which were allocated in a Region.
+ */
+struct LinkedElement {
+    explicit LinkedElement(const PathElementType type, const FloatPoint& to) : next(nullptr), type(type), to(to) {}
+    virtual ~LinkedElement() {}
+
+    LinkedElement* next;
+    PathElementType type;
+    FloatPoint to;
+};
+
+struct LinkedBezierCurveElement : public LinkedElement {
+    explicit LinkedBezierCurveElement(const FloatPoint& control1, const FloatPoint& control2, const FloatPoint& to)
+        : LinkedElement(PathElementTypes::BezierCurve, to), control1(control1), control2(control2) {}
+
+    FloatPoint control1;
+    FloatPoint control2;
+};
+
+/*!
+ * \brief The former PathData: a singly linked list of the elements.
+ */
+struct LinkedPathData {
+    LinkedPathData() : first(nullptr), last(nullptr) {}
+
+    void append(LinkedElement* element)
+    {
+        if (!first)
+            first = element;
+        else
+            last->next = element;
+        last = element;
+    }
+
+    void addMoveToElement(const FloatPoint& to) { append(new (region.alloc(sizeof(LinkedElement))) LinkedElement(PathElementTypes::MoveTo, to)); }
+    void addLineToElement(const FloatPoint& to)
+    {
+        if (last->to != to)
+            append(new (region.alloc(sizeof(LinkedElement))) LinkedElement(PathElementTypes::LineTo, to));
+    }
+    void addBezierCurveToElement(const FloatPoint& control1, const FloatPoint& control2, const FloatPoint& to)
+    {
+        append(new (region.alloc(sizeof(LinkedBezierCurveElement))) LinkedBezierCurveElement(control1, control2, to));
+    }
+
+    void applyTransform(const Transform& transform)
+    {
+        for (LinkedElement* element = first; element; element = element->next) {
+            element->to = transform.apply(element->to);
+            if (element->type == PathElementTypes::BezierCurve) {
+                LinkedBezierCurveElement* bezier = static_cast<LinkedBezierCurveElement*>(element);
+                bezier->control1 = transform.apply(bezier->control1);
+                bezier->control2 = transform.apply(bezier->control2);
+            }
+        }
+    }
+
+    Region<> region;
+    LinkedElement* first;
+    LinkedElement* last;
+};
+
+/*!
+ * \brief Build a path of lines with every fourth element a bezier curve.
+ */
+template<typename Path>
+void buildPath(Path& path)
+{
+    path.addMoveToElement(FloatPoint(0, 0));
+    for (int i = 1; i < kElements; ++i) {
+        const FloatPoint to(Float(i % 1024), Float(i / 1024));
+        if (i % 4)
+            path.addLineToElement(to);
+        else
+            path.addBezierCurveToElement(to + FloatPoint(1, 0), to + FloatPoint(0, 1), to);
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    const double elements = double(kElements) * kIterations;
+    const Transform transform(1.0, 0.1, -0.1, 1.0, 2.0, 3.0);
+
+    benchmark::printHeader("Paths of " + std::to_string(kElements) + " elements", "Melements/s");
+
+    double seconds = benchmark::measure(kIterations, [&] {
+        LinkedPathData path;
+        buildPath(path);
+    });
+    benchmark::printResult("build (former linked list)", elements, seconds);
+
+    seconds = benchmark::measure(kIterations, [&] {
+        PathData path;
+        buildPath(path);
+    });
+    benchmark::printResult("build (flat arrays)", elements, seconds);
+
+    LinkedPathData linkedPath;
+    buildPath(linkedPath);
+    PathData path;
+    buildPath(path);
+
+    Float linkedSum = 0;
+    seconds = benchmark::measure(kIterations, [&] {
+        for (const LinkedElement* element = linkedPath.first; element; element = element->next)
+            linkedSum += element->to.x;
+    });
+    benchmark::printResult("iterate (former linked list)", elements, seconds);
+
+    Float sum = 0;
+    seconds = benchmark::measure(kIterations, [&] {
+        for (const PathElement element : path)
+            sum += element.to().x;
+    });
+    benchmark::printResult("iterate (flat arrays)", elements, seconds);
+
+    // A transform call rewrote the former paths, the transform is recorded lazily now.
+    seconds = benchmark::measure(kIterations, [&] {
+        linkedPath.applyTransform(transform);
+    });
+    benchmark::printResult("transform (former rewrite)", elements, seconds);
+
+    seconds = benchmark::measure(kIterations, [&] {
+        path.setTransform(transform);
+    });
+    benchmark::printResult("transform (lazy)", elements, seconds);
+
+    // Keep the results alive.
+    if (linkedSum != sum || linkedPath.first->to == path.transform().apply(path.lastElement().to())) {
+        std::cout << "The paths computed different results!" << std::endl;
+    }
+
+    return 0;
+}
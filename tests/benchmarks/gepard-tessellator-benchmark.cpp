@@ -0,0 +1,353 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gepard-benchmark.h"
+#include "gepard-float-point.h"
+#include "gepard-float.h"
+#include "gepard-path.h"
+#include "gepard-trapezoid-tessellator.h"
+#include <cmath>
+#include <list>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+using namespace gepard;
+
+const int kPaths = 1000;
+const int kPathSegments = 64;
+const int kOneFillPaths = 30;
+const int kStripSegments = 4000;
+const int kCombTeeth = 8000;
+const int kIterations = 10;
+
+/*!
+ * \brief The former SegmentApproximator storage: a linked segment list per
+ * sub-scanline in a map.
+ */
+class FormerSegmentApproximator {
+public:
+    typedef std::list<Segment> SegmentList;
+
+    ~FormerSegmentApproximator()
+    {
+        for (auto& bucket : _segments)
+            delete bucket.second;
+    }
+
+    void insertLine(const FloatPoint& from, const FloatPoint& to)
+    {
+        const FloatPoint scaledFrom(from.x * GD_ANTIALIAS_LEVEL, std::floor(from.y * GD_ANTIALIAS_LEVEL));
+        const FloatPoint scaledTo(to.x * GD_ANTIALIAS_LEVEL, std::floor(to.y * GD_ANTIALIAS_LEVEL));
+        if (scaledFrom.y == scaledTo.y)
+            return;
+
+        Segment segment(scaledFrom, scaledTo);
+        insertSegmentList(segment.topY())->push_front(segment);
+        insertSegmentList(segment.bottomY());
+    }
+
+    SegmentList* segments()
+    {
+        splitSegments();
+
+        std::set<int> ys;
+        for (auto& bucket : _segments) {
+            SegmentList* list = bucket.second;
+            list->sort(lessThan);
+            for (SegmentList::iterator current = list->begin(); current != list->end(); ++current) {
+                for (SegmentList::iterator segment = current; segment != list->end(); ++segment) {
+                    Float y = NAN;
+                    if (current->computeIntersectionY(&(*segment), y) && !std::isnan(y)) {
+                        ys.insert(std::floor(y));
+                        ys.insert(std::floor(y) + 1);
+                    }
+                }
+            }
+        }
+        for (const int y : ys)
+            insertSegmentList(y);
+
+        splitSegments();
+
+        SegmentList* segments = new SegmentList();
+        for (auto& bucket : _segments) {
+            bucket.second->sort(lessThan);
+            segments->merge(*bucket.second, lessThan);
+        }
+        return segments;
+    }
+
+private:
+    static bool lessThan(const Segment& lhs, const Segment& rhs)
+    {
+        return (lhs.from < rhs.from) || (lhs.from == rhs.from && lhs.to < rhs.to);
+    }
+
+    void splitSegments()
+    {
+        for (SegmentTree::iterator current = _segments.begin(); current != _segments.end(); ++current) {
+            SegmentTree::iterator next = current;
+            if (++next == _segments.end())
+                break;
+            for (Segment& segment : *current->second) {
+                if (segment.isOnSegment(next->first))
+                    next->second->push_front(segment.splitSegment(next->first));
+            }
+        }
+    }
+
+    SegmentList* insertSegmentList(const int y)
+    {
+        return _segments[y] ? _segments[y] : _segments[y] = new SegmentList();
+    }
+
+    typedef std::map<const int, SegmentList*> SegmentTree;
+    SegmentTree _segments;
+};
+
+/*!
+ * \brief Closed wavy rings at random places, like the outlines of an SVG image.
+ */
+std::vector<std::vector<FloatPoint>> createPaths()
+{
+    std::mt19937 random(1);
+    std::uniform_real_distribution<Float> position(0.0, 900.0);
+    std::uniform_real_distribution<Float> radius(5.0, 40.0);
+
+    std::vector<std::vector<FloatPoint>> paths(kPaths);
+    for (std::vector<FloatPoint>& path : paths) {
+        const FloatPoint center(position(random), position(random));
+        const Float r = radius(random);
+        for (int i = 0; i < kPathSegments; ++i) {
+            const Float angle = 2.0 * piFloat * i / kPathSegments;
+            const Float wave = r * (1.0 + 0.2 * std::sin(7.0 * angle));
+            path.push_back(FloatPoint(center.x + wave * std::cos(angle), center.y + wave * std::sin(angle)));
+        }
+    }
+    return paths;
+}
+
+/*!
+ * \brief Nearly parallel segments between the same scanlines, like the outlines of a text.
+ */
+std::vector<std::pair<FloatPoint, FloatPoint>> createStrip()
+{
+    std::mt19937 random(2);
+    std::uniform_real_distribution<Float> jitter(-0.1, 0.1);
+
+    std::vector<std::pair<FloatPoint, FloatPoint>> strip;
+    for (int i = 0; i < kStripSegments; ++i) {
+        const Float x = i * 0.25;
+        strip.push_back(std::make_pair(FloatPoint(x, 0.0), FloatPoint(x + 20.0 + jitter(random), 10.0)));
+    }
+    return strip;
+}
+
+/*!
+ * \brief A comb of thin teeth, the pieces of the teeth are in the same bands.
+ */
+PathData createComb()
+{
+    PathData comb;
+    comb.addMoveToElement(FloatPoint(0.0, 100.0));
+    for (int i = 0; i < kCombTeeth; ++i) {
+        comb.addLineToElement(FloatPoint(i * 0.5 + 0.125, (i % 2) ? 0.0 : 8.0));
+        comb.addLineToElement(FloatPoint(i * 0.5 + 0.25, 100.0));
+    }
+    comb.addCloseSubpathElement();
+    return comb;
+}
+
+template<typename Approximator>
+void insertPath(Approximator& approximator, const std::vector<FloatPoint>& path)
+{
+    for (size_t i = 0; i < path.size(); ++i) {
+        approximator.insertLine(path[i], path[(i + 1) % path.size()]);
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    const std::vector<std::vector<FloatPoint>> paths = createPaths();
+    const double segments = double(kPaths) * kPathSegments * kIterations;
+    size_t count = 0;
+
+    benchmark::printHeader(std::to_string(kPaths) + " paths of " + std::to_string(kPathSegments) + " segments", "Msegments/s");
+
+    double seconds = benchmark::measure(kIterations, [&] {
+        for (const std::vector<FloatPoint>& path : paths) {
+            FormerSegmentApproximator approximator;
+            insertPath(approximator, path);
+            FormerSegmentApproximator::SegmentList* list = approximator.segments();
+            count += list->size();
+            delete list;
+        }
+    });
+    benchmark::printResult("fill per path (former map of lists)", segments, seconds);
+
+    seconds = benchmark::measure(kIterations, [&] {
+        for (const std::vector<FloatPoint>& path : paths) {
+            SegmentApproximator approximator;
+            insertPath(approximator, path);
+            count += approximator.segments().size();
+        }
+    });
+    benchmark::printResult("fill per path (edge table)", segments, seconds);
+
+    EdgeTable edgeTable;
+    seconds = benchmark::measure(kIterations, [&] {
+        for (const std::vector<FloatPoint>& path : paths) {
+            SegmentApproximator approximator(GD_ANTIALIAS_LEVEL, 1.0, &edgeTable);
+            insertPath(approximator, path);
+            count += approximator.segments().size();
+        }
+    });
+    benchmark::printResult("fill per path (reused edge table)", segments, seconds);
+
+    // The former segment lists were merged into a list which was walked for each sub-scanline.
+    const double oneFillSegments = double(kOneFillPaths) * kPathSegments * kIterations;
+    benchmark::printHeader("One fill of " + std::to_string(kOneFillPaths) + " paths", "Msegments/s");
+
+    seconds = benchmark::measure(kIterations, [&] {
+        FormerSegmentApproximator approximator;
+        for (int i = 0; i < kOneFillPaths; ++i)
+            insertPath(approximator, paths[i]);
+        FormerSegmentApproximator::SegmentList* list = approximator.segments();
+        count += list->size();
+        delete list;
+    });
+    benchmark::printResult("one fill (former map of lists)", oneFillSegments, seconds);
+
+    seconds = benchmark::measure(kIterations, [&] {
+        SegmentApproximator approximator(GD_ANTIALIAS_LEVEL, 1.0, &edgeTable);
+        for (int i = 0; i < kOneFillPaths; ++i)
+            insertPath(approximator, paths[i]);
+        count += approximator.segments().size();
+    });
+    benchmark::printResult("one fill (reused edge table)", oneFillSegments, seconds);
+
+    // The former intersection search compared every pair of segments of a sub-scanline.
+    const std::vector<std::pair<FloatPoint, FloatPoint>> strip = createStrip();
+    const double stripSegments = double(kStripSegments) * kIterations;
+    benchmark::printHeader(std::to_string(kStripSegments) + " segments between the same scanlines", "Msegments/s");
+
+    seconds = benchmark::measure(kIterations, [&] {
+        FormerSegmentApproximator approximator;
+        for (const std::pair<FloatPoint, FloatPoint>& line : strip)
+            approximator.insertLine(line.first, line.second);
+        FormerSegmentApproximator::SegmentList* list = approximator.segments();
+        count += list->size();
+        delete list;
+    });
+    benchmark::printResult("strip (former pairwise)", stripSegments, seconds);
+
+    seconds = benchmark::measure(kIterations, [&] {
+        SegmentApproximator approximator(GD_ANTIALIAS_LEVEL, 1.0, &edgeTable);
+        for (const std::pair<FloatPoint, FloatPoint>& line : strip)
+            approximator.insertLine(line.first, line.second);
+        count += approximator.segments().size();
+    });
+    benchmark::printResult("strip (sweep line)", stripSegments, seconds);
+
+    // The software backend rasterizes the spans of the active edge table instead of the trapezoids.
+    std::vector<PathData> pathDatas(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        pathDatas[i].addMoveToElement(paths[i].front());
+        for (size_t j = 1; j < paths[i].size(); ++j)
+            pathDatas[i].addLineToElement(paths[i][j]);
+        pathDatas[i].addCloseSubpathElement();
+    }
+    benchmark::printHeader("Tessellation of " + std::to_string(kPaths) + " paths", "Msegments/s");
+
+    seconds = benchmark::measure(kIterations, [&] {
+        for (PathData& pathData : pathDatas) {
+            TrapezoidTessellator tessellator(pathData, TrapezoidTessellator::NonZero, GD_ANTIALIAS_LEVEL, &edgeTable);
+            count += tessellator.trapezoidList().size();
+        }
+    });
+    benchmark::printResult("trapezoid list", segments, seconds);
+
+    seconds = benchmark::measure(kIterations, [&] {
+        for (PathData& pathData : pathDatas) {
+            TrapezoidTessellator tessellator(pathData, TrapezoidTessellator::NonZero, GD_ANTIALIAS_LEVEL, &edgeTable);
+            count += tessellator.spanList().size();
+        }
+    });
+    benchmark::printResult("span list (active edge table)", segments, seconds);
+
+    // The trapezoids are walked sub-scanline by sub-scanline before they can be accumulated.
+    Float area = 0.0;
+    seconds = benchmark::measure(kIterations, [&] {
+        for (PathData& pathData : pathDatas) {
+            TrapezoidTessellator tessellator(pathData, TrapezoidTessellator::NonZero, GD_ANTIALIAS_LEVEL, &edgeTable);
+            for (const Trapezoid& trapezoid : tessellator.trapezoidList()) {
+                const int top = std::round(trapezoid.topY * GD_ANTIALIAS_LEVEL);
+                const int bottom = std::round(trapezoid.bottomY * GD_ANTIALIAS_LEVEL);
+                const Float height = bottom - top;
+                const Float leftDx = (trapezoid.bottomLeftX - trapezoid.topLeftX) / height;
+                const Float rightDx = (trapezoid.bottomRightX - trapezoid.topRightX) / height;
+                for (int y = 0; y < bottom - top; ++y) {
+                    const Float offset = y + 0.5;
+                    area += (trapezoid.topRightX + offset * rightDx) - (trapezoid.topLeftX + offset * leftDx);
+                }
+            }
+        }
+    });
+    benchmark::printResult("trapezoid list and sub-scanline walk", segments, seconds);
+
+    seconds = benchmark::measure(kIterations, [&] {
+        for (PathData& pathData : pathDatas) {
+            TrapezoidTessellator tessellator(pathData, TrapezoidTessellator::NonZero, GD_ANTIALIAS_LEVEL, &edgeTable);
+            for (const Span& span : tessellator.spanList())
+                area += span.right - span.left;
+        }
+    });
+    benchmark::printResult("span list and sub-scanline walk", segments, seconds);
+    count += (area > 0.0);
+
+    // The former vertical merge scanned the trapezoids of the next band for each trapezoid.
+    PathData comb = createComb();
+    const double combSegments = double(kCombTeeth) * 2 * kIterations;
+    benchmark::printHeader("Comb of " + std::to_string(kCombTeeth) + " teeth", "Msegments/s");
+
+    seconds = benchmark::measure(kIterations, [&] {
+        TrapezoidTessellator tessellator(comb, TrapezoidTessellator::NonZero, GD_ANTIALIAS_LEVEL, &edgeTable);
+        count += tessellator.trapezoidList().size();
+    });
+    benchmark::printResult("trapezoid list", combSegments, seconds);
+
+    // Keep the results alive.
+    if (!count) {
+        std::cout << "No segments were generated!" << std::endl;
+    }
+
+    return 0;
+}
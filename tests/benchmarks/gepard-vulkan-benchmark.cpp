@@ -0,0 +1,109 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gepard.h"
+
+#include "gepard-benchmark.h"
+#include "gepard-engine-backend.h"
+#include "gepard-memory-buffer-surface.h"
+#include <iostream>
+
+namespace {
+
+using namespace gepard;
+
+const uint32_t kWidth = 512;
+const uint32_t kHeight = 512;
+const int kRects = 16384;
+const int kFrames = 256;
+const int kFrameRects = 64;
+
+/*!
+ * \brief Draw _kRects_ small rects through the public API, flushing after
+ * every _rectsPerFrame_ rects, and return the elapsed seconds.
+ */
+double measureFillRects(Gepard& gepard, const int rectsPerFrame)
+{
+    int index = 0;
+    const double seconds = benchmark::measure(kRects / rectsPerFrame, [&] {
+        for (int i = 0; i < rectsPerFrame; ++i, ++index) {
+            gepard.setFillColor(index & 0xff, (index >> 8) & 0xff, 128, 0.5f);
+            gepard.fillRect((index * 16) % (kWidth - 16), (index * 48) % (kHeight - 16), 16, 16);
+        }
+        gepard.flush();
+    });
+    return seconds + benchmark::measure(1, [&] { gepard.finish(); });
+}
+
+/*!
+ * \brief Draw _kFrames_ frames of larger rects, each followed by the readback
+ * of the whole surface, and return the elapsed seconds.
+ *
+ * The seconds spent in the flush() calls are added to _flushSeconds_.
+ */
+double measureFrames(Gepard& gepard, double& flushSeconds)
+{
+    int index = 0;
+    const double seconds = benchmark::measure(kFrames, [&] {
+        for (int i = 0; i < kFrameRects; ++i, ++index) {
+            gepard.setFillColor(index & 0xff, 64, (index >> 8) & 0xff, 0.5f);
+            gepard.fillRect((index * 64) % (kWidth - 64), (index * 80) % (kHeight - 64), 64, 64);
+        }
+        flushSeconds += benchmark::measure(1, [&] { gepard.flush(); });
+    });
+    return seconds + benchmark::measure(1, [&] { gepard.finish(); });
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    MemoryBufferSurface surface(kWidth, kHeight);
+    if (!GepardEngineBackend::isAvailable(Gepard::VulkanBackend, &surface)) {
+        std::cout << "The Vulkan backend is not available." << std::endl;
+        return 0;
+    }
+
+    Gepard gepard(&surface, 1, Gepard::VulkanBackend);
+
+    // Warm up the pipelines and the readback buffers.
+    measureFillRects(gepard, kRects);
+
+    benchmark::printHeader("Vulkan fillRect of " + std::to_string(kRects) + " 16x16 rects", "us/rect");
+
+    for (const int rectsPerFrame : { 1, 16, 256, kRects }) {
+        const double seconds = measureFillRects(gepard, rectsPerFrame);
+        benchmark::printCost(std::to_string(rectsPerFrame) + " rects per frame", kRects, seconds);
+    }
+
+    benchmark::printHeader(std::to_string(kFrames) + " frames of " + std::to_string(kFrameRects) + " 64x64 rects", "us/frame");
+
+    double flushSeconds = 0;
+    const double seconds = measureFrames(gepard, flushSeconds);
+    benchmark::printCost("draw, flush and readback", kFrames, seconds);
+    benchmark::printCost("blocked in flush()", kFrames, flushSeconds);
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GEPARD_BLOCK_ALLOCATOR_TESTS_H
+#define GEPARD_BLOCK_ALLOCATOR_TESTS_H
+
+#include "gepard-block-allocator.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(BlockAllocatorTest, Alignment)
+{
+    gepard::BlockAllocator allocator(1024);
+
+    const gepard::BlockAllocator::Allocation first = allocator.allocate(10, 4);
+    const gepard::BlockAllocator::Allocation second = allocator.allocate(100, 256);
+    const gepard::BlockAllocator::Allocation third = allocator.allocate(4, 4);
+
+    EXPECT_EQ(0u, first.offset);
+    EXPECT_EQ(256u, second.offset);
+    // The padding before the second one is reused.
+    EXPECT_EQ(12u, third.offset);
+    EXPECT_EQ(1u, allocator.blockCount());
+
+    const gepard::BlockAllocator::Statistics statistics = allocator.statistics();
+    EXPECT_EQ(1024u, statistics.reservedBytes);
+    EXPECT_EQ(114u, statistics.usedBytes);
+    EXPECT_EQ(3u, statistics.allocationCount);
+}
+
+TEST(BlockAllocatorTest, NewBlocks)
+{
+    gepard::BlockAllocator allocator(1024);
+
+    const gepard::BlockAllocator::Allocation first = allocator.allocate(1000, 1);
+    const gepard::BlockAllocator::Allocation second = allocator.allocate(100, 1);
+    const gepard::BlockAllocator::Allocation dedicated = allocator.allocate(4096, 1);
+
+    EXPECT_EQ(0u, first.block);
+    EXPECT_EQ(1u, second.block);
+    EXPECT_EQ(0u, second.offset);
+    EXPECT_EQ(2u, dedicated.block);
+    EXPECT_EQ(3u, allocator.blockCount());
+    EXPECT_EQ(1024u, allocator.blockSize(1));
+    EXPECT_EQ(4096u, allocator.blockSize(2));
+
+    const gepard::BlockAllocator::Statistics statistics = allocator.statistics();
+    EXPECT_EQ(3u, statistics.blockCount);
+    EXPECT_EQ(1024u + 1024u + 4096u, statistics.reservedBytes);
+    EXPECT_EQ(1000u + 100u + 4096u, statistics.usedBytes);
+    EXPECT_EQ(0u, statistics.fragmentedBytes);
+}
+
+TEST(BlockAllocatorTest, FreeListReuse)
+{
+    gepard::BlockAllocator allocator(1024);
+
+    gepard::BlockAllocator::Allocation allocations[4];
+    for (int i = 0; i < 4; ++i) {
+        allocations[i] = allocator.allocate(256, 256);
+    }
+    EXPECT_EQ(1u, allocator.blockCount());
+
+    // Two separate holes.
+    allocator.free(allocations[0]);
+    allocator.free(allocations[2]);
+    gepard::BlockAllocator::Statistics statistics = allocator.statistics();
+    EXPECT_EQ(512u, statistics.usedBytes);
+    EXPECT_EQ(256u, statistics.fragmentedBytes);
+    EXPECT_EQ(2u, statistics.allocationCount);
+
+    // The freed ranges are merged with their neighbours.
+    allocator.free(allocations[1]);
+    statistics = allocator.statistics();
+    EXPECT_EQ(256u, statistics.usedBytes);
+    EXPECT_EQ(0u, statistics.fragmentedBytes);
+
+    const gepard::BlockAllocator::Allocation reused = allocator.allocate(768, 1);
+    EXPECT_EQ(0u, reused.block);
+    EXPECT_EQ(0u, reused.offset);
+    EXPECT_EQ(1u, allocator.blockCount());
+
+    allocator.free(reused);
+    allocator.free(allocations[3]);
+    statistics = allocator.statistics();
+    EXPECT_EQ(0u, statistics.usedBytes);
+    EXPECT_EQ(0u, statistics.allocationCount);
+    EXPECT_EQ(1024u, allocator.allocate(1024, 1).size);
+    EXPECT_EQ(1u, allocator.blockCount());
+}
+
+} // anonymous namespace
+
+#endif // GEPARD_BLOCK_ALLOCATOR_TESTS_H
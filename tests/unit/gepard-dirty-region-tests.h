@@ -0,0 +1,107 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GEPARD_DIRTY_REGION_TESTS_H
+#define GEPARD_DIRTY_REGION_TESTS_H
+
+#include "gepard-bounding-box.h"
+#include "gepard-dirty-region.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+gepard::BoundingBox box(const gepard::Float minX, const gepard::Float minY, const gepard::Float maxX, const gepard::Float maxY)
+{
+    gepard::BoundingBox bb;
+    bb.stretch(gepard::FloatPoint(minX, minY));
+    bb.stretch(gepard::FloatPoint(maxX, maxY));
+    return bb;
+}
+
+TEST(DirtyRegionTest, EmptyBoxes)
+{
+    gepard::DirtyRegion region;
+    EXPECT_TRUE(region.isEmpty());
+
+    region.add(gepard::BoundingBox());
+    region.add(box(1, 1, 1, 5));
+    EXPECT_TRUE(region.isEmpty());
+}
+
+TEST(DirtyRegionTest, DisjointBoxes)
+{
+    gepard::DirtyRegion region;
+    region.add(box(0, 0, 10, 10));
+    region.add(box(20, 0, 30, 10));
+    ASSERT_EQ(2u, region.boxes().size());
+
+    const gepard::BoundingBox bounds = region.bounds();
+    EXPECT_EQ(0.0, bounds.minX);
+    EXPECT_EQ(0.0, bounds.minY);
+    EXPECT_EQ(30.0, bounds.maxX);
+    EXPECT_EQ(10.0, bounds.maxY);
+
+    region.clear();
+    EXPECT_TRUE(region.isEmpty());
+}
+
+TEST(DirtyRegionTest, MergeBoxes)
+{
+    gepard::DirtyRegion region;
+    region.add(box(0, 0, 10, 10));
+    region.add(box(20, 0, 30, 10));
+    // Touches the first box and overlaps the second one.
+    region.add(box(10, 5, 25, 8));
+    ASSERT_EQ(1u, region.boxes().size());
+
+    const gepard::BoundingBox& merged = region.boxes().front();
+    EXPECT_EQ(0.0, merged.minX);
+    EXPECT_EQ(0.0, merged.minY);
+    EXPECT_EQ(30.0, merged.maxX);
+    EXPECT_EQ(10.0, merged.maxY);
+}
+
+TEST(DirtyRegionTest, Collapse)
+{
+    gepard::DirtyRegion region;
+    const size_t count = gepard::DirtyRegion::kMaximumNumberOfBoxes;
+    for (size_t i = 0; i < count; ++i) {
+        region.add(box(i * 10, 0, i * 10 + 5, 5));
+    }
+    EXPECT_EQ(count, region.boxes().size());
+
+    region.add(box(0, 100, 5, 105));
+    ASSERT_EQ(1u, region.boxes().size());
+
+    const gepard::BoundingBox& all = region.boxes().front();
+    EXPECT_EQ(0.0, all.minX);
+    EXPECT_EQ(0.0, all.minY);
+    EXPECT_EQ((count - 1) * 10 + 5, all.maxX);
+    EXPECT_EQ(105.0, all.maxY);
+}
+
+} // anonymous namespace
+
+#endif // GEPARD_DIRTY_REGION_TESTS_H
@@ -27,17 +27,29 @@
 #define GEPARD_PATH_TESTS_H
 
 #include "gepard-path.h"
+#include "gepard-stroke-builder.h"
 #include "gtest/gtest.h"
+#include <algorithm>
 #include <iostream>
 
 namespace {
 
+const gepard::PathElement elementAt(const gepard::PathData& pathData, std::size_t idx)
+{
+    gepard::PathIterator it = pathData.begin();
+    while (idx--) {
+        ++it;
+    }
+    return *it;
+}
+
 TEST(Path, EmptyPath)
 {
     gepard::Path path;
     gepard::PathData& pathData= *(path.pathData());
-    EXPECT_EQ(nullptr, pathData.firstElement()) << "The firstElement not nullptr on empty path.";
-    EXPECT_EQ(nullptr, pathData.lastElement()) << "The lastElement not nullptr on empty path.";
+    EXPECT_TRUE(pathData.isEmpty()) << "The path is not empty.";
+    EXPECT_EQ(0u, pathData.elementCount()) << "The path has elements.";
+    EXPECT_TRUE(pathData.begin() == pathData.end()) << "The iterator of an empty path is not at the end.";
 }
 
 TEST(Path, SimpleMoveTo)
@@ -47,13 +59,11 @@ TEST(Path, SimpleMoveTo)
     gepard::FloatPoint to(0.0, 0.1);
     std::size_t idx = 0;
 
-    const gepard::PathElement* prevPathelement = pathData.lastElement();
     pathData.addMoveToElement(to);
-    EXPECT_EQ(gepard::PathElementTypes::MoveTo, pathData[idx]->type) << "Wrong type.";
-    EXPECT_EQ(to, pathData[idx]->to) << "Differnet point.";
-    EXPECT_EQ(nullptr, pathData[idx]->next) << "The next element not nullptr.";
-    EXPECT_EQ(pathData.firstElement(), pathData.lastElement()) << "Differnet element.";
-    EXPECT_NE(prevPathelement, pathData.lastElement()) << "The current and previous elements are same.";
+    EXPECT_EQ(gepard::PathElementTypes::MoveTo, elementAt(pathData, idx).type) << "Wrong type.";
+    EXPECT_EQ(to, elementAt(pathData, idx).to()) << "Differnet point.";
+    EXPECT_EQ(1u, pathData.elementCount()) << "Wrong element count.";
+    EXPECT_EQ(to, pathData.lastElement().to()) << "Differnet element.";
 }
 
 TEST(Path, MoreMoveTo)
@@ -64,25 +74,21 @@ TEST(Path, MoreMoveTo)
     std::size_t idx = 0;
 
     pathData.addMoveToElement(to);
-    EXPECT_EQ(gepard::PathElementTypes::MoveTo, pathData[idx]->type) << "Wrong type.";
-    EXPECT_EQ(to, pathData[idx]->to) << "Differnet point.";
-    EXPECT_EQ(nullptr, pathData[idx]->next) << "The next element not nullptr.";
-    EXPECT_EQ(pathData.firstElement(), pathData.lastElement()) << "Differnet element.";
+    EXPECT_EQ(gepard::PathElementTypes::MoveTo, elementAt(pathData, idx).type) << "Wrong type.";
+    EXPECT_EQ(to, elementAt(pathData, idx).to()) << "Differnet point.";
+    EXPECT_EQ(1u, pathData.elementCount()) << "Wrong element count.";
     to = to + gepard::FloatPoint(1.0, 1.0);
 
     pathData.addMoveToElement(to);
-    EXPECT_EQ(gepard::PathElementTypes::MoveTo, pathData[idx]->type) << "Wrong type.";
-    EXPECT_EQ(to, pathData[idx]->to) << "Differnet point.";
-    EXPECT_EQ(nullptr, pathData[idx]->next) << "The next element not nullptr.";
-    EXPECT_EQ(pathData.firstElement(), pathData.lastElement()) << "Differnet element.";
+    EXPECT_EQ(gepard::PathElementTypes::MoveTo, elementAt(pathData, idx).type) << "Wrong type.";
+    EXPECT_EQ(to, elementAt(pathData, idx).to()) << "Differnet point.";
+    EXPECT_EQ(1u, pathData.elementCount()) << "Wrong element count.";
     to = to + gepard::FloatPoint(1.0, 1.0);
-    idx++;
 
     pathData.addMoveToElement(to);
-    EXPECT_EQ(gepard::PathElementTypes::MoveTo, pathData[idx]->type) << "Wrong type.";
-    EXPECT_EQ(to, pathData[idx]->to) << "Differnet point.";
-    EXPECT_EQ(nullptr, pathData[idx]->next) << "The next element not nullptr.";
-    EXPECT_EQ(pathData.firstElement(), pathData.lastElement()) << "Differnet element.";
+    EXPECT_EQ(gepard::PathElementTypes::MoveTo, elementAt(pathData, idx).type) << "Wrong type.";
+    EXPECT_EQ(to, elementAt(pathData, idx).to()) << "Differnet point.";
+    EXPECT_EQ(1u, pathData.elementCount()) << "Wrong element count.";
 }
 
 TEST(Path, SimpleLineTo)
@@ -94,10 +100,9 @@ TEST(Path, SimpleLineTo)
 
     // Test: https://www.w3.org/TR/2dcontext/#ensure-there-is-a-subpath
     pathData.addLineToElement(to);
-    EXPECT_EQ(gepard::PathElementTypes::MoveTo, pathData[idx]->type) << "Wrong type.";
-    EXPECT_EQ(to, pathData[idx]->to) << "Differnet point.";
-    EXPECT_EQ(nullptr, pathData[idx]->next) << "The next element not nullptr.";
-    EXPECT_EQ(pathData.firstElement(), pathData.lastElement()) << "Differnet element.";
+    EXPECT_EQ(gepard::PathElementTypes::MoveTo, elementAt(pathData, idx).type) << "Wrong type.";
+    EXPECT_EQ(to, elementAt(pathData, idx).to()) << "Differnet point.";
+    EXPECT_EQ(1u, pathData.elementCount()) << "Wrong element count.";
 }
 
 TEST(Path, MoreLineTo)
@@ -109,26 +114,24 @@ TEST(Path, MoreLineTo)
 
     // Test: https://www.w3.org/TR/2dcontext/#ensure-there-is-a-subpath
     pathData.addLineToElement(to);
-    EXPECT_EQ(gepard::PathElementTypes::MoveTo, pathData[idx]->type) << "Wrong type.";
-    EXPECT_EQ(to, pathData[idx]->to) << "Differnet point.";
-    EXPECT_EQ(nullptr, pathData[idx]->next) << "The next element not nullptr.";
-    EXPECT_EQ(pathData.firstElement(), pathData.lastElement()) << "Differnet element.";
+    EXPECT_EQ(gepard::PathElementTypes::MoveTo, elementAt(pathData, idx).type) << "Wrong type.";
+    EXPECT_EQ(to, elementAt(pathData, idx).to()) << "Differnet point.";
+    EXPECT_EQ(1u, pathData.elementCount()) << "Wrong element count.";
     to = to + gepard::FloatPoint(1.0, 1.0);
     idx++;
 
     pathData.addLineToElement(to);
-    EXPECT_EQ(gepard::PathElementTypes::LineTo, pathData[idx]->type) << "Wrong type.";
-    EXPECT_EQ(to, pathData[idx]->to) << "Differnet point.";
-    EXPECT_EQ(nullptr, pathData[idx]->next) << "The next element not nullptr.";
-    EXPECT_NE(pathData.firstElement(), pathData.lastElement()) << "Differnet element.";
+    EXPECT_EQ(gepard::PathElementTypes::LineTo, elementAt(pathData, idx).type) << "Wrong type.";
+    EXPECT_EQ(to, elementAt(pathData, idx).to()) << "Differnet point.";
+    EXPECT_EQ(2u, pathData.elementCount()) << "Wrong element count.";
     to = to + gepard::FloatPoint(1.0, 1.0);
     idx++;
 
     pathData.addLineToElement(to);
-    EXPECT_EQ(gepard::PathElementTypes::LineTo, pathData[idx]->type) << "Wrong type.";
-    EXPECT_EQ(to, pathData[idx]->to) << "Differnet point.";
-    EXPECT_EQ(nullptr, pathData[idx]->next) << "The next element not nullptr.";
-    EXPECT_NE(pathData.firstElement(), pathData.lastElement()) << "Differnet element.";
+    EXPECT_EQ(gepard::PathElementTypes::LineTo, elementAt(pathData, idx).type) << "Wrong type.";
+    EXPECT_EQ(to, elementAt(pathData, idx).to()) << "Differnet point.";
+    EXPECT_EQ(3u, pathData.elementCount()) << "Wrong element count.";
+    EXPECT_EQ(to, pathData.lastElement().to()) << "Differnet element.";
 }
 
 TEST(Path, SamePointLineTo)
@@ -140,10 +143,153 @@ TEST(Path, SamePointLineTo)
 
     pathData.addMoveToElement(to);
     pathData.addLineToElement(to);
-    EXPECT_EQ(gepard::PathElementTypes::MoveTo, pathData[idx]->type) << "Wrong type.";
-    EXPECT_EQ(to, pathData[idx]->to) << "Differnet point.";
-    EXPECT_EQ(nullptr, pathData[idx]->next) << "The next element not nullptr.";
-    EXPECT_EQ(pathData.firstElement(), pathData.lastElement()) << "Differnet element.";
+    EXPECT_EQ(gepard::PathElementTypes::MoveTo, elementAt(pathData, idx).type) << "Wrong type.";
+    EXPECT_EQ(to, elementAt(pathData, idx).to()) << "Differnet point.";
+    EXPECT_EQ(1u, pathData.elementCount()) << "Wrong element count.";
+}
+
+TEST(Path, IterateElements)
+{
+    gepard::PathData pathData;
+    pathData.addMoveToElement(gepard::FloatPoint(0.0, 0.0));
+    pathData.addQuadaraticCurveToElement(gepard::FloatPoint(1.0, 0.0), gepard::FloatPoint(1.0, 1.0));
+    pathData.addArcElement(gepard::FloatPoint(0.0, 1.0), gepard::FloatPoint(1.0, 1.0), 0.0, gepard::piFloat);
+    pathData.addBezierCurveToElement(gepard::FloatPoint(-1.0, 2.0), gepard::FloatPoint(-2.0, 2.0), gepard::FloatPoint(-2.0, 3.0));
+    pathData.addCloseSubpathElement();
+
+    const gepard::PathElementType types[] = {
+        gepard::PathElementTypes::MoveTo,
+        gepard::PathElementTypes::QuadraticCurve,
+        gepard::PathElementTypes::Arc,
+        gepard::PathElementTypes::BezierCurve,
+        gepard::PathElementTypes::CloseSubpath,
+    };
+    std::size_t idx = 0;
+    for (const gepard::PathElement element : pathData) {
+        ASSERT_GT(5u, idx) << "Too many elements.";
+        EXPECT_EQ(types[idx], element.type) << "Wrong type.";
+        EXPECT_EQ(element.type == gepard::PathElementTypes::Arc, element.arc != nullptr) << "Wrong arc.";
+        idx++;
+    }
+    EXPECT_EQ(5u, idx) << "Wrong element count.";
+
+    EXPECT_EQ(gepard::FloatPoint(1.0, 0.0), elementAt(pathData, 1).control()) << "Differnet control point.";
+    EXPECT_EQ(gepard::FloatPoint(0.0, 1.0), elementAt(pathData, 2).arc->center) << "Differnet center point.";
+    EXPECT_EQ(gepard::FloatPoint(-2.0, 2.0), elementAt(pathData, 3).control2()) << "Differnet control point.";
+    EXPECT_EQ(gepard::FloatPoint(-2.0, 3.0), elementAt(pathData, 3).to()) << "Differnet point.";
+    EXPECT_EQ(gepard::FloatPoint(0.0, 0.0), pathData.lastElement().to()) << "The subpath was not closed to its start.";
+}
+
+TEST(Path, LazyTransform)
+{
+    const gepard::Transform scale(2.0, 0.0, 0.0, 2.0, 0.0, 0.0);
+    const gepard::Transform translate(1.0, 0.0, 0.0, 1.0, 10.0, 0.0);
+    gepard::PathData pathData;
+    pathData.addMoveToElement(gepard::FloatPoint(1.0, 1.0));
+    pathData.addLineToElement(gepard::FloatPoint(2.0, 1.0));
+
+    // Only the last transform before an element is recorded.
+    pathData.setTransform(translate);
+    pathData.setTransform(scale);
+    pathData.addLineToElement(gepard::FloatPoint(2.0, 1.0));
+    pathData.addBezierCurveToElement(gepard::FloatPoint(2.0, 2.0), gepard::FloatPoint(1.0, 2.0), gepard::FloatPoint(1.0, 3.0));
+
+    std::size_t transforms = 0;
+    const gepard::Transform* lastTransform = nullptr;
+    for (const gepard::PathElement element : pathData) {
+        if (element.transform != lastTransform)
+            transforms++;
+        lastTransform = element.transform;
+    }
+    EXPECT_EQ(2u, transforms) << "Wrong number of recorded transforms.";
+
+    EXPECT_EQ(4u, pathData.elementCount()) << "The same point in another user space was dropped.";
+    EXPECT_EQ(gepard::FloatPoint(2.0, 1.0), elementAt(pathData, 1).transform->apply(elementAt(pathData, 1).to())) << "Wrong device point.";
+    EXPECT_EQ(gepard::FloatPoint(4.0, 2.0), elementAt(pathData, 2).transform->apply(elementAt(pathData, 2).to())) << "Wrong device point.";
+    EXPECT_EQ(gepard::FloatPoint(2.0, 4.0), elementAt(pathData, 3).transform->apply(elementAt(pathData, 3).control2())) << "Wrong device point.";
+}
+
+TEST(Path, CloseSubpathAfterTransform)
+{
+    gepard::PathData pathData;
+    pathData.addMoveToElement(gepard::FloatPoint(1.0, 1.0));
+    pathData.addLineToElement(gepard::FloatPoint(2.0, 1.0));
+    pathData.setTransform(gepard::Transform(1.0, 0.0, 0.0, 1.0, 10.0, 0.0));
+    pathData.addLineToElement(gepard::FloatPoint(0.0, 2.0));
+    pathData.addCloseSubpathElement();
+
+    const gepard::PathElement close = pathData.lastElement();
+    EXPECT_TRUE(close.isCloseSubpath()) << "Wrong type.";
+    EXPECT_EQ(gepard::FloatPoint(-9.0, 1.0), close.to()) << "The start of the subpath is not in the current user space.";
+    EXPECT_EQ(gepard::FloatPoint(1.0, 1.0), close.transform->apply(close.to())) << "The subpath was not closed to its start.";
+}
+
+TEST(Path, ReplacedMoveToTransform)
+{
+    gepard::PathData pathData;
+    pathData.addMoveToElement(gepard::FloatPoint(1.0, 1.0));
+    pathData.setTransform(gepard::Transform(3.0, 0.0, 0.0, 3.0, 0.0, 0.0));
+    pathData.addMoveToElement(gepard::FloatPoint(1.0, 1.0));
+
+    EXPECT_EQ(1u, pathData.elementCount()) << "The MoveTo was not replaced.";
+    const gepard::PathElement moveTo = *pathData.begin();
+    EXPECT_EQ(gepard::FloatPoint(3.0, 3.0), moveTo.transform->apply(moveTo.to())) << "The MoveTo has an old transform.";
+}
+
+TEST(Path, SnapshotIsNotModified)
+{
+    gepard::Path path;
+    path.pathData()->addMoveToElement(gepard::FloatPoint(0.0, 0.0));
+    path.pathData()->addLineToElement(gepard::FloatPoint(1.0, 0.0));
+    path.pathData()->addBezierCurveToElement(gepard::FloatPoint(1.0, 1.0), gepard::FloatPoint(2.0, 1.0), gepard::FloatPoint(2.0, 2.0));
+    path.pathData()->addCloseSubpathElement();
+
+    std::shared_ptr<gepard::PathData> snapshot = path.snapshot();
+    path.pathData()->addLineToElement(gepard::FloatPoint(5.0, 5.0));
+    EXPECT_NE(snapshot.get(), path.pathData()) << "The snapshot was not detached.";
+
+    const gepard::PathData& pathData = *(path.pathData());
+    std::size_t idx = 0;
+    for (const gepard::PathElement element : *snapshot) {
+        EXPECT_EQ(element.type, elementAt(pathData, idx).type) << "Wrong type.";
+        EXPECT_EQ(element.to(), elementAt(pathData, idx).to()) << "Differnet point.";
+        EXPECT_NE(element.points, elementAt(pathData, idx).points) << "The element was not copied.";
+        ++idx;
+    }
+    EXPECT_EQ(4u, idx) << "The snapshot was modified.";
+    EXPECT_EQ(5u, pathData.elementCount()) << "Wrong element count.";
+    EXPECT_EQ(gepard::FloatPoint(5.0, 5.0), pathData.lastElement().to()) << "Differnet point.";
+
+    EXPECT_EQ(gepard::FloatPoint(2.0, 1.0), elementAt(pathData, 2).control2()) << "Differnet control point.";
+
+    path.clear();
+    EXPECT_TRUE(path.pathData()->isEmpty());
+    EXPECT_FALSE(snapshot->isEmpty());
+}
+
+TEST(Path, StrokedArcOfOtherTransform)
+{
+    // A circle of radius 10 added under a horizontal scale is an ellipse.
+    gepard::PathData pathData;
+    pathData.setTransform(gepard::Transform(2.0, 0.0, 0.0, 1.0, 0.0, 0.0));
+    pathData.addMoveToElement(gepard::FloatPoint(10.0, 0.0));
+    pathData.addArcElement(gepard::FloatPoint(0.0, 0.0), gepard::FloatPoint(10.0, 10.0), 0.0, gepard::piFloat, false);
+
+    gepard::StrokePathBuilder builder(2.0, 10.0, gepard::LineJoinTypes::MiterJoin, gepard::LineCapTypes::ButtCap);
+    builder.convertStrokeToFill(&pathData, gepard::Transform());
+
+    gepard::Float minX = 0.0, maxX = 0.0, maxY = 0.0;
+    for (const gepard::PathElement element : *builder.pathData()) {
+        for (int i = 0; i < gepard::PathElement::pointCount(element.type); ++i) {
+            const gepard::FloatPoint point = element.transform->apply(element.points[i]);
+            minX = std::min(minX, point.x);
+            maxX = std::max(maxX, point.x);
+            maxY = std::max(maxY, point.y);
+        }
+    }
+    EXPECT_NEAR(-21.0, minX, 0.5) << "The radius of the arc was not transformed.";
+    EXPECT_NEAR(21.0, maxX, 0.5) << "Wrong end of the ellipse.";
+    EXPECT_NEAR(11.0, maxY, 0.5) << "Wrong height of the ellipse.";
 }
 
 } // anonymous namespace
@@ -0,0 +1,124 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GEPARD_SOFTWARE_BLEND_TESTS_H
+#define GEPARD_SOFTWARE_BLEND_TESTS_H
+
+#include "gepard-color.h"
+#include "gepard-software-blend.h"
+#include "gtest/gtest.h"
+#include <stdint.h>
+#include <vector>
+
+namespace {
+
+static std::vector<uint32_t> premultipliedPixels(const int count, uint32_t seed)
+{
+    std::vector<uint32_t> pixels(count);
+    for (uint32_t& pixel : pixels) {
+        seed = seed * 1103515245u + 12345u;
+        const uint32_t alpha = seed >> 24;
+        uint32_t result = alpha << 24;
+        for (int shift = 0; shift < 24; shift += 8) {
+            result |= (((seed >> shift) & 0xff) * alpha / 255) << shift;
+        }
+        pixel = result;
+    }
+    return pixels;
+}
+
+TEST(SpanBlender, ScalarSourceOver)
+{
+    const gepard::software::SpanBlender& scalar = *gepard::software::supportedSpanBlenders().front();
+    uint32_t pixels[] = { 0xff0000ff, 0x00000000, 0x80808080 };
+
+    scalar.fillSpan(pixels, 3, 0xff00ff00);
+    EXPECT_EQ(0xff00ff00, pixels[0]);
+    EXPECT_EQ(0xff00ff00, pixels[1]);
+    EXPECT_EQ(0xff00ff00, pixels[2]);
+
+    uint32_t halfPixels[] = { 0xff0000ff, 0x00000000 };
+    scalar.fillSpan(halfPixels, 2, 0x80008000);
+    EXPECT_EQ(0xff00807f, halfPixels[0]);
+    EXPECT_EQ(0x80008000, halfPixels[1]);
+}
+
+TEST(SpanBlender, SameResults)
+{
+    const std::vector<const gepard::software::SpanBlender*> blenders = gepard::software::supportedSpanBlenders();
+    const gepard::software::SpanBlender& scalar = *blenders.front();
+    const int count = 67;
+    std::vector<uint32_t> colors = premultipliedPixels(16, 1);
+    colors.push_back(0xff336699);
+    const std::vector<uint32_t> background = premultipliedPixels(count, 2);
+
+    std::vector<uint8_t> mask(count);
+    for (int i = 0; i < count; ++i) {
+        mask[i] = (i * 37) & 0xff;
+    }
+    mask[8] = mask[9] = mask[10] = mask[11] = 0;
+
+    for (const gepard::software::SpanBlender* blender : blenders) {
+        for (const uint32_t color : colors) {
+            std::vector<uint32_t> expected = background;
+            std::vector<uint32_t> actual = background;
+            scalar.fillSpan(expected.data(), count, color);
+            blender->fillSpan(actual.data(), count, color);
+            EXPECT_EQ(expected, actual) << "fillSpan of '" << blender->name << "' differs from the scalar one.";
+
+            expected = background;
+            actual = background;
+            scalar.fillMaskedSpan(expected.data(), count, color, mask.data());
+            blender->fillMaskedSpan(actual.data(), count, color, mask.data());
+            EXPECT_EQ(expected, actual) << "fillMaskedSpan of '" << blender->name << "' differs from the scalar one.";
+
+            if ((color >> 24) != 255)
+                continue;
+
+            expected = background;
+            actual = background;
+            scalar.fillSpan(expected.data(), count, color);
+            blender->fillOpaqueSpan(actual.data(), count, color);
+            EXPECT_EQ(expected, actual) << "fillOpaqueSpan of '" << blender->name << "' differs from the blended one.";
+        }
+    }
+}
+
+TEST(SpanBlender, Premultiply)
+{
+    EXPECT_EQ(0xff0000ff, gepard::software::premultiply(gepard::Color(1.0, 0.0, 0.0, 1.0)));
+    EXPECT_EQ(0x00000000, gepard::software::premultiply(gepard::Color(1.0, 1.0, 1.0, 0.0)));
+
+    const uint32_t premultiplied = gepard::software::premultiply(gepard::Color(1.0, 0.0, 0.0, 0.5));
+    EXPECT_EQ(0x7f00007f, premultiplied);
+
+    uint32_t unpremultiplied;
+    gepard::software::unpremultiplySpan(&premultiplied, &unpremultiplied, 1);
+    EXPECT_EQ(0x7f0000ff, unpremultiplied);
+}
+
+} // anonymous namespace
+
+#endif // GEPARD_SOFTWARE_BLEND_TESTS_H
@@ -0,0 +1,156 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gepard.h"
+
+#include "gepard-memory-buffer-surface.h"
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+static const uint32_t kWidth = 160;
+static const uint32_t kHeight = 120;
+static const int kThreadCount = 16;
+static const int kRepeatCount = 4;
+
+typedef std::vector<uint32_t> Pixels;
+
+/*!
+ * \brief Draw the scene of the _index_th canvas, each canvas differs a bit.
+ */
+void drawScene(gepard::Gepard& gepard, const int index)
+{
+    gepard.setFillColor(255, 255, 255);
+    gepard.fillRect(0, 0, kWidth, kHeight);
+
+    // Star, which has self-intersections.
+    gepard.beginPath();
+    for (int i = 0; i < 5; ++i) {
+        const float angle = 4.0f * float(M_PI) * i / 5.0f + 0.1f * index;
+        const float x = 60.0f + 50.0f * std::sin(angle);
+        const float y = 60.0f - 50.0f * std::cos(angle);
+        if (i) {
+            gepard.lineTo(x, y);
+        } else {
+            gepard.moveTo(x, y);
+        }
+    }
+    gepard.closePath();
+    gepard.setFillColor(40 + 10 * index, 80, 200, 0.8f);
+    gepard.fill(index % 2 ? "evenodd" : "nonzero");
+
+    // Curves.
+    gepard.beginPath();
+    gepard.moveTo(100.0f, 10.0f + index);
+    gepard.bezierCurveTo(150.0f, 20.0f, 90.0f, 80.0f, 150.0f, 110.0f);
+    gepard.quadraticCurveTo(110.0f, 100.0f, 100.0f, 10.0f + index);
+    gepard.setFillColor(200, 100, 20, 0.6f);
+    gepard.fill();
+
+    // Strokes.
+    gepard.beginPath();
+    gepard.arc(80.0f, 60.0f, 20.0f + index, 0.0f, 1.5f * float(M_PI));
+    gepard.lineWidth = 3 + index % 4;
+    gepard.lineJoin = "round";
+    gepard.setStrokeColor(0, 0, 0, 0.7f);
+    gepard.stroke();
+
+    gepard.finish();
+}
+
+/*!
+ * \brief Render the _index_th canvas into the _pixels_.
+ */
+const gepard::Gepard::Backend render(const gepard::Gepard::Backend backend, const int index, Pixels& pixels)
+{
+    gepard::MemoryBufferSurface surface(kWidth, kHeight);
+    gepard::Gepard gepard(&surface, 1, backend);
+
+    drawScene(gepard, index);
+
+    const uint32_t* buffer = reinterpret_cast<const uint32_t*>(surface.getBuffer());
+    pixels.assign(buffer, buffer + kWidth * kHeight);
+    return gepard.backend();
+}
+
+/*!
+ * \brief Render the canvases on kThreadCount threads at the same time, and
+ * compare them with the canvases rendered one by one.
+ */
+void expectSameAsSingleThreaded(const gepard::Gepard::Backend backend)
+{
+    std::vector<Pixels> expected(kThreadCount);
+    for (int index = 0; index < kThreadCount; ++index) {
+        render(backend, index, expected[index]);
+    }
+
+    std::vector<std::vector<Pixels>> actual(kThreadCount, std::vector<Pixels>(kRepeatCount));
+    std::vector<std::thread> threads;
+    for (int index = 0; index < kThreadCount; ++index) {
+        threads.push_back(std::thread([backend, index, &actual] {
+            for (Pixels& pixels : actual[index]) {
+                render(backend, index, pixels);
+            }
+        }));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (int index = 0; index < kThreadCount; ++index) {
+        for (int repeat = 0; repeat < kRepeatCount; ++repeat) {
+            EXPECT_TRUE(expected[index] == actual[index][repeat]) << "canvas: " << index << ", repeat: " << repeat;
+        }
+    }
+}
+
+TEST(ThreadTest, SoftwareBackend)
+{
+    expectSameAsSingleThreaded(gepard::Gepard::SoftwareBackend);
+}
+
+TEST(ThreadTest, AutoBackend)
+{
+    // The first available backend, or the one of the GD_BACKEND environment variable.
+    Pixels pixels;
+    const gepard::Gepard::Backend backend = render(gepard::Gepard::AutoBackend, 0, pixels);
+    if (backend == gepard::Gepard::SoftwareBackend) {
+        GTEST_SKIP() << "Only the software backend is available.";
+    }
+
+    expectSameAsSingleThreaded(backend);
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
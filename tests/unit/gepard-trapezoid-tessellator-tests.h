@@ -0,0 +1,549 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GEPARD_TRAPEZOID_TESSELLATOR_TESTS_H
+#define GEPARD_TRAPEZOID_TESSELLATOR_TESTS_H
+
+#include "gepard-fixed.h"
+#include "gepard-float.h"
+#include "gepard-path.h"
+#include "gepard-trapezoid-tessellator.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+/*!
+ * \brief The covered area of each pixel row by the trapezoids of the _pathData_.
+ */
+template<typename Coordinate>
+std::vector<gepard::Float> rowCoverage(gepard::PathData& pathData, const gepard::TrapezoidFillRule::FillRule fillRule, const int rows)
+{
+    gepard::BasicTrapezoidTessellator<Coordinate> tessellator(pathData, fillRule);
+    std::vector<gepard::Float> coverage(rows, 0.0);
+
+    for (const gepard::BasicTrapezoid<Coordinate>& trapezoid : tessellator.trapezoidList()) {
+        if (!trapezoid.leftId || !trapezoid.rightId)
+            continue;
+
+        const gepard::Float topY = trapezoid.topY;
+        const gepard::Float bottomY = trapezoid.bottomY;
+        auto width = [&](const gepard::Float y) {
+            const gepard::Float t = (y - topY) / (bottomY - topY);
+            const gepard::Float leftX = trapezoid.topLeftX + (trapezoid.bottomLeftX - trapezoid.topLeftX) * t;
+            const gepard::Float rightX = trapezoid.topRightX + (trapezoid.bottomRightX - trapezoid.topRightX) * t;
+            return rightX - leftX;
+        };
+
+        for (int row = std::max(0, int(std::floor(topY))); row < std::min(rows, int(std::ceil(bottomY))); ++row) {
+            const gepard::Float y0 = std::max(topY, gepard::Float(row));
+            const gepard::Float y1 = std::min(bottomY, gepard::Float(row + 1));
+            if (y0 < y1)
+                coverage[row] += (width(y0) + width(y1)) / 2.0 * (y1 - y0);
+        }
+    }
+
+    return coverage;
+}
+
+/*!
+ * \brief The covered area of each pixel row by the spans of the _pathData_.
+ */
+std::vector<gepard::Float> spanRowCoverage(gepard::PathData& pathData, const gepard::TrapezoidFillRule::FillRule fillRule, const int rows)
+{
+    gepard::TrapezoidTessellator tessellator(pathData, fillRule);
+    const gepard::SpanList spans = tessellator.spanList();
+    std::vector<gepard::Float> coverage(rows, 0.0);
+
+    for (size_t i = 0; i < spans.size(); ++i) {
+        const gepard::Span& span = spans[i];
+        EXPECT_LT(span.left, span.right);
+        if (i) {
+            const gepard::Span& previous = spans[i - 1];
+            EXPECT_TRUE(previous.y < span.y || (previous.y == span.y && previous.right <= span.left)) << "The spans are not sorted.";
+        }
+
+        const int row = span.y / GD_ANTIALIAS_LEVEL;
+        if (row >= 0 && row < rows)
+            coverage[row] += (span.right - span.left) / GD_ANTIALIAS_LEVEL;
+    }
+
+    return coverage;
+}
+
+/*!
+ * \brief Compare the coverage of the spans with the trapezoids.
+ */
+void expectSpansWithinTolerance(gepard::PathData& pathData, const gepard::TrapezoidFillRule::FillRule fillRule, const int rows)
+{
+    // The trapezoids move the intersections to the sub-scanlines, while the
+    // spans sample the edges in the middle of the sub-scanlines, so neither
+    // is exact along the crossing edges.
+    const gepard::Float kRowTolerance = 0.15;
+    const gepard::Float kAreaTolerance = 1e-3;
+
+    const std::vector<gepard::Float> reference = rowCoverage<gepard::GeometryCoordinate>(pathData, fillRule, rows);
+    const std::vector<gepard::Float> coverage = spanRowCoverage(pathData, fillRule, rows);
+
+    gepard::Float referenceArea = 0.0;
+    gepard::Float area = 0.0;
+    for (int row = 0; row < rows; ++row) {
+        EXPECT_NEAR(reference[row], coverage[row], kRowTolerance) << "The span coverage differs in row " << row << ".";
+        referenceArea += reference[row];
+        area += coverage[row];
+    }
+    EXPECT_NEAR(referenceArea, area, referenceArea * kAreaTolerance);
+}
+
+/*!
+ * \brief Compare the coverage of the float and the fixed point geometry
+ * with the double one.
+ */
+void expectCoverageWithinTolerance(gepard::PathData& pathData, const gepard::TrapezoidFillRule::FillRule fillRule, const int rows)
+{
+    // Area in pixels of a row, and of the whole path relative to its area.
+    const gepard::Float kRowTolerance = 0.05;
+    const gepard::Float kAreaTolerance = 0.001;
+
+    const std::vector<gepard::Float> reference = rowCoverage<gepard::Float>(pathData, fillRule, rows);
+    const std::vector<gepard::Float> singleCoverage = rowCoverage<float>(pathData, fillRule, rows);
+    const std::vector<gepard::Float> fixedCoverage = rowCoverage<gepard::Fixed>(pathData, fillRule, rows);
+
+    gepard::Float referenceArea = 0.0;
+    gepard::Float singleArea = 0.0;
+    gepard::Float fixedArea = 0.0;
+    for (int row = 0; row < rows; ++row) {
+        EXPECT_NEAR(reference[row], singleCoverage[row], kRowTolerance) << "The float coverage differs in row " << row << ".";
+        EXPECT_NEAR(reference[row], fixedCoverage[row], kRowTolerance) << "The fixed coverage differs in row " << row << ".";
+        referenceArea += reference[row];
+        singleArea += singleCoverage[row];
+        fixedArea += fixedCoverage[row];
+    }
+
+    ASSERT_GT(referenceArea, 0.0) << "The path is not filled.";
+    EXPECT_NEAR(1.0, singleArea / referenceArea, kAreaTolerance) << "The float area differs.";
+    EXPECT_NEAR(1.0, fixedArea / referenceArea, kAreaTolerance) << "The fixed area differs.";
+}
+
+typedef std::vector<std::pair<gepard::FloatPoint, gepard::FloatPoint>> LineList;
+
+bool segmentLessThan(const gepard::Segment& lhs, const gepard::Segment& rhs)
+{
+    if (lhs.from == rhs.from && lhs.to == rhs.to)
+        return lhs.direction < rhs.direction;
+    return (lhs.from < rhs.from) || (lhs.from == rhs.from && lhs.to < rhs.to);
+}
+
+/*!
+ * \brief Split the sorted segments at the _lines_ like the SegmentApproximator.
+ */
+void splitSegments(gepard::SegmentList& segments, const std::set<int>& lines)
+{
+    gepard::SegmentList result;
+    for (gepard::Segment segment : segments) {
+        for (std::set<int>::const_iterator line = lines.upper_bound(segment.topY()); line != lines.end() && segment.isOnSegment(*line); ++line) {
+            const gepard::Segment bottomSegment = segment.splitSegment(*line);
+            result.push_back(segment);
+            segment = bottomSegment;
+        }
+        result.push_back(segment);
+    }
+    std::stable_sort(result.begin(), result.end(), segmentLessThan);
+    segments.swap(result);
+}
+
+/*!
+ * \brief The segments of the former SegmentApproximator, which compared
+ * every pair of segments of a sub-scanline to find the intersections.
+ */
+gepard::SegmentList referenceSegments(const LineList& lines, const int antiAliasLevel)
+{
+    gepard::SegmentList segments;
+    std::set<int> ys;
+    for (const std::pair<gepard::FloatPoint, gepard::FloatPoint>& line : lines) {
+        const gepard::FloatPoint from(line.first.x * antiAliasLevel, std::floor(line.first.y * antiAliasLevel));
+        const gepard::FloatPoint to(line.second.x * antiAliasLevel, std::floor(line.second.y * antiAliasLevel));
+        if (from.y == to.y)
+            continue;
+        segments.push_back(gepard::Segment(from, to));
+        ys.insert(segments.back().topY());
+        ys.insert(segments.back().bottomY());
+    }
+    splitSegments(segments, ys);
+
+    ys.clear();
+    for (size_t i = 0; i < segments.size(); ++i) {
+        for (size_t j = i + 1; j < segments.size() && segments[j].from.y == segments[i].from.y; ++j) {
+            gepard::Float y = NAN;
+            if (segments[i].computeIntersectionY(&segments[j], y) && !std::isnan(y)) {
+                ys.insert(std::floor(y));
+                if (std::floor(y) != y)
+                    ys.insert(std::floor(y) + 1);
+            }
+        }
+    }
+    splitSegments(segments, ys);
+
+    // Fix the intersection pairs of the one sub-scanline high segments.
+    for (size_t bucket = 0; bucket < segments.size();) {
+        size_t bucketEnd = bucket;
+        for (; bucketEnd < segments.size() && segments[bucketEnd].from.y == segments[bucket].from.y; ++bucketEnd);
+        bool needSorting = false;
+        for (size_t i = bucket; i < bucketEnd; ++i) {
+            if (segments[i].to.y - segments[i].from.y != 1.0)
+                continue;
+            for (size_t j = i; j < bucketEnd; ++j) {
+                if (segments[j].to.x < segments[i].to.x) {
+                    if (segments[j].from.x - segments[i].from.x < segments[i].to.x - segments[j].to.x) {
+                        segments[j].from.x = segments[i].from.x;
+                        needSorting = true;
+                    } else {
+                        segments[j].to.x = segments[i].to.x;
+                    }
+                }
+            }
+        }
+        if (needSorting) {
+            std::stable_sort(segments.begin() + bucket, segments.begin() + bucketEnd, segmentLessThan);
+        } else {
+            bucket = bucketEnd;
+        }
+    }
+
+    return segments;
+}
+
+/*!
+ * \brief Compare the segments of the SegmentApproximator with the reference ones.
+ */
+void expectSegmentsAsReference(const LineList& lines, const int antiAliasLevel)
+{
+    gepard::SegmentApproximator approximator(antiAliasLevel);
+    for (const std::pair<gepard::FloatPoint, gepard::FloatPoint>& line : lines) {
+        approximator.insertLine(line.first, line.second);
+    }
+
+    gepard::SegmentList segments = approximator.segments();
+    gepard::SegmentList reference = referenceSegments(lines, antiAliasLevel);
+    std::stable_sort(segments.begin(), segments.end(), segmentLessThan);
+    std::stable_sort(reference.begin(), reference.end(), segmentLessThan);
+
+    ASSERT_EQ(reference.size(), segments.size());
+    for (size_t i = 0; i < segments.size(); ++i) {
+        ASSERT_TRUE(reference[i].from == segments[i].from && reference[i].to == segments[i].to && reference[i].direction == segments[i].direction)
+            << "The " << i << ". segment is " << segments[i] << " instead of " << reference[i] << ".";
+    }
+}
+
+TEST(TrapezoidTessellator, FixedPointRounding)
+{
+    EXPECT_EQ(gepard::Float(1.5), gepard::Float(gepard::Fixed(1.5)));
+    EXPECT_EQ(gepard::Float(-3.25), gepard::Float(gepard::Fixed(-3.25)));
+    EXPECT_EQ(gepard::Float(1.0 / 256), gepard::Float(gepard::Fixed(1.2 / 256)));
+    EXPECT_EQ(gepard::Float(8388607.0), gepard::Float(gepard::Fixed(8388607.0))) << "The 24 bit integer part is lost.";
+    EXPECT_EQ(gepard::Float(INT32_MAX) / 256, gepard::Float(gepard::Fixed(1e10))) << "The large values are not saturated.";
+    EXPECT_EQ(gepard::Float(INT32_MIN) / 256, gepard::Float(gepard::Fixed(-1e10))) << "The large values are not saturated.";
+    EXPECT_EQ(gepard::Float(INT32_MIN) / 256, gepard::Float(gepard::Fixed(-8388608.0)));
+}
+
+TEST(TrapezoidTessellator, PolygonWithinTolerance)
+{
+    gepard::PathData pathData;
+    pathData.addMoveToElement(gepard::FloatPoint(10.3, 20.7));
+    pathData.addLineToElement(gepard::FloatPoint(390.1, 60.2));
+    pathData.addLineToElement(gepard::FloatPoint(250.6, 380.9));
+    pathData.addLineToElement(gepard::FloatPoint(60.45, 300.15));
+    pathData.addCloseSubpathElement();
+
+    expectCoverageWithinTolerance(pathData, gepard::TrapezoidFillRule::NonZero, 400);
+}
+
+TEST(TrapezoidTessellator, SelfIntersectingWithinTolerance)
+{
+    gepard::PathData pathData;
+    // A five-pointed star, the center is filled only by the nonzero rule.
+    for (int i = 0; i < 5; ++i) {
+        const gepard::Float angle = i * 4.0 * gepard::piFloat / 5.0;
+        const gepard::FloatPoint point(200.0 + 180.0 * std::sin(angle), 200.0 - 180.0 * std::cos(angle));
+        if (i)
+            pathData.addLineToElement(point);
+        else
+            pathData.addMoveToElement(point);
+    }
+    pathData.addCloseSubpathElement();
+
+    expectCoverageWithinTolerance(pathData, gepard::TrapezoidFillRule::NonZero, 400);
+    expectCoverageWithinTolerance(pathData, gepard::TrapezoidFillRule::EvenOdd, 400);
+}
+
+TEST(TrapezoidTessellator, CurvesWithinTolerance)
+{
+    gepard::PathData pathData;
+    pathData.addMoveToElement(gepard::FloatPoint(20.0, 200.0));
+    pathData.addBezierCurveToElement(gepard::FloatPoint(20.0, -50.0), gepard::FloatPoint(380.0, 450.0), gepard::FloatPoint(380.0, 200.0));
+    pathData.addQuadaraticCurveToElement(gepard::FloatPoint(200.0, 420.0), gepard::FloatPoint(20.0, 200.0));
+    pathData.addMoveToElement(gepard::FloatPoint(300.0, 100.0));
+    pathData.addArcElement(gepard::FloatPoint(250.0, 100.0), gepard::FloatPoint(50.0, 50.0), 0.0, 2.0 * gepard::piFloat);
+    pathData.addCloseSubpathElement();
+
+    expectCoverageWithinTolerance(pathData, gepard::TrapezoidFillRule::NonZero, 400);
+}
+
+TEST(TrapezoidTessellator, SpansWithinTolerance)
+{
+    gepard::PathData polygon;
+    polygon.addMoveToElement(gepard::FloatPoint(10.3, 20.7));
+    polygon.addLineToElement(gepard::FloatPoint(390.1, 60.2));
+    polygon.addLineToElement(gepard::FloatPoint(250.6, 380.9));
+    polygon.addLineToElement(gepard::FloatPoint(60.45, 300.15));
+    polygon.addCloseSubpathElement();
+    expectSpansWithinTolerance(polygon, gepard::TrapezoidFillRule::NonZero, 400);
+
+    gepard::PathData star;
+    for (int i = 0; i < 5; ++i) {
+        const gepard::Float angle = i * 4.0 * gepard::piFloat / 5.0;
+        const gepard::FloatPoint point(200.0 + 180.0 * std::sin(angle), 200.0 - 180.0 * std::cos(angle));
+        if (i)
+            star.addLineToElement(point);
+        else
+            star.addMoveToElement(point);
+    }
+    star.addCloseSubpathElement();
+    expectSpansWithinTolerance(star, gepard::TrapezoidFillRule::NonZero, 400);
+    expectSpansWithinTolerance(star, gepard::TrapezoidFillRule::EvenOdd, 400);
+
+    gepard::PathData curves;
+    curves.addMoveToElement(gepard::FloatPoint(20.0, 200.0));
+    curves.addBezierCurveToElement(gepard::FloatPoint(20.0, -50.0), gepard::FloatPoint(380.0, 450.0), gepard::FloatPoint(380.0, 200.0));
+    curves.addQuadaraticCurveToElement(gepard::FloatPoint(200.0, 420.0), gepard::FloatPoint(20.0, 200.0));
+    curves.addMoveToElement(gepard::FloatPoint(300.0, 100.0));
+    curves.addArcElement(gepard::FloatPoint(250.0, 100.0), gepard::FloatPoint(50.0, 50.0), 0.0, 2.0 * gepard::piFloat);
+    curves.addCloseSubpathElement();
+    expectSpansWithinTolerance(curves, gepard::TrapezoidFillRule::NonZero, 400);
+}
+
+TEST(TrapezoidTessellator, ClippedSpans)
+{
+    const int kClipBottomY = 100 * GD_ANTIALIAS_LEVEL;
+
+    // Only the sub-scanlines of the clip are walked, even if the path is huge.
+    gepard::PathData tallRect;
+    tallRect.addMoveToElement(gepard::FloatPoint(10.0, -1e7));
+    tallRect.addLineToElement(gepard::FloatPoint(20.0, -1e7));
+    tallRect.addLineToElement(gepard::FloatPoint(20.0, 1e7));
+    tallRect.addLineToElement(gepard::FloatPoint(10.0, 1e7));
+    tallRect.addCloseSubpathElement();
+
+    gepard::TrapezoidTessellator rectTessellator(tallRect, gepard::TrapezoidFillRule::NonZero);
+    const gepard::SpanList rectSpans = rectTessellator.spanList(0, kClipBottomY);
+    ASSERT_EQ(size_t(kClipBottomY), rectSpans.size());
+    for (int y = 0; y < kClipBottomY; ++y) {
+        EXPECT_EQ(y, rectSpans[y].y);
+        EXPECT_EQ(10.0, rectSpans[y].left);
+        EXPECT_EQ(20.0, rectSpans[y].right);
+    }
+
+    // The clipped spans are the visible part of the whole ones.
+    gepard::PathData triangles;
+    triangles.addMoveToElement(gepard::FloatPoint(30.0, -50.5));
+    triangles.addLineToElement(gepard::FloatPoint(90.25, 150.0));
+    triangles.addLineToElement(gepard::FloatPoint(30.0, 150.0));
+    triangles.addCloseSubpathElement();
+    triangles.addMoveToElement(gepard::FloatPoint(0.0, -30.0));
+    triangles.addLineToElement(gepard::FloatPoint(50.0, -10.0));
+    triangles.addLineToElement(gepard::FloatPoint(0.0, -5.0));
+    triangles.addCloseSubpathElement();
+
+    gepard::TrapezoidTessellator tessellator(triangles, gepard::TrapezoidFillRule::NonZero);
+    gepard::SpanList expected;
+    for (const gepard::Span& span : tessellator.spanList()) {
+        if (span.y >= 0 && span.y < kClipBottomY)
+            expected.push_back(span);
+    }
+    const gepard::SpanList spans = tessellator.spanList(0, kClipBottomY);
+
+    ASSERT_EQ(expected.size(), spans.size());
+    for (size_t i = 0; i < spans.size(); ++i) {
+        EXPECT_EQ(expected[i].y, spans[i].y);
+        EXPECT_NEAR(expected[i].left, spans[i].left, 1e-6);
+        EXPECT_NEAR(expected[i].right, spans[i].right, 1e-6);
+    }
+}
+
+TEST(TrapezoidTessellator, LargeCoordinatesWithinTolerance)
+{
+    gepard::PathData pathData;
+    pathData.addMoveToElement(gepard::FloatPoint(4000.5, 4000.25));
+    pathData.addLineToElement(gepard::FloatPoint(8190.0, 4010.75));
+    pathData.addLineToElement(gepard::FloatPoint(6000.125, 4090.5));
+    pathData.addCloseSubpathElement();
+
+    expectCoverageWithinTolerance(pathData, gepard::TrapezoidFillRule::NonZero, 4100);
+}
+
+TEST(TrapezoidTessellator, SegmentsSplitAtSubScanlines)
+{
+    gepard::SegmentApproximator approximator;
+    approximator.insertLine(gepard::FloatPoint(10.0, 10.0), gepard::FloatPoint(30.0, 20.0));
+    approximator.insertLine(gepard::FloatPoint(30.0, 20.0), gepard::FloatPoint(10.0, 30.0));
+    approximator.insertLine(gepard::FloatPoint(10.0, 30.0), gepard::FloatPoint(25.0, 12.0));
+    approximator.insertLine(gepard::FloatPoint(25.0, 12.0), gepard::FloatPoint(10.0, 10.0));
+
+    const gepard::SegmentList& segments = approximator.segments();
+    ASSERT_FALSE(segments.empty());
+
+    std::vector<gepard::Float> lines;
+    for (const gepard::Segment& segment : segments) {
+        lines.push_back(segment.from.y);
+        lines.push_back(segment.to.y);
+    }
+
+    for (size_t i = 0; i < segments.size(); ++i) {
+        const gepard::Segment& segment = segments[i];
+        EXPECT_LT(segment.from.y, segment.to.y);
+        for (const gepard::Float y : lines) {
+            EXPECT_FALSE(segment.isOnSegment(y)) << "The segment " << segment << " is not split at " << y << ".";
+        }
+        if (i) {
+            const gepard::Segment& previous = segments[i - 1];
+            EXPECT_TRUE(previous.from < segment.from || (previous.from == segment.from && previous.to <= segment.to))
+                << "The segments " << previous << " and " << segment << " are not sorted.";
+        }
+    }
+}
+
+TEST(TrapezoidTessellator, ReusedEdgeTable)
+{
+    gepard::PathData triangle;
+    triangle.addMoveToElement(gepard::FloatPoint(10.0, 10.0));
+    triangle.addLineToElement(gepard::FloatPoint(90.0, 30.0));
+    triangle.addLineToElement(gepard::FloatPoint(40.0, 80.0));
+    triangle.addCloseSubpathElement();
+
+    gepard::PathData curve;
+    curve.addMoveToElement(gepard::FloatPoint(20.0, 50.0));
+    curve.addBezierCurveToElement(gepard::FloatPoint(20.0, -10.0), gepard::FloatPoint(80.0, 110.0), gepard::FloatPoint(80.0, 50.0));
+    curve.addCloseSubpathElement();
+
+    const std::vector<gepard::Float> triangleCoverage = rowCoverage<gepard::Float>(triangle, gepard::TrapezoidFillRule::NonZero, 100);
+    const std::vector<gepard::Float> curveCoverage = rowCoverage<gepard::Float>(curve, gepard::TrapezoidFillRule::NonZero, 100);
+
+    // The table of a previous fill must not leak into the next one.
+    gepard::BasicEdgeTable<gepard::Float> edgeTable;
+    for (gepard::PathData* pathData : { &curve, &triangle, &curve }) {
+        gepard::BasicTrapezoidTessellator<gepard::Float> tessellator(*pathData, gepard::TrapezoidFillRule::NonZero, GD_ANTIALIAS_LEVEL, &edgeTable);
+        gepard::Float area = 0.0;
+        for (const gepard::BasicTrapezoid<gepard::Float>& trapezoid : tessellator.trapezoidList()) {
+            area += ((trapezoid.topRightX - trapezoid.topLeftX) + (trapezoid.bottomRightX - trapezoid.bottomLeftX)) / 2.0 * (trapezoid.bottomY - trapezoid.topY);
+        }
+
+        const std::vector<gepard::Float>& coverage = (pathData == &triangle) ? triangleCoverage : curveCoverage;
+        EXPECT_DOUBLE_EQ(std::accumulate(coverage.begin(), coverage.end(), 0.0), area);
+    }
+}
+
+TEST(TrapezoidTessellator, MergedTrapezoids)
+{
+    // Two squares which share an edge, and a triangle which splits the
+    // segments of the squares at its vertices.
+    gepard::PathData pathData;
+    pathData.addMoveToElement(gepard::FloatPoint(0.0, 0.0));
+    pathData.addLineToElement(gepard::FloatPoint(10.0, 0.0));
+    pathData.addLineToElement(gepard::FloatPoint(10.0, 100.0));
+    pathData.addLineToElement(gepard::FloatPoint(0.0, 100.0));
+    pathData.addCloseSubpathElement();
+    pathData.addMoveToElement(gepard::FloatPoint(10.0, 0.0));
+    pathData.addLineToElement(gepard::FloatPoint(20.0, 0.0));
+    pathData.addLineToElement(gepard::FloatPoint(20.0, 100.0));
+    pathData.addLineToElement(gepard::FloatPoint(10.0, 100.0));
+    pathData.addCloseSubpathElement();
+    pathData.addMoveToElement(gepard::FloatPoint(50.0, 10.0));
+    pathData.addLineToElement(gepard::FloatPoint(60.0, 40.0));
+    pathData.addLineToElement(gepard::FloatPoint(40.0, 70.0));
+    pathData.addCloseSubpathElement();
+
+    for (const gepard::TrapezoidFillRule::FillRule fillRule : { gepard::TrapezoidFillRule::NonZero, gepard::TrapezoidFillRule::EvenOdd }) {
+        gepard::TrapezoidTessellator tessellator(pathData, fillRule);
+        const gepard::TrapezoidList trapezoids = tessellator.trapezoidList();
+
+        int squares = 0;
+        for (const gepard::Trapezoid& trapezoid : trapezoids) {
+            if (trapezoid.topLeftX >= 30.0)
+                continue;
+
+            ++squares;
+            EXPECT_EQ(0.0, trapezoid.topY);
+            EXPECT_EQ(100.0, trapezoid.bottomY);
+            EXPECT_EQ(0.0, trapezoid.topLeftX);
+            EXPECT_EQ(0.0, trapezoid.bottomLeftX);
+            EXPECT_EQ(20.0, trapezoid.topRightX);
+            EXPECT_EQ(20.0, trapezoid.bottomRightX);
+        }
+        EXPECT_EQ(1, squares) << "The trapezoids of the squares are not merged.";
+    }
+}
+
+TEST(TrapezoidTessellator, IntersectionsOfRandomSegments)
+{
+    // Tall sub-scanlines with many crossings.
+    std::mt19937 random(1);
+    std::uniform_real_distribution<gepard::Float> x(0.0, 200.0);
+    std::uniform_real_distribution<gepard::Float> y(0.0, 1000000.0);
+    std::uniform_real_distribution<gepard::Float> deltaX(-100.0, 100.0);
+    std::uniform_real_distribution<gepard::Float> deltaY(-50.0, 50.0);
+
+    LineList lines;
+    for (int i = 0; i < 100000; ++i) {
+        const gepard::FloatPoint from(x(random), y(random));
+        lines.push_back(std::make_pair(from, from + gepard::FloatPoint(deltaX(random), deltaY(random))));
+    }
+
+    expectSegmentsAsReference(lines, 1);
+}
+
+TEST(TrapezoidTessellator, IntersectionsOfDenseSegments)
+{
+    // Short segments like the outlines of text, every sub-scanline is split.
+    std::mt19937 random(2);
+    std::uniform_real_distribution<gepard::Float> position(0.0, 1000.0);
+    std::uniform_real_distribution<gepard::Float> delta(-0.5, 0.5);
+
+    LineList lines;
+    for (int i = 0; i < 100000; ++i) {
+        const gepard::FloatPoint from(position(random), position(random));
+        lines.push_back(std::make_pair(from, from + gepard::FloatPoint(delta(random), delta(random))));
+    }
+
+    expectSegmentsAsReference(lines, GD_ANTIALIAS_LEVEL);
+}
+
+} // anonymous namespace
+
+#endif // GEPARD_TRAPEZOID_TESSELLATOR_TESTS_H
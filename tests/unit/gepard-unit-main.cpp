@@ -25,11 +25,15 @@
 
 #include "gtest/gtest.h"
 
+#include "gepard-block-allocator-tests.h"
 #include "gepard-bounding-box-tests.h"
+#include "gepard-dirty-region-tests.h"
 #include "gepard-float-point-tests.h"
 #include "gepard-float-tests.h"
 #include "gepard-path-tests.h"
 #include "gepard-region-tests.h"
+#include "gepard-software-blend-tests.h"
+#include "gepard-trapezoid-tessellator-tests.h"
 #include "gepard-vec4-tests.h"
 
 int main(int argc, char* argv[])
@@ -0,0 +1,349 @@
+/* Copyright (C) 2018, Gepard Graphics
+ * Copyright (C) 2018, Szilard Ledan <szledan@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gepard.h"
+
+#include "gepard-engine-backend.h"
+#include "gepard-memory-buffer-surface.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#ifdef GD_USE_VULKAN
+#include "gepard-vulkan.h"
+#endif // GD_USE_VULKAN
+
+namespace {
+
+static const uint32_t kWidth = 128;
+static const uint32_t kHeight = 96;
+// The length of the header of the pipeline cache data, with the 16 bytes of the UUID.
+static const uint32_t kPipelineCacheHeaderSize = 4 * sizeof(uint32_t) + 16;
+
+/*!
+ * \brief Interleave the rectangle and the path fills, so the surface render
+ * pass is restarted around the coverage passes and at the flush, and each
+ * drawing covers the previous ones.
+ */
+void drawScene(gepard::Gepard& gepard)
+{
+    gepard.setFillColor(255, 255, 255);
+    gepard.fillRect(0, 0, kWidth, kHeight);
+
+    gepard.beginPath();
+    gepard.moveTo(10, 10);
+    gepard.lineTo(100, 10);
+    gepard.lineTo(10, 80);
+    gepard.closePath();
+    gepard.setFillColor(255, 0, 0);
+    gepard.fill();
+
+    gepard.setFillColor(0, 0, 255);
+    gepard.fillRect(30, 5, 40, 30);
+
+    gepard.beginPath();
+    gepard.moveTo(70, 30);
+    gepard.arc(60, 30, 10, 0, 6);
+    gepard.closePath();
+    gepard.setFillColor(0, 255, 0);
+    gepard.fill();
+
+    gepard.flush();
+
+    gepard.setFillColor(0, 0, 0);
+    gepard.fillRect(0, 50, 20, 20);
+
+    gepard.beginPath();
+    gepard.rect(80, 60, 40, 30);
+    gepard.setFillColor(255, 255, 0);
+    gepard.fill();
+
+    gepard.setFillColor(0, 0, 0, 0.5f);
+    gepard.fillRect(90, 0, 30, 20);
+
+    gepard.finish();
+}
+
+/*!
+ * \brief Check the inner points of the drawings of drawScene().
+ */
+void expectScene(gepard::MemoryBufferSurface& surface)
+{
+    // The red, green, blue values of the inner points of the drawings.
+    const struct {
+        uint32_t x, y;
+        uint8_t rgb[3];
+    } points[] = {
+        { 5, 5, { 255, 255, 255 } },
+        { 20, 20, { 255, 0, 0 } },
+        { 40, 30, { 0, 0, 255 } },
+        { 60, 30, { 0, 255, 0 } },
+        { 10, 60, { 0, 0, 0 } },
+        { 100, 75, { 255, 255, 0 } },
+        { 105, 5, { 128, 128, 128 } },
+    };
+
+    const int kTolerance = 1;
+    const uint8_t* buffer = reinterpret_cast<const uint8_t*>(surface.getBuffer());
+    for (const auto& point : points) {
+        const uint8_t* pixel = buffer + 4 * (point.y * kWidth + point.x);
+        for (int channel = 0; channel < 3; ++channel) {
+            EXPECT_NEAR(point.rgb[channel], pixel[channel], kTolerance) << "at " << point.x << "," << point.y << ", channel " << channel;
+        }
+    }
+}
+
+/*!
+ * \brief Read the whole file, or nothing if it does not exist.
+ */
+std::vector<char> readFile(const std::string& fileName)
+{
+    std::ifstream input(fileName, std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(input)), (std::istreambuf_iterator<char>()));
+}
+
+/*!
+ * \brief Check the header of the saved pipeline cache data, see
+ * vkGetPipelineCacheData(): the header length and the
+ * VK_PIPELINE_CACHE_HEADER_VERSION_ONE version.
+ */
+void expectPipelineCacheHeader(const std::vector<char>& data)
+{
+    ASSERT_GE(data.size(), kPipelineCacheHeaderSize);
+
+    uint32_t header[2];
+    std::memcpy(header, data.data(), sizeof(header));
+    EXPECT_EQ(kPipelineCacheHeaderSize, header[0]);
+    EXPECT_EQ(1u, header[1]);
+}
+
+/*!
+ * \brief Draw the scene with a new Vulkan backend, which loads and saves
+ * the pipeline cache.
+ */
+void drawSceneWithPipelineCache()
+{
+    gepard::MemoryBufferSurface surface(kWidth, kHeight);
+    {
+        gepard::Gepard gepard(&surface, 1, gepard::Gepard::VulkanBackend);
+        drawScene(gepard);
+    }
+    expectScene(surface);
+}
+
+TEST(VulkanTest, HeadlessSmoke)
+{
+    gepard::MemoryBufferSurface surface(kWidth, kHeight);
+    if (!gepard::GepardEngineBackend::isAvailable(gepard::Gepard::VulkanBackend, &surface)) {
+        GTEST_SKIP() << "The Vulkan backend is not available.";
+    }
+
+    gepard::Gepard gepard(&surface, 1, gepard::Gepard::VulkanBackend);
+    ASSERT_EQ(gepard::Gepard::VulkanBackend, gepard.backend());
+    drawScene(gepard);
+    expectScene(surface);
+}
+
+TEST(VulkanTest, PipelineCacheRoundTrip)
+{
+    gepard::MemoryBufferSurface surface(kWidth, kHeight);
+    if (!gepard::GepardEngineBackend::isAvailable(gepard::Gepard::VulkanBackend, &surface)) {
+        GTEST_SKIP() << "The Vulkan backend is not available.";
+    }
+
+    const char* tempDir = std::getenv("TMPDIR");
+    const std::string fileName = std::string(tempDir ? tempDir : "/tmp") + "/gepard-vulkantest-pipeline-cache.bin";
+    std::remove(fileName.c_str());
+    setenv("GD_VULKAN_PIPELINE_CACHE", fileName.c_str(), 1);
+
+    // The cache is created empty and saved at the destruction.
+    drawSceneWithPipelineCache();
+    const std::vector<char> saved = readFile(fileName);
+    expectPipelineCacheHeader(saved);
+
+    // The saved data is loaded and saved again with the same header.
+    drawSceneWithPipelineCache();
+    const std::vector<char> reloaded = readFile(fileName);
+    expectPipelineCacheHeader(reloaded);
+    ASSERT_GE(reloaded.size(), saved.size());
+    EXPECT_TRUE(std::equal(saved.begin(), saved.begin() + kPipelineCacheHeaderSize, reloaded.begin()));
+
+    // The data of an other device is ignored and overwritten.
+    std::vector<char> foreign = saved;
+    foreign[16] = ~foreign[16];
+    std::ofstream(fileName, std::ios::binary | std::ios::trunc).write(foreign.data(), foreign.size());
+    drawSceneWithPipelineCache();
+    const std::vector<char> replaced = readFile(fileName);
+    expectPipelineCacheHeader(replaced);
+    EXPECT_TRUE(std::equal(saved.begin(), saved.begin() + kPipelineCacheHeaderSize, replaced.begin()));
+
+    unsetenv("GD_VULKAN_PIPELINE_CACHE");
+    std::remove(fileName.c_str());
+}
+
+/*!
+ * \brief Records the frames which the surface has received.
+ */
+class FrameRecordingSurface : public gepard::MemoryBufferSurface {
+public:
+    FrameRecordingSurface(uint32_t width, uint32_t height) : MemoryBufferSurface(width, height) {}
+
+    virtual void frameReady(const uint64_t frame) { frames.push_back(frame); }
+
+    std::vector<uint64_t> frames;
+};
+
+TEST(VulkanTest, EveryFlushIsReported)
+{
+    FrameRecordingSurface surface(kWidth, kHeight);
+    if (!gepard::GepardEngineBackend::isAvailable(gepard::Gepard::VulkanBackend, &surface)) {
+        GTEST_SKIP() << "The Vulkan backend is not available.";
+    }
+
+    gepard::Gepard gepard(&surface, 1, gepard::Gepard::VulkanBackend);
+
+    // The empty flushes are reported after the earlier readbacks.
+    gepard.flush();
+    gepard.fillRect(0, 0, 10, 10);
+    gepard.flush();
+    gepard.flush();
+    gepard.fillRect(10, 10, 10, 10);
+    gepard.flush();
+    gepard.flush();
+    gepard.finish();
+
+    // The finish() flushes as well.
+    const std::vector<uint64_t> expected = { 1, 2, 3, 4, 5, 6 };
+    EXPECT_EQ(expected, surface.frames);
+}
+
+TEST(VulkanTest, VertexRingOverflow)
+{
+    FrameRecordingSurface surface(kWidth, kHeight);
+    if (!gepard::GepardEngineBackend::isAvailable(gepard::Gepard::VulkanBackend, &surface)) {
+        GTEST_SKIP() << "The Vulkan backend is not available.";
+    }
+
+    gepard::Gepard gepard(&surface, 1, gepard::Gepard::VulkanBackend);
+
+    // A 1x1 rect for each pixel uploads 128 bytes per rect, 1.5 MiB in one
+    // frame, so every 512 KiB segment of the vertex ring is filled and the
+    // frame is submitted in parts, even into the segment of a frame in flight.
+    // The path fills between the rows upload their trapezoids into the ring too.
+    for (uint32_t y = 0; y < kHeight; ++y) {
+        for (uint32_t x = 0; x < kWidth; ++x) {
+            gepard.setFillColor(2 * x, 2 * y, 128);
+            gepard.fillRect(x, y, 1, 1);
+        }
+
+        if (!(y % 16)) {
+            gepard.beginPath();
+            gepard.rect(0, 0, kWidth, y + 1);
+            gepard.setFillColor(0, 0, 0, 0.0f);
+            gepard.fill();
+        }
+    }
+    gepard.finish();
+
+    // The parts of the frame are not reported as frames.
+    const std::vector<uint64_t> expected = { 1 };
+    EXPECT_EQ(expected, surface.frames);
+
+    const int kTolerance = 1;
+    const uint8_t* buffer = reinterpret_cast<const uint8_t*>(surface.getBuffer());
+    int mismatches = 0;
+    for (uint32_t y = 0; y < kHeight; ++y) {
+        for (uint32_t x = 0; x < kWidth; ++x) {
+            const uint8_t* pixel = buffer + 4 * (y * kWidth + x);
+            const int rgb[3] = { int(2 * x), int(2 * y), 128 };
+            for (int channel = 0; channel < 3; ++channel) {
+                if (std::abs(rgb[channel] - pixel[channel]) > kTolerance && !mismatches++) {
+                    ADD_FAILURE() << "at " << x << "," << y << ", channel " << channel << ": " << int(pixel[channel]) << " instead of " << rgb[channel];
+                }
+            }
+        }
+    }
+    EXPECT_EQ(0, mismatches);
+}
+
+#ifdef GD_USE_VULKAN
+TEST(VulkanTest, DeviceMemoryIsReused)
+{
+    gepard::MemoryBufferSurface surface(kWidth, kHeight);
+    if (!gepard::GepardEngineBackend::isAvailable(gepard::Gepard::VulkanBackend, &surface)) {
+        GTEST_SKIP() << "The Vulkan backend is not available.";
+    }
+
+    gepard::GepardContext context(&surface);
+    gepard::vulkan::GepardVulkan vulkan(context);
+
+    const gepard::Color color(0.0, 0.5, 1.0, 1.0);
+    auto drawFrame = [&] {
+        vulkan.fillRect(context.frameCount % kWidth, 0, 10, 10, color);
+        context.frameCount++;
+        vulkan.flush();
+    };
+
+    drawFrame();
+    vulkan.finish();
+    const gepard::BlockAllocator::Statistics first = vulkan.memoryStatistics();
+
+    // Only the blocks of the default size are allocated for these buffers
+    // and images, and the ranges are never freed.
+    EXPECT_LE(1u, first.blockCount);
+    EXPECT_EQ(first.blockCount * gepard::vulkan::GepardVulkan::kMemoryBlockSize, first.reservedBytes);
+    EXPECT_LT(first.usedBytes, first.reservedBytes);
+    EXPECT_LE(1u, first.allocationCount);
+
+    // The buffers are persistent: more frames than kFramesInFlight neither
+    // allocate nor free device memory.
+    for (int i = 0; i < 16; ++i) {
+        drawFrame();
+    }
+    vulkan.finish();
+    const gepard::BlockAllocator::Statistics last = vulkan.memoryStatistics();
+
+    EXPECT_EQ(first.blockCount, last.blockCount);
+    EXPECT_EQ(first.reservedBytes, last.reservedBytes);
+    EXPECT_EQ(first.usedBytes, last.usedBytes);
+    EXPECT_EQ(first.fragmentedBytes, last.fragmentedBytes);
+    EXPECT_EQ(first.allocationCount, last.allocationCount);
+}
+#endif // GD_USE_VULKAN
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
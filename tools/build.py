@@ -46,12 +46,18 @@ def create_options(arguments=None):
     if hasattr(arguments, 'backend'):
         opts.append('-DBACKEND=' + arguments.backend.upper())
 
+    if hasattr(arguments, 'geometry'):
+        opts.append('-DGEOMETRY=' + arguments.geometry.upper())
+
     if hasattr(arguments, 'log_level'):
         opts.append('-DLOG_LEVEL=' + str(arguments.log_level))
 
     if hasattr(arguments, 'no_colored_logs') and arguments.no_colored_logs:
         opts.append('-DDISABLE_LOG_COLORS=ON')
 
+    if hasattr(arguments, 'vulkan_validation') and arguments.vulkan_validation:
+        opts.append('-DENABLE_VULKAN_VALIDATION=ON')
+
     if hasattr(arguments, 'install_prefix') and arguments.install_prefix:
         opts.append('-DCMAKE_INSTALL_PREFIX=' + arguments.install_prefix)
 
@@ -64,9 +70,11 @@ def add_args(parser):
     parser.add_argument('--install-prefix', action='store', dest='install_prefix', help='Specify install prefix.')
     parser.add_argument('--debug', '-d', action='store_const', const='debug', default='release', dest='build_type', help='Build debug.')
     parser.add_argument('--rebuild-deps', action='store_true', default=False, help='Rebuild thirdparty dependencies.')
-    parser.add_argument('--backend', action='store', choices=['gles2', 'software', 'vulkan'], default='gles2', help='Specify which graphics back-end to use.')
+    parser.add_argument('--backend', action='store', choices=['auto', 'gles2', 'software', 'vulkan'], default='auto', help='Specify which graphics back-end to prefer. Every available back-end is built.')
+    parser.add_argument('--geometry', action='store', choices=['double', 'float', 'fixed'], default='double', help='Specify the number type of the tessellator geometry.')
     parser.add_argument('--log-level', '-l', action='store', type=int, choices=range(0,5), default=0, help='Set logging level.')
     parser.add_argument('--no-colored-logs', action='store_true', default=False, help='Disable colored log messages.')
+    parser.add_argument('--vulkan-validation', action='store_true', default=False, help='Enable the Vulkan validation layer.')
     parser.add_argument('targets', action='store', nargs='*', default=['gepard'], help='List of targets to build')
 
 
@@ -108,7 +116,8 @@ def main():
     arguments = get_args()
 
     try:
-        dependencies.build_dependencies([arguments.backend], arguments.rebuild_deps)
+        backends = ['all'] if arguments.backend == 'auto' else [arguments.backend]
+        dependencies.build_dependencies(backends, arguments.rebuild_deps)
         build_path = util.get_build_path(arguments)
         configure(util.get_base_path(), build_path, arguments)
         build_targets(build_path, arguments.targets)
@@ -48,7 +48,7 @@ done
 
 common_list="cmake libx11-dev libpng-dev"
 gles2_list="libegl1-mesa-dev libgles2-mesa-dev"
-vulkan_list=""
+vulkan_list="glslang-tools"
 
 dev_list="cppcheck doxygen graphviz"
 
@@ -40,7 +40,7 @@ def run_unittest(throw=True):
     args.build_dir = "build/unittest"
     args.build_type = "debug"
     args.backend = "software"
-    args.targets = ["unittest"]
+    args.targets = ["unittest", "threadtest"]
     build_path = util.get_build_path(args)
 
     print('')
@@ -51,7 +51,8 @@ def run_unittest(throw=True):
 
     print('')
     print("Running unit-tests...")
-    return util.call([path.join(build_path, 'bin', 'unittest')], throw)
+    result = util.call([path.join(build_path, 'bin', 'unittest')], throw)
+    return util.call([path.join(build_path, 'bin', 'threadtest')], throw) or result
 
 
 def main():